@@ -0,0 +1,570 @@
+#include "../include/network/tcp_service.h"
+#include "../include/network/tcp_session.h"
+#include "../include/network/asio_wrapper.h"
+#include "../include/utils/logger.h"
+#include "../include/utils/metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace next_gen;
+
+// Echo message: opaque body, echoed back unchanged
+class EchoMessage : public Message {
+public:
+    static constexpr MessageCategoryType CATEGORY = 0xFE;
+    static constexpr MessageIdType ID = 1;
+
+    EchoMessage() : Message(CATEGORY, ID) {}
+
+    std::string getName() const override { return "EchoMessage"; }
+
+    Result<std::vector<u8>> serialize() const override { return Result<std::vector<u8>>(body_); }
+
+    Result<void> deserialize(const std::vector<u8>& data) override {
+        body_ = data;
+        return Result<void>();
+    }
+
+    std::unique_ptr<Message> clone() const override { return std::make_unique<EchoMessage>(*this); }
+
+private:
+    std::vector<u8> body_;
+};
+
+// Echo service. Replies on the IO thread, or with dispatch enabled, from the
+// service worker after a round trip through the message queue.
+class EchoService : public TcpService {
+public:
+    EchoService(const TcpServiceConfig& config, bool dispatch)
+        : TcpService("echo", config) {
+        setSessionHandler(std::make_unique<EchoHandler>(this, dispatch));
+        registerMessageHandler<EchoMessage>([this](const EchoMessage& message) {
+            auto session = getSession(message.getSessionId());
+            if (session) {
+                session->send(message);
+            }
+        });
+    }
+
+private:
+    class EchoHandler : public SessionHandler {
+    public:
+        EchoHandler(EchoService* service, bool dispatch) : service_(service), dispatch_(dispatch) {}
+
+        void onMessageReceived(std::shared_ptr<Session> session, std::unique_ptr<Message> message) override {
+            if (dispatch_) {
+                message->setSessionId(session->getId());
+                service_->postMessage(std::move(message));
+            } else {
+                session->send(*message);
+            }
+        }
+
+    private:
+        EchoService* service_;
+        bool dispatch_;
+    };
+};
+
+// Frame header size (category + id + body size)
+static constexpr size_t HEADER_SIZE = sizeof(MessageCategoryType) + sizeof(MessageIdType) + sizeof(u32);
+
+// Minimum body: intended send time and sequence number
+static constexpr size_t MIN_BODY_SIZE = 2 * sizeof(u64);
+
+// Body size with relative weight
+struct MixEntry {
+    size_t size;
+    u32 weight;
+};
+
+// Command line options
+struct BenchOptions {
+    std::string host = "127.0.0.1";
+    u16 port = 19000;
+    bool run_server = true;
+    bool run_client = true;
+    bool dispatch = false;
+    u32 server_threads = 2;
+    u32 client_threads = 2;
+    u32 connections = 100;
+    u32 connect_concurrency = 64;       // Outstanding connects per client thread
+    f64 rate = 10000.0;                 // Messages per second, all connections
+    f64 duration = 10.0;                // Measured seconds
+    f64 warmup = 1.0;                   // Seconds excluded from the statistics
+    std::vector<MixEntry> mix = {{64, 1}};
+    bool json = false;
+};
+
+// Shared client statistics
+struct ClientStats {
+    std::atomic<u64> connected{0};
+    std::atomic<u64> connect_errors{0};
+    std::atomic<u64> io_errors{0};
+    std::atomic<u64> sent{0};
+    std::atomic<u64> received{0};
+    std::atomic<u64> bytes_sent{0};
+    std::atomic<u64> bytes_received{0};
+    std::atomic<u64> last_connect_ns{0};
+    Histogram latency;                  // Intended send time to reply, measured messages only
+};
+
+// Client thread with its own IO context; its connections are only touched by this thread
+class ClientWorker {
+public:
+    ClientWorker(const BenchOptions& options, ClientStats& stats, u32 connections, u32 seed)
+        : options_(options), stats_(stats), connections_to_open_(connections), rng_(seed),
+          measure_start_ns_(0), stop_send_ns_(0) {
+        for (const auto& entry : options_.mix) {
+            weights_.push_back(entry.weight);
+        }
+    }
+
+    // Open connections, returns when all attempts completed
+    void connect(const asio::ip::tcp::endpoint& endpoint) {
+        endpoint_ = endpoint;
+        for (u32 i = 0; i < options_.connect_concurrency && next_connection_ < connections_to_open_; ++i) {
+            connectNext();
+        }
+        io_.run();
+        io_.restart();
+    }
+
+    // Send from start_ns (open loop) until stop_ns, then wait for replies until drain_ns
+    void run(u64 start_ns, u64 measure_start_ns, u64 stop_ns, u64 drain_ns) {
+        measure_start_ns_ = measure_start_ns;
+        stop_send_ns_ = stop_ns;
+
+        // Per-connection rate with a random phase, so connections do not send in lockstep
+        f64 per_connection_rate = options_.rate / options_.connections;
+        u64 interval_ns = static_cast<u64>(1e9 / per_connection_rate);
+        std::uniform_int_distribution<u64> phase(0, interval_ns);
+        for (auto& connection : connections_) {
+            connection->interval_ns = interval_ns;
+            connection->next_send_ns = start_ns + phase(rng_);
+            schedule(*connection);
+            readHeader(*connection);
+        }
+
+        asio::steady_timer drain_timer(io_);
+        drain_timer.expires_at(toTimePoint(drain_ns));
+        drain_timer.async_wait([this](const AsioErrorCode&) { io_.stop(); });
+        io_.run();
+    }
+
+    // Messages sent but not answered
+    u64 outstanding() const { return outstanding_; }
+
+private:
+    struct Connection {
+        explicit Connection(asio::io_context& io) : socket(io), timer(io) {}
+
+        asio::ip::tcp::socket socket;
+        asio::steady_timer timer;
+        u64 interval_ns = 0;
+        u64 next_send_ns = 0;
+        u64 sequence = 0;
+        std::array<u8, HEADER_SIZE> header;
+        std::vector<u8> body;
+        std::deque<std::vector<u8>> write_queue;
+        bool writing = false;
+        bool open = true;
+    };
+
+    static std::chrono::steady_clock::time_point toTimePoint(u64 ns) {
+        return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns));
+    }
+
+    void connectNext() {
+        // Owned by the handler until connected
+        Connection* raw = new Connection(io_);
+        ++next_connection_;
+        raw->socket.async_connect(endpoint_, [this, raw](const AsioErrorCode& error) {
+            std::unique_ptr<Connection> connection(raw);
+            if (error) {
+                stats_.connect_errors.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                connection->socket.set_option(asio::ip::tcp::no_delay(true));
+                connections_.push_back(std::move(connection));
+                stats_.connected.fetch_add(1, std::memory_order_relaxed);
+                stats_.last_connect_ns.store(metricsNowNanos(), std::memory_order_relaxed);
+            }
+            if (next_connection_ < connections_to_open_) {
+                connectNext();
+            }
+        });
+    }
+
+    // Send every message whose intended time has passed, then wait for the next one
+    void schedule(Connection& connection) {
+        connection.timer.expires_at(toTimePoint(connection.next_send_ns));
+        connection.timer.async_wait([this, &connection](const AsioErrorCode& error) {
+            if (error || !connection.open) {
+                return;
+            }
+            u64 now_ns = metricsNowNanos();
+            while (connection.next_send_ns <= now_ns && connection.next_send_ns < stop_send_ns_) {
+                send(connection, connection.next_send_ns);
+                connection.next_send_ns += connection.interval_ns;
+            }
+            if (connection.next_send_ns < stop_send_ns_) {
+                schedule(connection);
+            }
+        });
+    }
+
+    void send(Connection& connection, u64 intended_ns) {
+        std::discrete_distribution<size_t> pick(weights_.begin(), weights_.end());
+        size_t body_size = std::max(options_.mix[pick(rng_)].size, MIN_BODY_SIZE);
+
+        std::vector<u8> frame(HEADER_SIZE + body_size, 0x5A);
+        MessageCategoryType category = EchoMessage::CATEGORY;
+        MessageIdType id = EchoMessage::ID;
+        u32 size_field = static_cast<u32>(body_size);
+        std::memcpy(frame.data(), &category, sizeof(category));
+        std::memcpy(frame.data() + sizeof(category), &id, sizeof(id));
+        std::memcpy(frame.data() + sizeof(category) + sizeof(id), &size_field, sizeof(size_field));
+        std::memcpy(frame.data() + HEADER_SIZE, &intended_ns, sizeof(intended_ns));
+        std::memcpy(frame.data() + HEADER_SIZE + sizeof(u64), &connection.sequence, sizeof(u64));
+        ++connection.sequence;
+
+        ++outstanding_;
+        stats_.sent.fetch_add(1, std::memory_order_relaxed);
+        stats_.bytes_sent.fetch_add(frame.size(), std::memory_order_relaxed);
+        connection.write_queue.push_back(std::move(frame));
+        if (!connection.writing) {
+            write(connection);
+        }
+    }
+
+    void write(Connection& connection) {
+        connection.writing = true;
+        asio::async_write(connection.socket, asio::buffer(connection.write_queue.front()),
+            [this, &connection](const AsioErrorCode& error, std::size_t) {
+                if (error) {
+                    fail(connection);
+                    return;
+                }
+                connection.write_queue.pop_front();
+                if (connection.write_queue.empty()) {
+                    connection.writing = false;
+                } else {
+                    write(connection);
+                }
+            });
+    }
+
+    void readHeader(Connection& connection) {
+        asio::async_read(connection.socket, asio::buffer(connection.header),
+            [this, &connection](const AsioErrorCode& error, std::size_t) {
+                if (error) {
+                    fail(connection);
+                    return;
+                }
+                u32 size_field;
+                std::memcpy(&size_field, connection.header.data() + sizeof(MessageCategoryType) + sizeof(MessageIdType),
+                            sizeof(size_field));
+                connection.body.resize(size_field & FRAME_BODY_SIZE_MASK);
+                readBody(connection);
+            });
+    }
+
+    void readBody(Connection& connection) {
+        asio::async_read(connection.socket, asio::buffer(connection.body),
+            [this, &connection](const AsioErrorCode& error, std::size_t) {
+                if (error) {
+                    fail(connection);
+                    return;
+                }
+                u64 now_ns = metricsNowNanos();
+                if (connection.body.size() >= MIN_BODY_SIZE) {
+                    u64 intended_ns;
+                    std::memcpy(&intended_ns, connection.body.data(), sizeof(intended_ns));
+                    if (intended_ns >= measure_start_ns_) {
+                        stats_.latency.record(now_ns - intended_ns);
+                        stats_.received.fetch_add(1, std::memory_order_relaxed);
+                        stats_.bytes_received.fetch_add(HEADER_SIZE + connection.body.size(),
+                                                        std::memory_order_relaxed);
+                    }
+                    --outstanding_;
+                }
+                readHeader(connection);
+            });
+    }
+
+    void fail(Connection& connection) {
+        if (connection.open) {
+            connection.open = false;
+            stats_.io_errors.fetch_add(1, std::memory_order_relaxed);
+            AsioErrorCode ignored;
+            connection.timer.cancel(ignored);
+            connection.socket.close(ignored);
+        }
+    }
+
+    const BenchOptions& options_;
+    ClientStats& stats_;
+    asio::io_context io_;
+    asio::ip::tcp::endpoint endpoint_;
+    u32 connections_to_open_;
+    u32 next_connection_ = 0;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::vector<u32> weights_;
+    std::mt19937_64 rng_;
+    u64 measure_start_ns_;
+    u64 stop_send_ns_;
+    u64 outstanding_ = 0;
+};
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "Open-loop TCP echo benchmark. Starts an echo TcpService and a load generator in one" << std::endl;
+    std::cout << "process unless --server or --connect is given. Latency is measured from each message's" << std::endl;
+    std::cout << "scheduled send time, so a stalled server is not hidden by a stalled client." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -c, --connections N    Connections (default 100)" << std::endl;
+    std::cout << "  -r, --rate N           Messages per second over all connections (default 10000)" << std::endl;
+    std::cout << "  -d, --duration S       Measured seconds (default 10)" << std::endl;
+    std::cout << "  -w, --warmup S         Warm-up seconds excluded from results (default 1)" << std::endl;
+    std::cout << "  -m, --mix LIST         Body sizes with weights, SIZE[:WEIGHT],... (default 64)" << std::endl;
+    std::cout << "  -t, --threads N        Client IO threads (default 2)" << std::endl;
+    std::cout << "  -i, --io-threads N     Server IO threads (default 2)" << std::endl;
+    std::cout << "  -p, --port N           Port (default 19000)" << std::endl;
+    std::cout << "      --dispatch         Echo from the service worker instead of the IO thread" << std::endl;
+    std::cout << "      --server           Run the echo server only" << std::endl;
+    std::cout << "      --connect HOST     Run the load generator only, against HOST" << std::endl;
+    std::cout << "  -j, --json             Output JSON" << std::endl;
+    std::cout << "  -h, --help             Display this help message" << std::endl;
+}
+
+bool parseMix(const std::string& value, std::vector<MixEntry>& mix) {
+    mix.clear();
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        MixEntry entry;
+        char* end = nullptr;
+        entry.size = std::strtoull(item.c_str(), &end, 10);
+        entry.weight = *end == ':' ? static_cast<u32>(std::strtoul(end + 1, nullptr, 10)) : 1;
+        if (entry.size == 0 || entry.size > FRAME_BODY_SIZE_MASK || entry.weight == 0) {
+            return false;
+        }
+        mix.push_back(entry);
+    }
+    return !mix.empty();
+}
+
+// Raise the open file limit for thousands of sockets (best effort)
+void raiseFileLimit() {
+#if !defined(_WIN32)
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+int runClient(const BenchOptions& options, EchoService* server) {
+    asio::ip::tcp::endpoint endpoint;
+    try {
+        endpoint = asio::ip::tcp::endpoint(asio::ip::address::from_string(options.host), options.port);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid host " << options.host << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    ClientStats stats;
+    std::vector<std::unique_ptr<ClientWorker>> workers;
+    for (u32 i = 0; i < options.client_threads; ++i) {
+        u32 share = options.connections / options.client_threads + (i < options.connections % options.client_threads);
+        workers.push_back(std::make_unique<ClientWorker>(options, stats, share, 12345 + i));
+    }
+
+    // Connect phase
+    u64 connect_start_ns = metricsNowNanos();
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, &endpoint] { worker->connect(endpoint); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    u64 connected = stats.connected.load();
+    f64 connect_seconds = connected > 0 ? (stats.last_connect_ns.load() - connect_start_ns) / 1e9 : 0.0;
+    if (connected == 0) {
+        std::cerr << "Error: No connection to " << options.host << ":" << options.port << " could be opened" << std::endl;
+        return 1;
+    }
+
+    // Load phase
+    u64 start_ns = metricsNowNanos() + 10 * 1000000;
+    u64 measure_start_ns = start_ns + static_cast<u64>(options.warmup * 1e9);
+    u64 stop_ns = measure_start_ns + static_cast<u64>(options.duration * 1e9);
+    u64 drain_ns = stop_ns + 1000 * 1000000;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, start_ns, measure_start_ns, stop_ns, drain_ns] {
+            worker->run(start_ns, measure_start_ns, stop_ns, drain_ns);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Stop the in-process server while the client connections are still open
+    if (server) {
+        server->stop();
+    }
+
+    u64 outstanding = 0;
+    for (const auto& worker : workers) {
+        outstanding += worker->outstanding();
+    }
+
+    u64 received = stats.received.load();
+    f64 msgs_per_second = received / options.duration;
+    f64 bytes_per_second = (stats.bytes_received.load() * 2) / options.duration;
+    const Histogram& latency = stats.latency;
+
+    if (options.json) {
+        std::cout << "{\"connections\":" << connected << ",\"connect_errors\":" << stats.connect_errors.load()
+                  << ",\"connect_seconds\":" << connect_seconds
+                  << ",\"connections_per_second\":" << (connect_seconds > 0.0 ? connected / connect_seconds : 0.0)
+                  << ",\"target_rate\":" << options.rate << ",\"duration\":" << options.duration
+                  << ",\"sent\":" << stats.sent.load() << ",\"received\":" << received
+                  << ",\"unanswered\":" << outstanding << ",\"io_errors\":" << stats.io_errors.load()
+                  << ",\"msgs_per_second\":" << msgs_per_second << ",\"bytes_per_second\":" << bytes_per_second
+                  << ",\"p50_ns\":" << latency.percentile(0.5) << ",\"p90_ns\":" << latency.percentile(0.9)
+                  << ",\"p99_ns\":" << latency.percentile(0.99) << ",\"p999_ns\":" << latency.percentile(0.999)
+                  << ",\"max_ns\":" << latency.max() << "}" << std::endl;
+        return 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Connections: " << connected << " in " << connect_seconds << " s ("
+              << (connect_seconds > 0.0 ? connected / connect_seconds : 0.0) << "/s, "
+              << stats.connect_errors.load() << " errors)" << std::endl;
+    std::cout << "Messages:    " << stats.sent.load() << " sent, " << received << " measured, " << outstanding
+              << " unanswered, " << stats.io_errors.load() << " IO errors" << std::endl;
+    std::cout << "Throughput:  " << msgs_per_second << " msg/s (target " << options.rate << "), "
+              << bytes_per_second / (1024 * 1024) << " MiB/s" << std::endl;
+    std::cout << "Latency:     p50 " << latency.percentile(0.5) / 1e3 << " us, p90 " << latency.percentile(0.9) / 1e3
+              << " us, p99 " << latency.percentile(0.99) / 1e3 << " us, p999 " << latency.percentile(0.999) / 1e3
+              << " us, max " << latency.max() / 1e3 << " us" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-c" || arg == "--connections") {
+            ok = has_value && (options.connections = std::strtoul(argv[++i], nullptr, 10)) > 0;
+        } else if (arg == "-r" || arg == "--rate") {
+            ok = has_value && (options.rate = std::strtod(argv[++i], nullptr)) > 0.0;
+        } else if (arg == "-d" || arg == "--duration") {
+            ok = has_value && (options.duration = std::strtod(argv[++i], nullptr)) > 0.0;
+        } else if (arg == "-w" || arg == "--warmup") {
+            ok = has_value && (options.warmup = std::strtod(argv[++i], nullptr)) >= 0.0;
+        } else if (arg == "-m" || arg == "--mix") {
+            ok = has_value && parseMix(argv[++i], options.mix);
+        } else if (arg == "-t" || arg == "--threads") {
+            ok = has_value && (options.client_threads = std::strtoul(argv[++i], nullptr, 10)) > 0;
+        } else if (arg == "-i" || arg == "--io-threads") {
+            ok = has_value && (options.server_threads = std::strtoul(argv[++i], nullptr, 10)) > 0;
+        } else if (arg == "-p" || arg == "--port") {
+            ok = has_value && (options.port = static_cast<u16>(std::strtoul(argv[++i], nullptr, 10))) > 0;
+        } else if (arg == "--dispatch") {
+            options.dispatch = true;
+        } else if (arg == "--server") {
+            options.run_client = false;
+        } else if (arg == "--connect") {
+            ok = has_value;
+            if (ok) {
+                options.host = argv[++i];
+                options.run_server = false;
+            }
+        } else if (arg == "-j" || arg == "--json") {
+            options.json = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: Missing or invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.run_server && !options.run_client) {
+        std::cerr << "Error: --server and --connect are exclusive" << std::endl;
+        return 1;
+    }
+    options.client_threads = std::min(options.client_threads, options.connections);
+
+    Logger::instance().setLevel(LogLevel::ERROR);
+    raiseFileLimit();
+
+    std::unique_ptr<EchoService> server;
+    if (options.run_server) {
+        DefaultMessageFactory::instance().registerMessageType<EchoMessage>();
+
+        TcpServiceConfig config;
+        config.bind_address = options.run_client ? "127.0.0.1" : "0.0.0.0";
+        config.port = options.port;
+        config.max_connections = options.run_client ? options.connections : 1000000;
+        config.idle_timeout_ms = 0;
+        config.io_thread_count = options.server_threads;
+        config.accept_backlog = 4096;
+        config.socket_send_buffer_size = 256 * 1024;
+        config.socket_recv_buffer_size = 256 * 1024;
+
+        server = std::make_unique<EchoService>(config, options.dispatch);
+        auto result = server->init();
+        if (!result.has_error()) {
+            result = server->start();
+        }
+        if (result.has_error()) {
+            std::cerr << "Error: " << result.error().what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.run_client) {
+        std::cout << "Echo server listening on port " << options.port << ", press Enter to stop" << std::endl;
+        std::cin.get();
+        server->stop();
+        return 0;
+    }
+
+    int exit_code = runClient(options, server.get());
+    if (server && server->isRunning()) {
+        server->stop();
+    }
+    return exit_code;
+}
@@ -0,0 +1,363 @@
+#include "../include/message/message_queue.h"
+#include "../include/utils/logger.h"
+#include "../include/utils/metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace next_gen;
+
+// Message carrying a payload and the producer's send timestamp
+class BenchMessage : public Message {
+public:
+    BenchMessage(size_t payload_size) : Message(1, 1), send_ns(0), payload(payload_size) {}
+
+    u64 send_ns;
+    std::vector<u8> payload;
+};
+
+// One benchmark configuration
+struct BenchCase {
+    std::string queue;
+    size_t producers;
+    size_t consumers;
+    size_t batch;
+    size_t payload;
+    size_t capacity;
+};
+
+// Result of one run
+struct RunResult {
+    f64 seconds;
+    f64 throughput;
+    u64 p50_ns;
+    u64 p99_ns;
+    u64 p999_ns;
+    u64 max_ns;
+};
+
+// Command line options
+struct BenchOptions {
+    std::vector<std::string> queues = {"default", "priority", "lockfree", "mpmc"};
+    std::vector<size_t> producers = {1, 4};
+    std::vector<size_t> consumers = {1, 4};
+    std::vector<size_t> batches = {1, 32};
+    std::vector<size_t> payloads = {16, 1024};
+    std::vector<size_t> capacities = {1024};
+    size_t messages = 200000;
+    size_t runs = 5;
+    bool pin = true;
+    bool json = false;
+};
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "Message queue throughput and enqueue-to-dequeue latency benchmark." << std::endl;
+    std::cout << "List options take comma separated values; every combination is run." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -q, --queues LIST      Queue types (default default,priority,lockfree,mpmc)" << std::endl;
+    std::cout << "  -p, --producers LIST   Producer thread counts (default 1,4)" << std::endl;
+    std::cout << "  -c, --consumers LIST   Consumer thread counts (default 1,4)" << std::endl;
+    std::cout << "  -b, --batch LIST       Messages pushed / popped per burst (default 1,32)" << std::endl;
+    std::cout << "  -s, --payload LIST     Payload sizes in bytes (default 16,1024)" << std::endl;
+    std::cout << "  -k, --capacity LIST    Queue capacities (default 1024)" << std::endl;
+    std::cout << "  -n, --messages N       Messages per run (default 200000)" << std::endl;
+    std::cout << "  -r, --runs N           Measured runs per case, after one warm-up run (default 5)" << std::endl;
+    std::cout << "      --no-pin           Do not pin threads to CPUs" << std::endl;
+    std::cout << "  -j, --json             Output JSON" << std::endl;
+    std::cout << "  -h, --help             Display this help message" << std::endl;
+}
+
+bool parseList(const std::string& value, std::vector<size_t>& list) {
+    list.clear();
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t n = std::strtoull(item.c_str(), nullptr, 10);
+        if (n == 0) {
+            return false;
+        }
+        list.push_back(n);
+    }
+    return !list.empty();
+}
+
+bool parseList(const std::string& value, std::vector<std::string>& list) {
+    list.clear();
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            return false;
+        }
+        list.push_back(item);
+    }
+    return !list.empty();
+}
+
+// Pin calling thread to a CPU (best effort)
+void pinThread(size_t cpu) {
+    size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    cpu %= cpu_count;
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// Value at quantile of sorted samples
+u64 quantile(const std::vector<u64>& sorted, f64 q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+RunResult runOnce(const BenchCase& bench, size_t messages, bool pin) {
+    auto queue = createMessageQueue(bench.queue, bench.capacity);
+
+    // Every producer sends the same share, rounded up to whole bursts
+    size_t per_producer = (messages / bench.producers + bench.batch - 1) / bench.batch * bench.batch;
+    size_t total = per_producer * bench.producers;
+
+    std::atomic<size_t> consumed(0);
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::vector<u64>> latencies(bench.consumers);
+
+    auto producer = [&](size_t index) {
+        if (pin) {
+            pinThread(index);
+        }
+        std::vector<std::unique_ptr<BenchMessage>> burst(bench.batch);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        for (size_t sent = 0; sent < per_producer; sent += bench.batch) {
+            for (auto& message : burst) {
+                message = std::make_unique<BenchMessage>(bench.payload);
+            }
+            for (auto& message : burst) {
+                message->send_ns = metricsNowNanos();
+                queue->push(std::move(message));
+            }
+        }
+    };
+
+    auto consumer = [&](size_t index) {
+        if (pin) {
+            pinThread(bench.producers + index);
+        }
+        std::vector<u64>& samples = latencies[index];
+        samples.reserve(total / bench.consumers + bench.batch);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        while (consumed.load(std::memory_order_relaxed) < total) {
+            // Block for the first message of a burst, then drain without waiting
+            auto message = queue->waitAndPop(std::chrono::milliseconds(1));
+            for (size_t n = 0; message; ) {
+                u64 now_ns = metricsNowNanos();
+                samples.push_back(now_ns - static_cast<const BenchMessage&>(*message).send_ns);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+                if (++n == bench.batch) {
+                    break;
+                }
+                message = queue->tryPop();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < bench.consumers; ++i) {
+        threads.emplace_back(consumer, i);
+    }
+    for (size_t i = 0; i < bench.producers; ++i) {
+        threads.emplace_back(producer, i);
+    }
+    while (ready.load() < threads.size()) {
+        std::this_thread::yield();
+    }
+
+    u64 start_ns = metricsNowNanos();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    u64 elapsed_ns = metricsNowNanos() - start_ns;
+
+    std::vector<u64> all;
+    all.reserve(total);
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    RunResult result;
+    result.seconds = elapsed_ns / 1e9;
+    result.throughput = result.seconds > 0.0 ? total / result.seconds : 0.0;
+    result.p50_ns = quantile(all, 0.5);
+    result.p99_ns = quantile(all, 0.99);
+    result.p999_ns = quantile(all, 0.999);
+    result.max_ns = all.empty() ? 0 : all.back();
+    return result;
+}
+
+// Median of a field over runs
+template<typename T, typename F>
+T median(std::vector<RunResult> runs, F field) {
+    std::sort(runs.begin(), runs.end(), [&](const RunResult& a, const RunResult& b) {
+        return field(a) < field(b);
+    });
+    return field(runs[runs.size() / 2]);
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-q" || arg == "--queues") {
+            ok = has_value && parseList(argv[++i], options.queues);
+        } else if (arg == "-p" || arg == "--producers") {
+            ok = has_value && parseList(argv[++i], options.producers);
+        } else if (arg == "-c" || arg == "--consumers") {
+            ok = has_value && parseList(argv[++i], options.consumers);
+        } else if (arg == "-b" || arg == "--batch") {
+            ok = has_value && parseList(argv[++i], options.batches);
+        } else if (arg == "-s" || arg == "--payload") {
+            ok = has_value && parseList(argv[++i], options.payloads);
+        } else if (arg == "-k" || arg == "--capacity") {
+            ok = has_value && parseList(argv[++i], options.capacities);
+        } else if (arg == "-n" || arg == "--messages") {
+            ok = has_value && (options.messages = std::strtoull(argv[++i], nullptr, 10)) > 0;
+        } else if (arg == "-r" || arg == "--runs") {
+            ok = has_value && (options.runs = std::strtoull(argv[++i], nullptr, 10)) > 0;
+        } else if (arg == "--no-pin") {
+            options.pin = false;
+        } else if (arg == "-j" || arg == "--json") {
+            options.json = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: Missing or invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Full-queue warnings would distort the measurement
+    Logger::instance().setLevel(LogLevel::ERROR);
+
+    std::vector<BenchCase> cases;
+    for (const auto& queue : options.queues)
+        for (size_t producers : options.producers)
+            for (size_t consumers : options.consumers)
+                for (size_t batch : options.batches)
+                    for (size_t payload : options.payloads)
+                        for (size_t capacity : options.capacities)
+                            cases.push_back({queue, producers, consumers, batch, payload, capacity});
+
+    if (options.json) {
+        std::cout << "{\"hardware_concurrency\":" << std::thread::hardware_concurrency()
+                  << ",\"messages\":" << options.messages << ",\"runs\":" << options.runs
+                  << ",\"pinned\":" << (options.pin ? "true" : "false") << ",\"results\":[";
+    } else {
+        std::cout << std::left << std::setw(10) << "queue" << std::right
+                  << std::setw(4) << "P" << std::setw(4) << "C" << std::setw(6) << "batch"
+                  << std::setw(8) << "payload" << std::setw(9) << "capacity"
+                  << std::setw(14) << "msg/s" << std::setw(11) << "p50 us" << std::setw(11) << "p99 us"
+                  << std::setw(11) << "p999 us" << std::endl;
+    }
+
+    bool first = true;
+    for (const auto& bench : cases) {
+        // LockFreeMessageQueue::push is single-producer only
+        bool skipped = bench.queue == "lockfree" && bench.producers > 1;
+
+        std::vector<RunResult> runs;
+        if (!skipped) {
+            runOnce(bench, options.messages, options.pin);
+            for (size_t run = 0; run < options.runs; ++run) {
+                runs.push_back(runOnce(bench, options.messages, options.pin));
+            }
+        }
+
+        if (options.json) {
+            std::cout << (first ? "" : ",") << "\n{\"queue\":\"" << bench.queue << "\",\"producers\":"
+                      << bench.producers << ",\"consumers\":" << bench.consumers << ",\"batch\":" << bench.batch
+                      << ",\"payload\":" << bench.payload << ",\"capacity\":" << bench.capacity;
+            if (skipped) {
+                std::cout << ",\"skipped\":\"single producer queue\"}";
+            } else {
+                std::cout << ",\"throughput\":[";
+                for (size_t run = 0; run < runs.size(); ++run) {
+                    std::cout << (run ? "," : "") << static_cast<u64>(runs[run].throughput);
+                }
+                std::cout << "],\"throughput_median\":"
+                          << static_cast<u64>(median<f64>(runs, [](const RunResult& r) { return r.throughput; }))
+                          << ",\"p50_ns\":" << median<u64>(runs, [](const RunResult& r) { return r.p50_ns; })
+                          << ",\"p99_ns\":" << median<u64>(runs, [](const RunResult& r) { return r.p99_ns; })
+                          << ",\"p999_ns\":" << median<u64>(runs, [](const RunResult& r) { return r.p999_ns; })
+                          << ",\"max_ns\":" << median<u64>(runs, [](const RunResult& r) { return r.max_ns; })
+                          << "}";
+            }
+            first = false;
+            continue;
+        }
+
+        std::cout << std::left << std::setw(10) << bench.queue << std::right
+                  << std::setw(4) << bench.producers << std::setw(4) << bench.consumers
+                  << std::setw(6) << bench.batch << std::setw(8) << bench.payload
+                  << std::setw(9) << bench.capacity;
+        if (skipped) {
+            std::cout << "  skipped (single producer queue)" << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(0)
+                  << std::setw(14) << median<f64>(runs, [](const RunResult& r) { return r.throughput; })
+                  << std::setprecision(1)
+                  << std::setw(11) << median<u64>(runs, [](const RunResult& r) { return r.p50_ns; }) / 1e3
+                  << std::setw(11) << median<u64>(runs, [](const RunResult& r) { return r.p99_ns; }) / 1e3
+                  << std::setw(11) << median<u64>(runs, [](const RunResult& r) { return r.p999_ns; }) / 1e3
+                  << std::endl;
+    }
+
+    if (options.json) {
+        std::cout << "\n]}" << std::endl;
+    }
+    return 0;
+}
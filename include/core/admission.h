@@ -0,0 +1,111 @@
+#ifndef NEXT_GEN_ADMISSION_H
+#define NEXT_GEN_ADMISSION_H
+
+#include <string>
+#include <atomic>
+#include "config.h"
+#include "../message/message.h"
+#include "../utils/metrics.h"
+
+namespace next_gen {
+
+// Why a message was shed
+enum class ShedReason : u8 {
+    NONE,           // Admitted
+    QUEUE_FULL,     // Queue at max_queue_depth or at its own capacity
+    LOW_PRIORITY,   // Queue above shed_watermark and category below the cut-off
+    QUEUE_DELAY,    // Queue delay above target_delay_ms for a whole interval
+    COUNT
+};
+
+// Get reason name (metric label)
+NEXT_GEN_API const char* shedReasonName(ShedReason reason);
+
+// Admission control of a service queue
+//
+// Lower categories have lower priority (as in PriorityMessageQueue).
+// Categories below sheddable_categories may be shed before the queue is
+// full: above shed_watermark the cut-off rises with the depth, so the lowest
+// category goes first and all sheddable categories go just before the queue
+// is full. Responses, timeouts and tasks of the message bus are never shed
+// and never block: if the queue is full they wait in an overflow list the
+// worker moves back into the queue as it frees slots.
+struct AdmissionConfig {
+    bool enabled = false;                   // Disabled: postMessage blocks on a full queue
+    size_t max_queue_depth = 0;             // 0 = limited by the queue capacity only
+    size_t shed_watermark = 0;              // 0 = 3/4 of max_queue_depth
+    MessageCategoryType sheddable_categories = 0;   // Categories [0, n) may be shed early
+    u32 target_delay_ms = 0;                // CoDel queue delay target, 0 = disabled
+    u32 interval_ms = 100;                  // CoDel interval
+};
+
+// Messages shed per reason
+struct AdmissionStats {
+    u64 shed[static_cast<size_t>(ShedReason::COUNT)] = {};
+    bool overloaded = false;                // Queue delay above target
+};
+
+// Admission controller
+//
+// admit() runs on the producers and only reads the configuration and the
+// overload flag. shouldDrop() runs on the service thread and implements
+// CoDel: once the queue delay stays above target for an interval, sheddable
+// messages are dropped at dequeue at a rate growing with the square root of
+// the drop count, and rejected at admission until the delay is below target
+// or the queue drains.
+class NEXT_GEN_API AdmissionController {
+public:
+    AdmissionController(const std::string& service_name, const AdmissionConfig& config);
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    const AdmissionConfig& getConfig() const { return config_; }
+
+    // Check if a message is exempt from shedding
+    static bool isControl(const Message& message);
+
+    // Decide whether a message may be queued at the given depth (any thread)
+    ShedReason admit(const Message& message, size_t depth) const;
+
+    // Check the queue delay of a dequeued message, true if it should be
+    // dropped (service thread)
+    bool shouldDrop(const Message& message, u64 now_ns);
+
+    // Leave the dropping state, the queue is empty (service thread)
+    void onQueueDrained();
+
+    // Count a shed message
+    void recordShed(ShedReason reason) {
+        shed_[static_cast<size_t>(reason)]->inc();
+    }
+
+    // Check if the queue delay is above target
+    bool isOverloaded() const { return overloaded_.load(std::memory_order_relaxed); }
+
+    AdmissionStats getStats() const;
+
+private:
+    bool isSheddable(const Message& message) const {
+        return message.getCategory() < config_.sheddable_categories && !isControl(message);
+    }
+
+    // Time to the next drop: interval / sqrt(count)
+    u64 controlLaw(u64 count) const;
+
+    AdmissionConfig config_;
+    size_t shed_watermark_;
+    u64 target_ns_;
+    u64 interval_ns_;
+    Counter* shed_[static_cast<size_t>(ShedReason::COUNT)];
+
+    // CoDel state (service thread)
+    std::atomic<bool> overloaded_;
+    u64 first_above_ns_;        // When the delay may start dropping, 0 if below target
+    u64 drop_next_ns_;
+    u64 drop_count_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_ADMISSION_H
@@ -0,0 +1,222 @@
+#ifndef NEXT_GEN_COROUTINE_H
+#define NEXT_GEN_COROUTINE_H
+
+// Coroutine message handlers, enabled with the NEXT_GEN_ENABLE_COROUTINES
+// build option (C++20).
+//
+// A handler registered with registerCoroutineHandler() returns Task and may
+// co_await a cross-service request, a delay or any Completion. Every resume
+// happens on the owning service's thread, so handler code needs no locking;
+// while a handler is suspended the service keeps processing other messages.
+// The request being handled (MessageBus::currentRequest) is restored on every
+// resume, so MessageBus::reply() without a context still answers it after a
+// co_await. Handlers suspended when the service stops are not resumed.
+
+#ifdef NEXT_GEN_ENABLE_COROUTINES
+
+#if !defined(__cpp_impl_coroutine) && !defined(__cpp_coroutines)
+#error "NEXT_GEN_ENABLE_COROUTINES requires a C++20 compiler with coroutine support"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <mutex>
+#include "service.h"
+#include "message_bus.h"
+#include "../utils/timer.h"
+#include "../utils/logger.h"
+
+namespace next_gen {
+
+// Coroutine handler task
+//
+// Starts immediately, runs until its first suspension inside the dispatch
+// call and frees its frame when it finishes. Exceptions are logged.
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() noexcept { return Task(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            try {
+                throw;
+            } catch (const std::exception& e) {
+                NEXT_GEN_LOG_ERROR("Exception in coroutine handler: " + std::string(e.what()));
+            } catch (...) {
+                NEXT_GEN_LOG_ERROR("Unknown exception in coroutine handler");
+            }
+        }
+    };
+};
+
+// Resume a coroutine with the request it was handling when it suspended
+inline void resumeWithRequest(std::coroutine_handle<> handle, const RequestContext& request) {
+    RequestScope scope(request);
+    handle.resume();
+}
+
+// Awaitable request over the message bus, resumes with the response or error
+class RequestAwaiter {
+public:
+    RequestAwaiter(BaseService& service, ServiceHandle target,
+                   std::shared_ptr<const Message> message, u32 timeout_ms)
+        : service_(service), target_(std::move(target)), message_(std::move(message)), timeout_ms_(timeout_ms) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        // Request callbacks run on the service thread
+        RequestContext request = MessageBus::currentRequest();
+        auto result = service_.request(target_, std::move(message_), timeout_ms_,
+            [this, handle, request](Result<std::shared_ptr<const Message>> response) {
+                result_.emplace(std::move(response));
+                resumeWithRequest(handle, request);
+            });
+        if (result.has_error()) {
+            result_.emplace(result.error().code(), result.error().message());
+            return false;
+        }
+        return true;
+    }
+
+    Result<std::shared_ptr<const Message>> await_resume() { return std::move(*result_); }
+
+private:
+    BaseService& service_;
+    ServiceHandle target_;
+    std::shared_ptr<const Message> message_;
+    u32 timeout_ms_;
+    std::optional<Result<std::shared_ptr<const Message>>> result_;
+};
+
+// Send a request and await the response (timeout_ms 0 = no timeout)
+inline RequestAwaiter co_request(BaseService& service, const ServiceHandle& target,
+                                 std::shared_ptr<const Message> message, u32 timeout_ms) {
+    return RequestAwaiter(service, target, std::move(message), timeout_ms);
+}
+
+// Awaitable delay on TimerManager, resumes on the service thread
+class DelayAwaiter {
+public:
+    DelayAwaiter(BaseService& service, u64 delay_ms) : executor_(service.getExecutor()), delay_ms_(delay_ms) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        RequestContext request = MessageBus::currentRequest();
+        auto resume = [handle, request]() { resumeWithRequest(handle, request); };
+        if (delay_ms_ == 0) {
+            // Yield: resume after the messages already queued
+            executor_(resume);
+            return;
+        }
+        // Without the timer thread (stopped by the application) the delay
+        // would never end, degrade to a yield
+        if (!TimerManager::instance().isRunning()) {
+            NEXT_GEN_LOG_WARNING_LIMITED("Timer manager not running, co_sleep yields instead", 1);
+            executor_(resume);
+            return;
+        }
+        BaseService::Executor executor = executor_;
+        TimerManager::instance().createOnce(delay_ms_, [executor, resume]() { executor(resume); });
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    BaseService::Executor executor_;
+    u64 delay_ms_;
+};
+
+// Suspend for delay_ms (0 yields to the queued messages)
+inline DelayAwaiter co_sleep(BaseService& service, u64 delay_ms) {
+    return DelayAwaiter(service, delay_ms);
+}
+
+// One-shot completion for callback-based APIs
+//
+// Copies share one state. Hand a copy to the callback, which completes it on
+// any thread; the coroutine awaiting it resumes on the service thread.
+// Example:
+//   Completion<Result<void>> done(service);
+//   startAsync([done](Result<void> result) { done.complete(std::move(result)); });
+//   auto result = co_await done;
+template<typename T>
+class Completion {
+public:
+    explicit Completion(BaseService& service) : state_(std::make_shared<State>()) {
+        state_->executor = service.getExecutor();
+    }
+
+    // Complete with a value, later completions are ignored
+    void complete(T value) const {
+        std::coroutine_handle<> waiter;
+        RequestContext request;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->value) {
+                return;
+            }
+            state_->value.emplace(std::move(value));
+            waiter = state_->waiter;
+            request = state_->request;
+        }
+        if (waiter) {
+            state_->executor([waiter, request]() { resumeWithRequest(waiter, request); });
+        }
+    }
+
+    bool await_ready() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->value.has_value();
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->value) {
+            return false;
+        }
+        state_->waiter = handle;
+        state_->request = MessageBus::currentRequest();
+        return true;
+    }
+
+    T await_resume() const { return std::move(*state_->value); }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::optional<T> value;
+        std::coroutine_handle<> waiter;
+        RequestContext request;         // Request handled when the waiter suspended
+        BaseService::Executor executor;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+// Coroutine message handler: Task(std::shared_ptr<const T>)
+//
+// The handler shares ownership of the message (no copy), so it stays valid
+// across suspensions.
+template<typename T, typename Handler>
+Result<void> registerCoroutineHandler(BaseService& service, Handler handler) {
+    static_assert(std::is_base_of<Message, T>::value, "T must be derived from Message");
+    BaseService* owner = &service;
+    return service.registerMessageHandler(T::CATEGORY, T::ID,
+        createMessageHandler<T>([owner, handler](const T&) {
+            auto message = std::static_pointer_cast<const T>(owner->retainCurrentMessage());
+            if (message) {
+                handler(std::move(message));
+            }
+        }));
+}
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_ENABLE_COROUTINES
+
+#endif // NEXT_GEN_COROUTINE_H
@@ -0,0 +1,198 @@
+#ifndef NEXT_GEN_MESSAGE_BUS_H
+#define NEXT_GEN_MESSAGE_BUS_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include "config.h"
+#include "../message/message.h"
+#include "../utils/error.h"
+
+namespace next_gen {
+
+class Service;
+
+// Message bus service ID (dense, never reused)
+using ServiceId = u32;
+constexpr ServiceId INVALID_SERVICE_ID = 0;
+
+// Envelope kind
+enum class EnvelopeKind : u8 {
+    SEND,           // One-way message
+    REQUEST,        // Expects a response through MessageBus::reply()
+    RESPONSE,       // Response to a request of the receiving service
+    TIMEOUT,        // Request deadline, posted by the request timer
+    TASK            // Function to run on the receiving service's thread
+};
+
+// Message envelope
+//
+// Carries an immutable, reference-counted payload through a service queue.
+// Sending to several services allocates one envelope per target and shares
+// the payload. The receiving service dispatches the payload, so handlers
+// registered for the payload type see it unchanged.
+class NEXT_GEN_API MessageEnvelope : public Message {
+public:
+    MessageEnvelope(EnvelopeKind kind, std::shared_ptr<const Message> payload,
+                    ServiceId source = INVALID_SERVICE_ID, u64 correlation_id = 0)
+        : Message(payload ? payload->getCategory() : 0, payload ? payload->getId() : 0),
+          kind_(kind),
+          payload_(std::move(payload)),
+          source_(source),
+          correlation_id_(correlation_id) {
+        envelope_ = true;
+        if (payload_) {
+            session_id_ = payload_->getSessionId();
+        }
+    }
+
+    // Task envelope (see BaseService::execute)
+    explicit MessageEnvelope(std::function<void()> task)
+        : Message(0, 0),
+          kind_(EnvelopeKind::TASK),
+          source_(INVALID_SERVICE_ID),
+          correlation_id_(0),
+          task_(std::move(task)) {
+        envelope_ = true;
+    }
+
+    // Get envelope kind
+    EnvelopeKind getKind() const { return kind_; }
+
+    // Get payload (nullptr for TIMEOUT and TASK)
+    const std::shared_ptr<const Message>& getPayload() const { return payload_; }
+
+    // Get sending service (INVALID_SERVICE_ID if not sent by a registered service)
+    ServiceId getSource() const { return source_; }
+
+    // Get request ID the envelope belongs to (0 for SEND)
+    u64 getCorrelationId() const { return correlation_id_; }
+
+    // Get task (TASK only)
+    const std::function<void()>& getTask() const { return task_; }
+
+    std::string getName() const override {
+        return payload_ ? payload_->getName() : "MessageEnvelope";
+    }
+
+    std::unique_ptr<Message> clone() const override {
+        return std::make_unique<MessageEnvelope>(*this);
+    }
+
+private:
+    EnvelopeKind kind_;
+    std::shared_ptr<const Message> payload_;
+    ServiceId source_;
+    u64 correlation_id_;
+    std::function<void()> task_;
+};
+
+// Request being handled, kept to reply later or from another thread
+struct RequestContext {
+    ServiceId source = INVALID_SERVICE_ID;
+    u64 correlation_id = 0;
+
+    bool valid() const { return source != INVALID_SERVICE_ID && correlation_id != 0; }
+};
+
+// Resolved service
+//
+// Resolve once (MessageBus::resolve) and keep the handle: posting through it
+// needs no registry lookup. The handle does not keep the service alive.
+class NEXT_GEN_API ServiceHandle {
+public:
+    ServiceHandle() : id_(INVALID_SERVICE_ID) {}
+
+    // Get service ID
+    ServiceId getId() const { return id_; }
+
+    // Check if the service is still alive
+    bool valid() const { return !service_.expired(); }
+
+    // Post a message owned by the caller
+    Result<void> post(std::unique_ptr<Message> message) const;
+
+    // Send a shared message (only the envelope is allocated)
+    Result<void> send(std::shared_ptr<const Message> message) const;
+
+private:
+    friend class MessageBus;
+
+    ServiceHandle(ServiceId id, std::weak_ptr<Service> service)
+        : id_(id), service_(std::move(service)) {}
+
+    ServiceId id_;
+    std::weak_ptr<Service> service_;
+};
+
+// In-process message bus
+//
+// Registry of the services of the process, addressed by name or ServiceId.
+// Request/response is implemented by BaseService::request(); responses and
+// timeouts are delivered on the requesting service's own thread.
+class NEXT_GEN_API MessageBus {
+public:
+    static MessageBus& instance();
+
+    // Register service under its name
+    Result<ServiceHandle> registerService(std::shared_ptr<Service> service);
+
+    // Unregister service, handles already resolved stay valid while the service lives
+    Result<void> unregisterService(const std::string& name);
+
+    // Resolve service, returns an invalid handle if not registered
+    ServiceHandle resolve(const std::string& name) const;
+    ServiceHandle resolve(ServiceId id) const;
+
+    // Send a shared message by name or ID (one registry lookup per call)
+    Result<void> send(const std::string& name, std::shared_ptr<const Message> message) const;
+    Result<void> send(ServiceId id, std::shared_ptr<const Message> message) const;
+
+    // Send one shared message to several services, returns the number delivered
+    size_t publish(const std::vector<ServiceHandle>& targets, std::shared_ptr<const Message> message) const;
+
+    // Reply to a request (the current one if called from its handler)
+    Result<void> reply(std::shared_ptr<const Message> response) const;
+    Result<void> reply(const RequestContext& request, std::shared_ptr<const Message> response) const;
+
+    // Get the request being handled on this thread (invalid outside request handlers)
+    static RequestContext currentRequest();
+
+    // Get names of the registered services
+    std::vector<std::string> getServiceNames() const;
+
+private:
+    MessageBus() {}
+
+    MessageBus(const MessageBus&) = delete;
+    MessageBus& operator=(const MessageBus&) = delete;
+
+    struct Entry {
+        std::string name;
+        std::weak_ptr<Service> service;
+    };
+
+    std::vector<Entry> services_;                       // Indexed by ServiceId - 1
+    std::unordered_map<std::string, ServiceId> names_;
+    mutable std::mutex mutex_;
+};
+
+// Marks the request handled on the current thread (used by BaseService)
+class NEXT_GEN_API RequestScope {
+public:
+    explicit RequestScope(const RequestContext& request);
+    ~RequestScope();
+
+    RequestScope(const RequestScope&) = delete;
+    RequestScope& operator=(const RequestScope&) = delete;
+
+private:
+    RequestContext previous_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_MESSAGE_BUS_H
@@ -10,12 +10,22 @@
 #include <vector>
 #include <future>
 #include <chrono>
+#include <mutex>
+#include <set>
+#include <deque>
 #include "config.h"
 #include "../message/message.h"
 #include "../message/message_queue.h"
 #include "../utils/logger.h"
 #include "../utils/error.h"
+#include "../utils/metrics.h"
+#include "../utils/tracer.h"
+#include "../utils/timer_wheel.h"
+#include "../utils/timer.h"
+#include "../utils/thread_placement.h"
 #include "../module/module_interface.h"
+#include "message_bus.h"
+#include "admission.h"
 
 namespace next_gen {
 
@@ -51,6 +61,12 @@ public:
     // Register module
     virtual Result<void> registerModule(std::shared_ptr<ModuleInterface> module) = 0;
     
+    // Register module with its static type (moduleTypeId<T>()), services
+    // without typed lookup register it like registerModule()
+    virtual Result<void> registerTypedModule(std::shared_ptr<ModuleInterface> module, u32 /*type*/) {
+        return registerModule(std::move(module));
+    }
+    
     // Get module by name
     virtual std::shared_ptr<ModuleInterface> getModule(const std::string& name) = 0;
     
@@ -61,13 +77,97 @@ public:
     virtual bool isRunning() const = 0;
 };
 
+// Duration of one module lifecycle phase
+struct ModulePhaseTiming {
+    std::string module;
+    std::string phase;          // "init", "start" or "stop"
+    u32 level;                  // Dependency level, modules of one level run in parallel
+    u64 duration_ns;
+    bool succeeded;
+};
+
+class ModuleEventSlot;
+
+// Update schedule and cost of one module
+struct ModuleTickStats {
+    std::string module;
+    u32 interval_ms;
+    u32 phase_ms;               // Offset of the updates within the interval
+    u64 ticks;
+    u64 p99_ns;
+    u64 max_ns;
+};
+
+// Immutable view of the registered modules, replaced as a whole on change
+struct ModuleSnapshot {
+    std::vector<std::shared_ptr<ModuleInterface>> modules;      // Registration order
+    std::unordered_map<std::string, std::shared_ptr<ModuleInterface>> by_name;
+    std::vector<std::shared_ptr<ModuleInterface>> by_type;      // Indexed by moduleTypeId<T>()
+};
+
+// Threads reading a module snapshot, sharded per thread like Counter.
+// Replaced snapshots are freed once no read is in progress.
+class NEXT_GEN_API ModuleReaders {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    // Read section, the snapshot must be loaded inside it (seq_cst)
+    class Scope {
+    public:
+        explicit Scope(ModuleReaders& readers)
+            : readers_(readers), shard_(shardIndex()) {
+            readers_.shards_[shard_].count.fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~Scope() {
+            readers_.shards_[shard_].count.fetch_sub(1, std::memory_order_release);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ModuleReaders& readers_;
+        size_t shard_;
+    };
+
+    // Check if no read is in progress (call after replacing the snapshot)
+    bool idle() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<u32> count{0};
+    };
+
+    // Shard of the calling thread
+    static size_t shardIndex();
+
+    Shard shards_[SHARD_COUNT];
+};
+
 // Base service implementation
 class NEXT_GEN_API BaseService : public Service {
 public:
     BaseService(const std::string& name, std::shared_ptr<MessageQueue> queue = nullptr)
         : name_(name), 
           running_(false), 
-          message_queue_(queue ? queue : std::make_shared<DefaultMessageQueue>()) {}
+          placement_node_(0),
+          message_queue_(queue ? queue : std::make_shared<DefaultMessageQueue>()),
+          control_overflow_(std::make_shared<ControlOverflow>()),
+          modules_(nullptr),
+          modules_initialized_(false),
+          modules_started_(false),
+          module_parallelism_(0),
+          modules_version_(0),
+          module_ticks_enabled_(false),
+          tick_version_(0),
+          bus_id_(INVALID_SERVICE_ID),
+          next_request_id_(1),
+          current_message_(nullptr) {
+        message_queue_->enableMetrics(name_);
+        publishModules(std::unique_ptr<ModuleSnapshot>(new ModuleSnapshot()));
+        handler_time_ = &MetricsRegistry::instance().histogram(
+            "next_gen_service_handler_seconds", "Message processing time per service",
+            {{"service", name_}});
+    }
     
     virtual ~BaseService() {
         if (running_) {
@@ -92,6 +192,14 @@ public:
             return result;
         }
         
+        // Initialize modules in dependency order
+        result = initAllModules();
+        if (result.has_error()) {
+            NEXT_GEN_LOG_ERROR("Failed to initialize modules of service: " + name_ + ", error: " + 
+                              result.error().what());
+            return result;
+        }
+        
         NEXT_GEN_LOG_INFO("Service initialized: " + name_);
         return Result<void>();
     }
@@ -108,6 +216,12 @@ public:
         // Set running flag
         running_ = true;
         
+        // Node of the worker and of the threads feeding it (IO threads)
+        placement_node_ = ThreadPlacement::instance().assignServiceNode(name_);
+        
+        // Request timeouts and coroutine delays fire on the timer thread
+        TimerManager::instance().start();
+        
         // Start worker thread
         worker_thread_ = std::thread(&BaseService::run, this);
         
@@ -123,6 +237,19 @@ public:
             return result;
         }
         
+        // Start modules in dependency order (started modules are stopped again on failure)
+        result = startAllModules();
+        if (result.has_error()) {
+            NEXT_GEN_LOG_ERROR("Failed to start modules of service: " + name_ + ", error: " + 
+                              result.error().what());
+            onStop();
+            running_ = false;
+            if (worker_thread_.joinable()) {
+                worker_thread_.join();
+            }
+            return result;
+        }
+        
         NEXT_GEN_LOG_INFO("Service started: " + name_);
         return Result<void>();
     }
@@ -136,6 +263,9 @@ public:
             return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
         }
         
+        // Stop modules in reverse dependency order while the worker still runs
+        stopAllModules();
+        
         // Set running flag
         running_ = false;
         
@@ -174,9 +304,20 @@ public:
             return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
         }
         
-        // Set message timestamp
+        // Set message timestamp (wall clock) and enqueue stamp (monotonic)
         message->setTimestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
+        message->setEnqueueTime(metricsNowNanos());
+        
+        // Messages posted while handling a traced message join its trace
+        if (message->getTraceId() == 0) {
+            message->setTraceId(Tracer::currentTraceId());
+        }
+        
+        // Admission control rejects instead of blocking the caller
+        if (admission_) {
+            return admitMessage(std::move(message));
+        }
         
         // Post message to queue
         message_queue_->push(std::move(message));
@@ -190,15 +331,17 @@ public:
         auto key = makeHandlerKey(message.getCategory(), message.getId());
         auto it = message_handlers_.find(key);
         if (it != message_handlers_.end()) {
-            // Handle message
-            it->second->handleMessage(message);
+            // Handle message and record execution time
+            u64 start_ns = metricsNowNanos();
+            it->second.handler->handleMessage(message);
+            it->second.duration->record(metricsNowNanos() - start_ns);
             return Result<void>();
         }
         
         // No handler found
-        NEXT_GEN_LOG_WARNING("No handler for message: category=" + 
-                           std::to_string(message.getCategory()) + 
-                           ", id=" + std::to_string(message.getId()));
+        NEXT_GEN_LOG_WARNING_LIMITED("No handler for message: category=" + 
+                                   std::to_string(message.getCategory()) + 
+                                   ", id=" + std::to_string(message.getId()), 10);
         return Result<void>(ErrorCode::MESSAGE_ERROR, "No handler for message");
     }
     
@@ -208,7 +351,10 @@ public:
         MessageIdType id,
         std::unique_ptr<MessageHandler> handler) override {
         auto key = makeHandlerKey(category, id);
-        message_handlers_[key] = std::move(handler);
+        HandlerEntry entry;
+        entry.handler = std::move(handler);
+        entry.duration = &handlerDurationMetric(category, id);
+        message_handlers_[key] = std::move(entry);
         return Result<void>();
     }
     
@@ -223,49 +369,120 @@ public:
         );
     }
     
-    // Register module with explicit name
-    Result<void> registerModuleWithName(const std::string& name, std::shared_ptr<ModuleInterface> module) {
-        if (!module) {
-            return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module is null");
-        }
-        
-        if (modules_.find(name) != modules_.end()) {
-            return Result<void>(ErrorCode::MODULE_ALREADY_EXISTS, "Module already exists: " + name);
-        }
-        
-        modules_[name] = module;
-        return Result<void>();
-    }
+    // Register module with explicit name. Modules registered after init() or
+    // start() are brought up to the service's state immediately.
+    Result<void> registerModuleWithName(const std::string& name, std::shared_ptr<ModuleInterface> module);
     
     // Register module
-    Result<void> registerModule(std::shared_ptr<ModuleInterface> module) override {
+    Result<void> registerModule(std::shared_ptr<ModuleInterface> module) override;
+    
+    // Register module with its static type, enables getModule<T>()
+    template<typename T>
+    Result<void> registerModule(std::shared_ptr<T> module) {
+        static_assert(std::is_base_of<ModuleInterface, T>::value, "T must be derived from ModuleInterface");
+        return registerTypedModule(std::move(module), moduleTypeId<T>());
+    }
+    
+    // Register module under a type ID from moduleTypeId<T>()
+    Result<void> registerTypedModule(std::shared_ptr<ModuleInterface> module, u32 type) override {
         if (!module) {
-            return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module is null");
+            return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module cannot be null");
         }
-        
-        // 使用临时变量存储模块名称
-        std::string name;
-        
-        // 使用try-catch块捕获任何可能的异常
-        try {
-            name = module->getName();
-        } catch (const std::exception& e) {
-            return Result<void>(ErrorCode::INVALID_ARGUMENT, 
-                std::string("Failed to get module name: ") + e.what());
-        }
-        
-        return registerModuleWithName(name, module);
+        std::string name = module->getName();
+        return registerModuleImpl(name, std::move(module), type);
     }
     
-    // Get module by name
-    std::shared_ptr<ModuleInterface> getModule(const std::string& name) override {
-        auto it = modules_.find(name);
-        if (it != modules_.end()) {
-            return it->second;
+    // Get module by name (lock-free)
+    std::shared_ptr<ModuleInterface> getModule(const std::string& name) override;
+    
+    // Get module by type, O(1) and lock-free for modules registered as T
+    template<typename T>
+    std::shared_ptr<T> getModule() const {
+        ModuleReaders::Scope read(module_readers_);
+        const ModuleSnapshot* snapshot = modules_.load(std::memory_order_seq_cst);
+        u32 type = moduleTypeId<T>();
+        if (type < snapshot->by_type.size() && snapshot->by_type[type]) {
+            return std::static_pointer_cast<T>(snapshot->by_type[type]);
+        }
+        // Registered without static type
+        for (const auto& module : snapshot->modules) {
+            if (auto typed = std::dynamic_pointer_cast<T>(module)) {
+                return typed;
+            }
         }
         return nullptr;
     }
     
+    // Get all modules
+    std::vector<std::shared_ptr<ModuleInterface>> getAllModules() const;
+    
+    // Check if module exists
+    bool hasModule(const std::string& name) const;
+    
+    // Remove module (stopped first if it was started)
+    Result<void> removeModule(const std::string& name);
+    
+    // Initialize all modules: dependency levels in order, modules of a level in parallel
+    Result<void> initAllModules();
+    
+    // Start all modules in dependency order; on failure the started modules are stopped
+    Result<void> startAllModules();
+    
+    // Stop started modules in reverse dependency order
+    Result<void> stopAllModules();
+    
+    // Set number of threads running one dependency level (0 = hardware concurrency)
+    void setModuleParallelism(u32 threads) { module_parallelism_ = threads; }
+    
+    // Get timings of the module lifecycle phases run so far
+    std::vector<ModulePhaseTiming> getModuleTimings() const;
+    
+    // Response or error of a request
+    using ResponseCallback = std::function<void(Result<std::shared_ptr<const Message>>)>;
+    
+    // Send a request over the message bus. The callback runs on this service's
+    // thread with the response, or TIMEOUT after timeout_ms (0 = no timeout).
+    // The service must be registered with the MessageBus; a timeout needs the
+    // TimerManager, which start() starts (SERVICE_NOT_STARTED once stopped).
+    Result<void> request(const ServiceHandle& target, std::shared_ptr<const Message> message,
+                         u32 timeout_ms, ResponseCallback callback);
+    
+    // Send a request, the future completes on this service's thread (never
+    // wait for it on that thread)
+    std::future<Result<std::shared_ptr<const Message>>> request(
+        const ServiceHandle& target, std::shared_ptr<const Message> message, u32 timeout_ms);
+    
+    // Runs a function on a service thread
+    using Executor = std::function<void(std::function<void()>)>;
+    
+    // Run a task on this service's thread (queued like a message)
+    Result<void> execute(std::function<void()> task);
+    
+    // Get an executor for this service's thread, usable from any thread and
+    // after the service is gone (tasks are then dropped)
+    Executor getExecutor() const;
+    
+    // Take shared ownership of the message being dispatched, so it outlives
+    // the handler (service thread only, nullptr outside of dispatch)
+    std::shared_ptr<const Message> retainCurrentMessage();
+    
+    // Configure admission control (before start). When enabled, postMessage
+    // never blocks and returns SERVICE_OVERLOADED for shed messages.
+    Result<void> setAdmissionConfig(const AdmissionConfig& config);
+    
+    // Get messages shed so far and the overload state
+    AdmissionStats getAdmissionStats() const {
+        return admission_ ? admission_->getStats() : AdmissionStats();
+    }
+    
+    // Get message bus ID (INVALID_SERVICE_ID if not registered)
+    ServiceId getServiceId() const {
+        return bus_id_.load(std::memory_order_acquire);
+    }
+    
+    // Get update schedule and cost of the modules currently updated
+    std::vector<ModuleTickStats> getModuleTickStats() const;
+    
     // Get service name
     std::string getName() const override {
         return name_;
@@ -276,6 +493,11 @@ public:
         return running_;
     }
     
+    // Get NUMA node index of the service (ThreadPlacement, set on start)
+    u32 getPlacementNode() const {
+        return placement_node_;
+    }
+    
 protected:
     // Subclass initialization method
     virtual Result<void> onInit() {
@@ -303,25 +525,127 @@ protected:
     }
     
 private:
+    // Module lifecycle phase
+    enum class ModulePhase {
+        INIT,
+        START,
+        STOP
+    };
+    
+    // Replace the module snapshot (caller holds modules_mutex_ after construction)
+    void publishModules(std::unique_ptr<ModuleSnapshot> snapshot) {
+        modules_.store(snapshot.get(), std::memory_order_seq_cst);
+        module_snapshots_.push_back(std::move(snapshot));
+        modules_version_.fetch_add(1, std::memory_order_release);
+    }
+    
+    // Free replaced snapshots if no read is in progress; modules they alone
+    // hold are destroyed outside modules_mutex_
+    void reclaimModuleSnapshots();
+    
+    // Rebuild the update schedule from the started modules (worker thread)
+    void rebuildModuleTicks(u64 now_ms);
+    
+    // Update the modules that are due (worker thread)
+    void tickModules(u64 now_ms);
+    
+    // Wait until module updates observe the current modules_version_, so
+    // modules removed from the schedule can be stopped safely
+    void waitForModuleUpdates();
+    
+    // Register module, type is INVALID_MODULE_TYPE for untyped registration
+    Result<void> registerModuleImpl(const std::string& name, std::shared_ptr<ModuleInterface> module, u32 type);
+    
+    // Group modules into dependency levels (level 0 has no dependencies)
+    Result<std::vector<std::vector<std::shared_ptr<ModuleInterface>>>> resolveModuleLevels() const;
+    
+    // Run a phase for the modules of one level, returns the first error
+    Result<void> runModulePhase(ModulePhase phase, u32 level,
+                                const std::vector<std::shared_ptr<ModuleInterface>>& modules,
+                                std::vector<std::shared_ptr<ModuleInterface>>* completed);
+    
     // Main run loop
     void run() {
         NEXT_GEN_LOG_INFO("Service worker thread started: " + name_);
         
+        // Pin the worker and move the queue it consumes to its node
+        auto& placement = ThreadPlacement::instance();
+        if (placement.enabled()) {
+            placement.pinCurrentThread(placement_node_, "service:" + name_);
+            if (placement.bindsQueueMemory()) {
+                message_queue_->bindToNode(placement_node_);
+            }
+        }
+        
         auto last_update_time = std::chrono::steady_clock::now();
         
         while (running_) {
-            // Process messages
-            auto message = message_queue_->waitAndPop(std::chrono::milliseconds(100));
+            // Wait for a message at most until the next module update is due
+            u64 now_ms = metricsNowNanos() / 1000000;
+            u64 next_tick_ms = tick_wheel_.nextDue();
+            std::chrono::milliseconds timeout(100);
+            if (next_tick_ms <= now_ms) {
+                timeout = std::chrono::milliseconds(0);
+            } else if (next_tick_ms - now_ms < 100) {
+                timeout = std::chrono::milliseconds(next_tick_ms - now_ms);
+            }
+            
+            // Move control messages that found the queue full back in order
+            if (control_overflow_->pending.load(std::memory_order_acquire)) {
+                refillControlOverflow(*message_queue_, *control_overflow_);
+            }
+            
+            // Process messages, shedding those that waited too long
+            auto message = message_queue_->waitAndPop(timeout);
+            u64 dequeue_ns = metricsNowNanos();
+            if (message && admission_ && admission_->shouldDrop(*message, dequeue_ns)) {
+                admission_->recordShed(ShedReason::QUEUE_DELAY);
+                message.reset();
+            }
+            if (admission_ && (!message || message_queue_->empty())) {
+                admission_->onQueueDrained();
+            }
             if (message) {
-                try {
-                    onMessage(*message);
-                } catch (const std::exception& e) {
-                    NEXT_GEN_LOG_ERROR("Exception while processing message: " + std::string(e.what()));
-                } catch (...) {
-                    NEXT_GEN_LOG_ERROR("Unknown exception while processing message");
+                u64 trace_id = message->getTraceId();
+                if (trace_id != 0) {
+                    Tracer::instance().recordSpan(trace_id, "queue", message->getEnqueueTime(), dequeue_ns,
+                                                  message->getCategory(), message->getId(),
+                                                  message->getSessionId());
                 }
+                
+                // Handlers may take ownership (retainCurrentMessage), which
+                // empties message; dispatched stays valid until the end of the iteration
+                const Message* dispatched = message.get();
+                {
+                    TraceScope trace_scope(trace_id);
+                    current_message_ = &message;
+                    try {
+                        if (dispatched->isEnvelope()) {
+                            handleEnvelope(static_cast<const MessageEnvelope&>(*dispatched));
+                        } else {
+                            onMessage(*dispatched);
+                        }
+                    } catch (const std::exception& e) {
+                        NEXT_GEN_LOG_ERROR("Exception while processing message: " + std::string(e.what()));
+                    } catch (...) {
+                        NEXT_GEN_LOG_ERROR("Unknown exception while processing message");
+                    }
+                    current_message_ = nullptr;
+                }
+                
+                u64 done_ns = metricsNowNanos();
+                handler_time_->record(done_ns - dequeue_ns);
+                if (trace_id != 0) {
+                    Tracer::instance().recordSpan(trace_id, "dispatch", dequeue_ns, done_ns,
+                                                  dispatched->getCategory(), dispatched->getId(),
+                                                  dispatched->getSessionId());
+                }
+                retained_message_.reset();
             }
             
+            // Update modules on their own schedule
+            tickModules(metricsNowNanos() / 1000000);
+            
             // Calculate elapsed time
             auto now = std::chrono::steady_clock::now();
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_update_time);
@@ -339,20 +663,130 @@ private:
             }
         }
         
+        // Outstanding requests can no longer be answered
+        failPendingRequests();
+        
         NEXT_GEN_LOG_INFO("Service worker thread stopped: " + name_);
     }
     
+    // Control messages (bus responses, timeouts and tasks) that found the
+    // queue full. Producers never block on them; the worker moves them back
+    // into the queue as it frees slots, oldest first.
+    struct ControlOverflow {
+        std::mutex mutex;
+        std::deque<std::unique_ptr<Message>> messages;
+        std::atomic<bool> pending{false};
+    };
+    
+    // Queue a control message without blocking
+    static Result<void> pushControl(MessageQueue& queue, ControlOverflow& overflow,
+                                    std::unique_ptr<Message> message);
+    
+    // Move parked control messages into the queue while it has room (worker thread)
+    static void refillControlOverflow(MessageQueue& queue, ControlOverflow& overflow);
+    
+    // Registered handler with its execution time histogram
+    struct HandlerEntry {
+        std::unique_ptr<MessageHandler> handler;
+        Histogram* duration = nullptr;
+    };
+    
     // Create handler key
     static u32 makeHandlerKey(MessageCategoryType category, MessageIdType id) {
         return (static_cast<u32>(category) << 16) | static_cast<u32>(id);
     }
     
+    // Resolve handler execution time histogram (once, at registration)
+    Histogram& handlerDurationMetric(MessageCategoryType category, MessageIdType id) {
+        return MetricsRegistry::instance().histogram(
+            "next_gen_handler_duration_seconds", "Message handler execution time",
+            {{"service", name_}, {"category", std::to_string(category)}, {"id", std::to_string(id)}});
+    }
+    
+    // Queue a message through admission control
+    Result<void> admitMessage(std::unique_ptr<Message> message);
+    
+    // Dispatch an envelope from the message bus (worker thread)
+    void handleEnvelope(const MessageEnvelope& envelope);
+    
+    // Complete a pending request (worker thread)
+    void completeRequest(u64 request_id, Result<std::shared_ptr<const Message>> result);
+    
+    // Fail all pending requests (worker thread, on exit)
+    void failPendingRequests();
+    
+    Histogram& moduleUpdateMetric(const std::string& module) {
+        return MetricsRegistry::instance().histogram(
+            "next_gen_module_update_seconds", "Module update execution time",
+            {{"service", name_}, {"module", module}});
+    }
+    
+    // Scheduled module update
+    struct ModuleTickEntry {
+        std::shared_ptr<ModuleInterface> module;
+        std::string name;
+        u32 interval_ms;
+        u32 phase_ms;
+        u64 last_ms;            // Time of the previous update
+        u64 due_ms;
+        Histogram* duration;
+        std::shared_ptr<ModuleEventSlot> events;    // Resolved once, triggered without lookup
+    };
+    
     std::string name_;
     std::atomic<bool> running_;
     std::thread worker_thread_;
+    u32 placement_node_;
     std::shared_ptr<MessageQueue> message_queue_;
-    std::unordered_map<u32, std::unique_ptr<MessageHandler>> message_handlers_;
-    std::unordered_map<std::string, std::shared_ptr<ModuleInterface>> modules_;
+    std::shared_ptr<ControlOverflow> control_overflow_;    // Shared with executors
+    std::unique_ptr<AdmissionController> admission_;   // Set before start, nullptr if disabled
+    Histogram* handler_time_;
+    std::unordered_map<u32, HandlerEntry> message_handlers_;
+    
+    // Modules: current snapshot is read without locking inside a
+    // module_readers_ scope and replaced under modules_mutex_. Replaced
+    // snapshots are kept until a module change sees no read in progress.
+    // Lifecycle state is guarded by modules_mutex_, phases run without it.
+    std::atomic<const ModuleSnapshot*> modules_;
+    std::vector<std::unique_ptr<const ModuleSnapshot>> module_snapshots_;   // Current one last
+    mutable ModuleReaders module_readers_;
+    std::set<std::string> started_modules_;
+    mutable std::mutex modules_mutex_;
+    bool modules_initialized_;
+    bool modules_started_;
+    u32 module_parallelism_;
+    std::vector<ModulePhaseTiming> module_timings_;
+    
+    // Module updates: modules_version_ changes with the module snapshot and the
+    // started set; the worker rebuilds its schedule when it sees a new version.
+    // tick_entries_ and tick_wheel_ belong to the worker, tick_mutex_ guards
+    // replacing tick_entries_ against getModuleTickStats(). The worker holds
+    // tick_run_mutex_ for each update round; stopping a module waits for it.
+    std::atomic<u64> modules_version_;
+    std::atomic<bool> module_ticks_enabled_;
+    u64 tick_version_;
+    std::vector<ModuleTickEntry> tick_entries_;
+    TimerWheel tick_wheel_;
+    std::unordered_map<u32, u32> auto_phase_counters_;
+    mutable std::mutex tick_mutex_;
+    std::mutex tick_run_mutex_;
+    
+    // Message bus: ID set by MessageBus::registerService, pending requests by ID
+    friend class MessageBus;
+    
+    struct PendingRequest {
+        ResponseCallback callback;
+        TimerId timer;          // Timeout timer, 0 if none
+    };
+    
+    std::atomic<ServiceId> bus_id_;
+    std::atomic<u64> next_request_id_;
+    std::unordered_map<u64, PendingRequest> pending_requests_;
+    std::mutex requests_mutex_;
+    
+    // Message being dispatched and its retained owner (worker thread)
+    std::unique_ptr<Message>* current_message_;
+    std::shared_ptr<const Message> retained_message_;
 };
 
 } // namespace next_gen
@@ -20,7 +20,8 @@ using MessageIdType = u16;
 class NEXT_GEN_API Message {
 public:
     Message(MessageCategoryType category, MessageIdType id)
-        : category_(category), id_(id), session_id_(0), timestamp_(0) {}
+        : category_(category), id_(id), session_id_(0), timestamp_(0), enqueue_time_ns_(0), trace_id_(0),
+          envelope_(false) {}
     
     virtual ~Message() = default;
     
@@ -42,6 +43,21 @@ public:
     // Set timestamp
     void setTimestamp(u64 timestamp) { timestamp_ = timestamp; }
     
+    // Get enqueue time (monotonic nanoseconds, 0 if not stamped)
+    u64 getEnqueueTime() const { return enqueue_time_ns_; }
+    
+    // Set enqueue time
+    void setEnqueueTime(u64 enqueue_time_ns) { enqueue_time_ns_ = enqueue_time_ns; }
+    
+    // Get trace ID (0 if not traced)
+    u64 getTraceId() const { return trace_id_; }
+    
+    // Set trace ID
+    void setTraceId(u64 trace_id) { trace_id_ = trace_id; }
+    
+    // Check if this is a message bus envelope (see MessageEnvelope)
+    bool isEnvelope() const { return envelope_; }
+    
     // Get message name
     virtual std::string getName() const { return "Message"; }
     
@@ -73,6 +89,9 @@ protected:
     MessageIdType id_;
     u32 session_id_;
     u64 timestamp_;
+    u64 enqueue_time_ns_;
+    u64 trace_id_;
+    bool envelope_;
 };
 
 // Message factory interface
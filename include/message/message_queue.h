@@ -7,8 +7,11 @@
 #include <chrono>
 #include <memory>
 #include <atomic>
+#include <new>
 #include "message.h"
 #include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include "../utils/thread_placement.h"
 
 namespace next_gen {
 
@@ -17,9 +20,17 @@ class NEXT_GEN_API MessageQueue {
 public:
     virtual ~MessageQueue() = default;
     
+    // Enable depth, throughput and enqueue-to-dequeue latency metrics
+    // (call before the queue is shared between threads)
+    void enableMetrics(const std::string& name);
+    
     // Push message to queue
     virtual void push(std::unique_ptr<Message> message) = 0;
     
+    // Push message without blocking, return false if the queue is full or
+    // shutdown (the message is then left with the caller)
+    virtual bool tryPush(std::unique_ptr<Message>& message) = 0;
+    
     // Pop message from queue, block if queue is empty
     virtual std::unique_ptr<Message> pop() = 0;
     
@@ -43,9 +54,54 @@ public:
     
     // Check if queue is shutdown
     virtual bool isShutdown() const = 0;
+    
+    // Move preallocated storage to a NUMA node (ThreadPlacement node index),
+    // queues allocating per message keep the default no-op
+    virtual void bindToNode(u32 /*node*/) {}
+    
+protected:
+    // Queue metrics, resolved once in enableMetrics
+    struct QueueMetrics {
+        Gauge* depth;
+        Counter* enqueued;
+        Counter* dequeued;
+        Histogram* wait_time;
+    };
+    
+    // Called before a message becomes visible to consumers
+    void onEnqueue(Message& message) {
+        if (metrics_) {
+            message.setEnqueueTime(metricsNowNanos());
+            metrics_->enqueued->inc();
+        }
+    }
+    
+    // Called after a message was removed by a consumer
+    void onDequeued(const Message& message) {
+        if (metrics_) {
+            metrics_->dequeued->inc();
+            if (message.getEnqueueTime() != 0) {
+                metrics_->wait_time->record(metricsNowNanos() - message.getEnqueueTime());
+            }
+        }
+    }
+    
+    // Update queue depth gauge
+    void updateDepth(size_t depth) {
+        if (metrics_) {
+            metrics_->depth->set(static_cast<i64>(depth));
+        }
+    }
+    
+    std::unique_ptr<QueueMetrics> metrics_;
 };
 
 // Default message queue implementation
+//
+// Storage grows per message on the producing threads, so there is no
+// preallocated buffer to move: bindToNode() is a no-op and only the worker
+// is placed. Use "lockfree" or "mpmc" to keep the queue memory on the
+// consumer's node.
 class NEXT_GEN_API DefaultMessageQueue : public MessageQueue {
 public:
     DefaultMessageQueue(size_t maxSize = 0) 
@@ -58,6 +114,9 @@ public:
     // Push message to queue
     void push(std::unique_ptr<Message> message) override;
     
+    // Push message without blocking, return false if full or shutdown
+    bool tryPush(std::unique_ptr<Message>& message) override;
+    
     // Pop message from queue, block if queue is empty
     std::unique_ptr<Message> pop() override;
     
@@ -91,7 +150,8 @@ private:
     std::atomic<bool> shutdown_;
 };
 
-// Priority message queue implementation
+// Priority message queue implementation (bindToNode() is a no-op, as for
+// DefaultMessageQueue)
 class NEXT_GEN_API PriorityMessageQueue : public MessageQueue {
 public:
     PriorityMessageQueue(size_t maxSize = 0) 
@@ -102,6 +162,9 @@ public:
     // Push message to queue
     void push(std::unique_ptr<Message> message) override;
     
+    // Push message without blocking, return false if full or shutdown
+    bool tryPush(std::unique_ptr<Message>& message) override;
+    
     // Pop message from queue, block if queue is empty
     std::unique_ptr<Message> pop() override;
     
@@ -156,10 +219,12 @@ class NEXT_GEN_API LockFreeMessageQueue : public MessageQueue {
 public:
     LockFreeMessageQueue(size_t capacity = 1024)
         : capacity_(capacity), head_(0), tail_(0), shutdown_(false) {
-        // Allocate buffer with capacity + 1 elements (to distinguish between empty and full)
-        buffer_ = new std::atomic<Message*>[capacity + 1];
+        // Allocate buffer with capacity + 1 elements (to distinguish between empty and full),
+        // on pages of its own so bindToNode moves nothing else
+        buffer_ = static_cast<std::atomic<Message*>*>(
+            ThreadPlacement::allocatePages(sizeof(std::atomic<Message*>) * (capacity + 1)));
         for (size_t i = 0; i <= capacity; ++i) {
-            buffer_[i].store(nullptr, std::memory_order_relaxed);
+            new (&buffer_[i]) std::atomic<Message*>(nullptr);
         }
     }
     
@@ -168,6 +233,9 @@ public:
     // Push message to queue
     void push(std::unique_ptr<Message> message) override;
     
+    // Push message without blocking, return false if full or shutdown
+    bool tryPush(std::unique_ptr<Message>& message) override;
+    
     // Pop message from queue, block if queue is empty
     std::unique_ptr<Message> pop() override;
     
@@ -192,6 +260,9 @@ public:
     // Check if queue is shutdown
     bool isShutdown() const override;
     
+    // Move the ring buffer to a NUMA node
+    void bindToNode(u32 node) override;
+    
 private:
     size_t capacity_;
     std::atomic<Message*>* buffer_;
@@ -205,9 +276,10 @@ class NEXT_GEN_API MPMCMessageQueue : public MessageQueue {
 public:
     MPMCMessageQueue(size_t capacity = 1024)
         : capacity_(capacity), shutdown_(false) {
-        // Initialize ring buffer
-        buffer_ = new Cell[capacity_];
+        // Initialize ring buffer, on pages of its own so bindToNode moves nothing else
+        buffer_ = static_cast<Cell*>(ThreadPlacement::allocatePages(sizeof(Cell) * capacity_));
         for (size_t i = 0; i < capacity_; ++i) {
+            new (&buffer_[i]) Cell();
             buffer_[i].sequence.store(i, std::memory_order_relaxed);
         }
         
@@ -221,6 +293,9 @@ public:
     // Push message to queue
     void push(std::unique_ptr<Message> message) override;
     
+    // Push message without blocking, return false if full or shutdown
+    bool tryPush(std::unique_ptr<Message>& message) override;
+    
     // Pop message from queue, block if queue is empty
     std::unique_ptr<Message> pop();
     
@@ -245,6 +320,9 @@ public:
     // Check if queue is shutdown
     bool isShutdown() const override;
     
+    // Move the ring buffer to a NUMA node
+    void bindToNode(u32 node) override;
+    
 private:
     struct Cell {
         std::atomic<size_t> sequence;
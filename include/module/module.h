@@ -3,6 +3,10 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
 #include "../utils/error.h"
 #include "module_interface.h"
 
@@ -14,7 +18,8 @@ class Service;
 // Module interface
 class NEXT_GEN_API Module : public ModuleInterface, public std::enable_shared_from_this<Module> {
 public:
-    Module(std::weak_ptr<Service> service) : service_(service) {}
+    Module(std::weak_ptr<Service> service)
+        : service_(service), update_interval_ms_(0), update_phase_ms_(AUTO_UPDATE_PHASE) {}
     
     virtual ~Module() = default;
     
@@ -41,6 +46,22 @@ public:
         return Result<void>();
     }
     
+    // Get update interval (0 = no updates)
+    u32 getUpdateInterval() const override {
+        return update_interval_ms_;
+    }
+    
+    // Get update phase
+    u32 getUpdatePhase() const override {
+        return update_phase_ms_;
+    }
+    
+    // Set update interval and phase, read when the service schedules the started module
+    void setUpdateInterval(u32 interval_ms, u32 phase_ms = AUTO_UPDATE_PHASE) {
+        update_interval_ms_ = interval_ms;
+        update_phase_ms_ = phase_ms;
+    }
+    
     // Register message handler
     template<typename T, typename Handler>
     Result<void> registerMessageHandler(Handler&& handler) {
@@ -64,8 +85,47 @@ public:
     // Get service
     std::shared_ptr<Service> getService();
     
+    // Add dependency on a registered module; dependencies are initialized and
+    // started before this module and stopped after it
+    Result<void> addDependency(const std::string& dependency_name);
+    
+    // Check if module depends directly on another module
+    bool dependsOn(const std::string& module_name);
+    
+    // Get direct dependencies
+    std::vector<std::string> getDependencies();
+    
 protected:
     std::weak_ptr<Service> service_;
+    u32 update_interval_ms_;
+    u32 update_phase_ms_;
+};
+
+// Module dependencies by module name, used to order the module lifecycle
+class NEXT_GEN_API ModuleDependencyManager {
+public:
+    static ModuleDependencyManager& instance();
+    
+    // Add dependency
+    void addDependency(const std::string& module, const std::string& dependency);
+    
+    // Check if module is part of a dependency cycle
+    bool hasCircularDependency(const std::string& module);
+    
+    // Get direct dependencies of module
+    std::vector<std::string> getDependencies(const std::string& module);
+    
+    // Remove all dependencies of module
+    void clearDependencies(const std::string& module);
+    
+private:
+    ModuleDependencyManager() = default;
+    
+    // Depth-first search for a cycle through module
+    bool hasCircularDependencyImpl(const std::string& module, std::vector<std::string>& path);
+    
+    std::unordered_map<std::string, std::vector<std::string>> dependencies_;
+    std::mutex mutex_;
 };
 
 // Base module implementation
@@ -82,7 +142,7 @@ public:
     // Get module instance
     static std::shared_ptr<ModuleType> getInstance(std::shared_ptr<Service> service) {
         auto module = std::make_shared<ModuleType>(service);
-        auto result = service->registerModule(module);
+        auto result = service->registerTypedModule(module, moduleTypeId<ModuleType>());
         if (result.has_error()) {
             NEXT_GEN_LOG_ERROR("Failed to register module: " + ModuleType::MODULE_NAME + 
                               ", error: " + result.error().message());
@@ -100,23 +160,31 @@ public:
     static std::shared_ptr<ModuleType> createModule(std::shared_ptr<Service> service, Args&&... args) {
         static_assert(std::is_base_of<Module, ModuleType>::value, "ModuleType must be derived from Module");
         
+        // The service initializes the module with its lifecycle (immediately if already initialized)
         auto module = std::make_shared<ModuleType>(service, std::forward<Args>(args)...);
-        auto result = service->registerModule(module);
+        auto result = service->registerTypedModule(module, moduleTypeId<ModuleType>());
         if (result.has_error()) {
             NEXT_GEN_LOG_ERROR("Failed to register module: " + module->getName() + 
                               ", error: " + result.error().message());
             return nullptr;
         }
         
-        auto init_result = module->init();
-        if (init_result.has_error()) {
-            NEXT_GEN_LOG_ERROR("Failed to initialize module: " + module->getName() + 
-                              ", error: " + init_result.error().message());
-            return nullptr;
-        }
-        
         return module;
     }
+    
+    // Create module with a factory function and register it
+    static Result<std::shared_ptr<ModuleInterface>> createAndRegisterModule(
+        std::shared_ptr<Service> service,
+        const std::string& module_name,
+        std::function<std::shared_ptr<ModuleInterface>()> factory_func);
+    
+    // Set lifecycle event handlers of a module
+    static void setModuleEventHandlers(
+        const std::string& module_name,
+        std::function<void(std::shared_ptr<ModuleInterface>)> on_init,
+        std::function<void(std::shared_ptr<ModuleInterface>)> on_start,
+        std::function<void(std::shared_ptr<ModuleInterface>)> on_stop,
+        std::function<void(std::shared_ptr<ModuleInterface>, u64)> on_update);
 };
 
 } // namespace next_gen
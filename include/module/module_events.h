@@ -0,0 +1,123 @@
+#ifndef NEXT_GEN_MODULE_EVENTS_H
+#define NEXT_GEN_MODULE_EVENTS_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include "../core/config.h"
+#include "module_interface.h"
+
+namespace next_gen {
+
+// Module event callbacks, empty callbacks are skipped
+struct ModuleEventHandlers {
+    std::function<void(std::shared_ptr<ModuleInterface>)> on_init;
+    std::function<void(std::shared_ptr<ModuleInterface>)> on_start;
+    std::function<void(std::shared_ptr<ModuleInterface>)> on_stop;
+    std::function<void(std::shared_ptr<ModuleInterface>, u64)> on_update;
+};
+
+// Event subscribers of one module
+//
+// The subscriber list is immutable and replaced as a whole under the slot's
+// own mutex. Triggers load the current list with one atomic load and run the
+// callbacks without any lock. Replaced lists stay alive until the slot is
+// destroyed, so a trigger never races with a subscription change.
+class NEXT_GEN_API ModuleEventSlot {
+public:
+    using HandlerList = std::vector<ModuleEventHandlers>;
+
+    ModuleEventSlot();
+
+    ModuleEventSlot(const ModuleEventSlot&) = delete;
+    ModuleEventSlot& operator=(const ModuleEventSlot&) = delete;
+
+    // Replace all subscribers
+    void set(HandlerList handlers);
+
+    // Add a subscriber
+    void add(ModuleEventHandlers handlers);
+
+    // Remove all subscribers
+    void clear() { set(HandlerList()); }
+
+    // Check if there are subscribers
+    bool empty() const { return handlers_.load(std::memory_order_acquire)->empty(); }
+
+    void triggerInitEvent(const std::shared_ptr<ModuleInterface>& module) const {
+        for (const auto& handlers : *handlers_.load(std::memory_order_acquire)) {
+            if (handlers.on_init) handlers.on_init(module);
+        }
+    }
+
+    void triggerStartEvent(const std::shared_ptr<ModuleInterface>& module) const {
+        for (const auto& handlers : *handlers_.load(std::memory_order_acquire)) {
+            if (handlers.on_start) handlers.on_start(module);
+        }
+    }
+
+    void triggerStopEvent(const std::shared_ptr<ModuleInterface>& module) const {
+        for (const auto& handlers : *handlers_.load(std::memory_order_acquire)) {
+            if (handlers.on_stop) handlers.on_stop(module);
+        }
+    }
+
+    void triggerUpdateEvent(const std::shared_ptr<ModuleInterface>& module, u64 elapsed_ms) const {
+        for (const auto& handlers : *handlers_.load(std::memory_order_acquire)) {
+            if (handlers.on_update) handlers.on_update(module, elapsed_ms);
+        }
+    }
+
+private:
+    std::atomic<const HandlerList*> handlers_;
+    std::vector<std::unique_ptr<const HandlerList>> lists_;
+    std::mutex mutex_;
+};
+
+// Module event manager
+//
+// Maps module names to event slots. Hot paths resolve a module's slot once
+// (getSlot) and trigger through the handle; the name lookup and the manager
+// mutex are only used when subscribing or resolving.
+class NEXT_GEN_API ModuleEventManager {
+public:
+    static ModuleEventManager& instance();
+
+    // Get the event slot of a module, created on first use and never replaced
+    std::shared_ptr<ModuleEventSlot> getSlot(const std::string& module_name);
+
+    // Replace the subscribers of a module
+    void registerEventHandlers(const std::string& module_name, ModuleEventHandlers handlers);
+
+    // Add a subscriber to a module
+    void addEventHandlers(const std::string& module_name, ModuleEventHandlers handlers);
+
+    // Remove the subscribers of a module
+    void removeEventHandlers(const std::string& module_name);
+
+    // Trigger by module name (one lookup per call, prefer slot handles when repeated)
+    void triggerInitEvent(const std::shared_ptr<ModuleInterface>& module);
+    void triggerStartEvent(const std::shared_ptr<ModuleInterface>& module);
+    void triggerStopEvent(const std::shared_ptr<ModuleInterface>& module);
+    void triggerUpdateEvent(const std::shared_ptr<ModuleInterface>& module, u64 elapsed_ms);
+
+private:
+    ModuleEventManager() {}
+
+    ModuleEventManager(const ModuleEventManager&) = delete;
+    ModuleEventManager& operator=(const ModuleEventManager&) = delete;
+
+    // Find an existing slot, nullptr if the module has none
+    std::shared_ptr<ModuleEventSlot> findSlot(const std::string& module_name);
+
+    std::unordered_map<std::string, std::shared_ptr<ModuleEventSlot>> slots_;
+    std::mutex mutex_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_MODULE_EVENTS_H
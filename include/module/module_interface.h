@@ -11,6 +11,22 @@ namespace next_gen {
 class Service;
 class Message;
 
+// Update phase chosen by the service to spread modules with equal intervals
+constexpr u32 AUTO_UPDATE_PHASE = 0xFFFFFFFF;
+
+// Type index of modules registered without a static type
+constexpr u32 INVALID_MODULE_TYPE = 0xFFFFFFFF;
+
+// Allocate the next dense module type index
+NEXT_GEN_API u32 allocateModuleTypeId();
+
+// Module type index, assigned on first use and stable for the process
+template<typename T>
+u32 moduleTypeId() {
+    static const u32 id = allocateModuleTypeId();
+    return id;
+}
+
 // Module interface - only contains pure virtual methods
 class NEXT_GEN_API ModuleInterface {
 public:
@@ -28,6 +44,15 @@ public:
     // Stop module
     virtual Result<void> stop() = 0;
     
+    // Update module, called on the service thread every update interval
+    virtual Result<void> update(u64 elapsed_ms) = 0;
+    
+    // Update interval in milliseconds, 0 disables updates
+    virtual u32 getUpdateInterval() const = 0;
+    
+    // Offset of the updates within the interval in milliseconds, or AUTO_UPDATE_PHASE
+    virtual u32 getUpdatePhase() const = 0;
+    
     // Handle message
     virtual Result<void> handleMessage(const Message& message) = 0;
 };
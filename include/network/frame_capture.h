@@ -0,0 +1,175 @@
+#ifndef NEXT_GEN_FRAME_CAPTURE_H
+#define NEXT_GEN_FRAME_CAPTURE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include "../core/config.h"
+#include "../message/message.h"
+#include "../utils/error.h"
+#include "../utils/mapped_file.h"
+
+namespace next_gen {
+
+// Frame capture segment layout (host byte order, read by FrameCaptureReader):
+//
+//   FrameCaptureFileHeader
+//   record*  := FrameCaptureRecordHeader body
+//
+// Every inbound frame is recorded after decompression, so a capture replays
+// independently of the compression negotiated by the original sessions.
+// A record with size 0 marks the end of the written data.
+
+constexpr char FRAME_CAPTURE_MAGIC[8] = {'N', 'G', 'C', 'A', 'P', 'T', '0', '1'};
+constexpr u16 FRAME_CAPTURE_VERSION = 1;
+constexpr const char* FRAME_CAPTURE_EXTENSION = ".ngcap";
+
+// Transport a frame arrived on
+enum class CaptureTransport : u8 {
+    TCP = 1,
+    UDP = 2            // Raw datagram, category and ID are 0
+};
+
+// Segment file header
+struct FrameCaptureFileHeader {
+    char magic[8];
+    u16 version;
+    u16 reserved;
+    u32 segment_index;
+    u64 start_time_ns;      // Nanoseconds since epoch (system clock)
+};
+
+// Record header
+struct FrameCaptureRecordHeader {
+    u32 size;               // Total record size including this header
+    u8 transport;           // CaptureTransport
+    u8 category;            // Message category
+    u16 id;                 // Message ID
+    u32 session_id;         // Receiving session
+    u32 reserved;
+    u64 timestamp_ns;       // Receive time (monotonic nanoseconds)
+};
+
+static_assert(sizeof(FrameCaptureFileHeader) == 24, "Unexpected frame capture file header size");
+static_assert(sizeof(FrameCaptureRecordHeader) == 24, "Unexpected frame capture record header size");
+
+// Frame capture configuration
+struct FrameCaptureConfig {
+    std::string path;                         // Segment base path, files are <path>.<index>.ngcap; empty disables
+    u64 segment_size = 256 * 1024 * 1024;     // Segment size in bytes
+    u32 max_segments = 0;                     // Segments to keep, 0 keeps all
+    u32 buffer_size = 4 * 1024 * 1024;        // Staging buffer; frames that do not fit are dropped
+    u32 flush_interval_ms = 50;               // Writer thread wake-up interval
+};
+
+// Captured frame
+struct FrameCaptureRecord {
+    CaptureTransport transport;
+    u32 session_id;
+    MessageCategoryType category;
+    MessageIdType id;
+    u64 timestamp_ns;
+    const u8* body;         // Valid until the next call to FrameCaptureReader::next()
+    size_t body_size;
+};
+
+// Frame capture writer
+//
+// Network threads append records to a staging buffer under a short lock (one
+// memcpy); a background thread moves the buffer into memory-mapped, rotating
+// segment files. Capture never blocks the network threads: when the staging
+// buffer is full the frame is counted as dropped.
+class NEXT_GEN_API FrameCaptureWriter {
+public:
+    FrameCaptureWriter();
+    ~FrameCaptureWriter();
+
+    FrameCaptureWriter(const FrameCaptureWriter&) = delete;
+    FrameCaptureWriter& operator=(const FrameCaptureWriter&) = delete;
+
+    // Open capture, replacing segments left by a previous capture with the same path
+    Result<void> open(const FrameCaptureConfig& config);
+
+    // Close capture (writes pending records and truncates the current segment)
+    void close();
+
+    // Check if capture is open
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+
+    // Record an inbound frame
+    void write(CaptureTransport transport, u32 session_id, MessageCategoryType category, MessageIdType id,
+               const u8* body, size_t size, u64 timestamp_ns);
+
+    // Get number of captured frames
+    u64 getCapturedFrames() const { return captured_frames_.load(std::memory_order_relaxed); }
+
+    // Get number of frames dropped because the staging buffer was full
+    u64 getDroppedFrames() const { return dropped_frames_.load(std::memory_order_relaxed); }
+
+private:
+    // Writer thread loop
+    void run();
+
+    // Copy staged records into the segment files
+    void writeRecords(const std::vector<u8>& records);
+
+    // Open next segment and apply retention
+    Result<void> openSegment();
+
+    // Segment file path
+    std::string segmentPath(u32 index) const;
+
+    FrameCaptureConfig config_;
+    std::atomic<bool> open_;
+
+    // Staging buffers (active_ is filled by network threads, pending_ written by the writer thread)
+    std::mutex buffer_mutex_;
+    std::condition_variable buffer_cv_;
+    std::vector<u8> active_;
+    std::vector<u8> pending_;
+    bool stopping_;
+    std::thread writer_thread_;
+
+    // Segment state (writer thread only)
+    MappedFile file_;
+    u32 segment_index_;
+    size_t write_pos_;
+
+    std::atomic<u64> captured_frames_;
+    std::atomic<u64> dropped_frames_;
+};
+
+// Frame capture reader
+class NEXT_GEN_API FrameCaptureReader {
+public:
+    FrameCaptureReader();
+
+    // Open a capture: a single segment file, or a base path whose segments are read in order
+    Result<void> open(const std::string& path);
+
+    // Read next record, returns false at the end of the capture
+    bool next(FrameCaptureRecord& record);
+
+    // Get segment files of the capture
+    const std::vector<std::string>& getSegments() const { return segments_; }
+
+    // Get start time of the first segment (nanoseconds since epoch)
+    u64 getStartTime() const { return start_time_ns_; }
+
+private:
+    // Map segment at index, returns false if it is missing or invalid
+    bool openSegment(size_t index);
+
+    std::vector<std::string> segments_;
+    size_t segment_;
+    MappedFile file_;
+    size_t read_pos_;
+    u64 start_time_ns_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_FRAME_CAPTURE_H
@@ -0,0 +1,107 @@
+#ifndef NEXT_GEN_FRAME_REPLAY_H
+#define NEXT_GEN_FRAME_REPLAY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include "../core/config.h"
+#include "../core/service.h"
+#include "../message/message.h"
+#include "../utils/error.h"
+#include "../utils/metrics.h"
+#include "frame_capture.h"
+
+namespace next_gen {
+
+// Replay configuration
+struct ReplayConfig {
+    f64 speed = 1.0;                // Pacing factor relative to the capture, 0 replays as fast as possible
+    u32 drain_timeout_ms = 1000;    // Give up waiting for completions after this long without progress
+    u64 max_frames = 0;             // Stop after this many frames, 0 replays the whole capture
+};
+
+// Replay statistics
+struct ReplayStats {
+    u64 frames = 0;                 // Frames read from the capture
+    u64 posted = 0;                 // Messages posted to the service
+    u64 completed = 0;              // Messages reported through recordCompletion()
+    u64 decode_errors = 0;          // Frames the decoder rejected
+    u64 post_errors = 0;            // Messages the service refused
+    f64 elapsed_seconds = 0.0;      // Replay wall time including the drain
+    f64 throughput = 0.0;           // Completed messages per second
+    u64 lag_p99_ns = 0;             // Posting delay behind the capture schedule
+    u64 lag_max_ns = 0;
+    u64 latency_p50_ns = 0;         // Enqueue to completion
+    u64 latency_p99_ns = 0;
+    u64 latency_max_ns = 0;
+};
+
+// Captured frame body as raw bytes, for frames without a registered message
+// type; serialize() returns the body unchanged
+class NEXT_GEN_API CapturedMessage : public Message {
+public:
+    explicit CapturedMessage(const FrameCaptureRecord& record)
+        : Message(record.category, record.id), body_(record.body, record.body + record.body_size) {}
+
+    // Get captured body
+    const std::vector<u8>& getBody() const { return body_; }
+
+    std::string getName() const override { return "CapturedMessage"; }
+
+    Result<std::vector<u8>> serialize() const override {
+        return Result<std::vector<u8>>(body_);
+    }
+
+    Result<void> deserialize(const std::vector<u8>& data) override {
+        body_ = data;
+        return Result<void>();
+    }
+
+    std::unique_ptr<Message> clone() const override {
+        return std::make_unique<CapturedMessage>(*this);
+    }
+
+private:
+    std::vector<u8> body_;
+};
+
+// Frame replayer
+//
+// Feeds a frame capture into a service, either with the original inter-frame
+// timing (scaled by ReplayConfig::speed) or as fast as possible. The service
+// reports handled messages through recordCompletion(), which measures the
+// latency from postMessage() to completion.
+class NEXT_GEN_API FrameReplayer {
+public:
+    // Turns a captured frame into a message, nullptr rejects the frame
+    using Decoder = std::function<std::unique_ptr<Message>(const FrameCaptureRecord&)>;
+
+    FrameReplayer(Service& service, const ReplayConfig& config = ReplayConfig());
+
+    // Set decoder (default: message factory and deserialize)
+    void setDecoder(Decoder decoder) { decoder_ = std::move(decoder); }
+
+    // Replay a capture (segment file or base path), blocks until drained
+    Result<ReplayStats> run(const std::string& path);
+
+    // Record completion of a replayed message (thread-safe, called by the service)
+    void recordCompletion(const Message& message);
+
+    // Default decoder
+    static std::unique_ptr<Message> decodeFrame(const FrameCaptureRecord& record);
+
+private:
+    Service& service_;
+    ReplayConfig config_;
+    Decoder decoder_;
+
+    Histogram lag_;
+    Histogram latency_;
+    std::atomic<u64> completed_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_FRAME_REPLAY_H
@@ -0,0 +1,57 @@
+#ifndef NEXT_GEN_METRICS_ENDPOINT_H
+#define NEXT_GEN_METRICS_ENDPOINT_H
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include "asio_wrapper.h"
+#include "../utils/error.h"
+#include "../utils/metrics.h"
+
+namespace next_gen {
+
+// Metrics endpoint configuration
+struct MetricsEndpointConfig {
+    std::string bind_address = "127.0.0.1";  // Bind address (local only by default)
+    u16 port = 9100;                          // Port, 0 picks a free port
+};
+
+// Minimal HTTP endpoint serving MetricsRegistry snapshots in Prometheus text
+// format. Any GET request is answered with the full snapshot, runs on its own
+// IO thread so scrapes never touch service threads.
+class NEXT_GEN_API MetricsEndpoint {
+public:
+    MetricsEndpoint(const MetricsEndpointConfig& config = MetricsEndpointConfig());
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    // Start listening
+    Result<void> start();
+
+    // Stop listening
+    void stop();
+
+    // Check if endpoint is running
+    bool isRunning() const { return running_; }
+
+    // Get bound port
+    u16 getPort() const { return port_; }
+
+private:
+    // Accept next connection
+    void acceptConnection();
+
+    MetricsEndpointConfig config_;
+    std::unique_ptr<asio::io_context> io_context_;
+    std::unique_ptr<asio::ip::tcp::acceptor> acceptor_;
+    std::thread io_thread_;
+    std::atomic<bool> running_;
+    u16 port_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_METRICS_ENDPOINT_H
@@ -12,7 +12,9 @@
 #include "../core/service.h"
 #include "../utils/error.h"
 #include "../utils/logger.h"
+#include "../utils/metrics.h"
 #include "../message/message.h"
+#include "frame_capture.h"
 
 namespace next_gen {
 
@@ -106,6 +108,7 @@ struct NetServiceConfig {
     bool reuse_address = true;                // Reuse address option
     bool tcp_no_delay = true;                 // TCP no delay option
     bool keep_alive = true;                   // Keep alive option
+    FrameCaptureConfig capture;               // Inbound frame capture, disabled when path is empty
 };
 
 // Network service interface
@@ -115,6 +118,23 @@ public:
     
     virtual ~NetService();
     
+    // Record bytes received at the framing layer
+    void recordBytesReceived(size_t bytes) { total_bytes_received_->inc(bytes); }
+    
+    // Record bytes sent at the framing layer
+    void recordBytesSent(size_t bytes) { total_bytes_sent_->inc(bytes); }
+    
+    // Record an inbound frame when capture is enabled
+    void captureFrame(CaptureTransport transport, SessionId session_id, MessageCategoryType category,
+                      MessageIdType id, const u8* body, size_t size, u64 timestamp_ns) {
+        if (capture_.isOpen()) {
+            capture_.write(transport, session_id, category, id, body, size, timestamp_ns);
+        }
+    }
+    
+    // Get frame capture writer
+    const FrameCaptureWriter& getFrameCapture() const { return capture_; }
+    
 protected:
     // Initialize network service
     Result<void> onInit() override;
@@ -183,13 +203,17 @@ protected:
     std::mutex sessions_mutex_;
     std::atomic<SessionId> next_session_id_;
     
-    // Statistics
-    std::atomic<u64> total_connections_;
-    std::atomic<u64> total_messages_received_;
-    std::atomic<u64> total_messages_sent_;
-    std::atomic<u64> total_bytes_received_;
-    std::atomic<u64> total_bytes_sent_;
+    // Statistics (owned by the metrics registry, labelled with the service name)
+    Counter* total_connections_;
+    Gauge* active_sessions_;
+    Counter* total_messages_received_;
+    Counter* total_messages_sent_;
+    Counter* total_bytes_received_;
+    Counter* total_bytes_sent_;
     std::atomic<u64> last_idle_check_;
+    
+    // Inbound frame capture
+    FrameCaptureWriter capture_;
 };
 
 } // namespace next_gen
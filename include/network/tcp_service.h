@@ -3,6 +3,7 @@
 
 #include "net_service.h"
 #include "asio_wrapper.h"
+#include "../utils/compression.h"
 #include <atomic>
 #include <memory>
 
@@ -24,6 +25,9 @@ struct TcpServiceConfig : public NetServiceConfig {
     
     // Socket receive buffer size
     u32 socket_recv_buffer_size = 8192;
+    
+    // Frame compression, negotiated per session (disabled by default)
+    CompressionConfig compression;
 };
 
 // TCP network service implementation
@@ -47,6 +51,9 @@ public:
     // Handle sent message
     void handleSentMessageById(std::shared_ptr<Session> session, const Message& message);
     
+    // Get TCP configuration
+    const TcpServiceConfig& getTcpConfig() const { return tcp_config_; }
+    
 protected:
     // Initialize network library
     Result<void> initNetworkLibrary() override;
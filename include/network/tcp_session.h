@@ -3,6 +3,8 @@
 
 #include "net_service.h"
 #include "asio_wrapper.h"
+#include "../utils/compression.h"
+#include "../utils/byte_stream.h"
 #include <memory>
 #include <queue>
 #include <mutex>
@@ -15,6 +17,26 @@ namespace next_gen {
 // Forward declaration
 class TcpService;
 
+// Frame layout: category (u8), id (u16), body size (u32), body.
+// The top two bits of the body size carry the CompressionAlgorithm of the body;
+// a compressed body starts with the original size (u32) followed by the compressed data.
+constexpr u32 FRAME_COMPRESSION_SHIFT = 30;
+constexpr u32 FRAME_BODY_SIZE_MASK = (1u << FRAME_COMPRESSION_SHIFT) - 1;
+
+// Reserved control frames negotiating compression. The client sends a hello
+// (FRAME_CONTROL_COMPRESSION) with version (u8), supported algorithm mask (u8)
+// and dictionary ID (u32, 0 for none); the server answers with its own id
+// (FRAME_CONTROL_COMPRESSION_ANSWER) and the same layout holding the chosen
+// algorithm bit (or 0) and the dictionary ID both sides will use. Compressed
+// frames are only valid after the answer, in both directions. TcpSession takes
+// the server role: it answers hellos and rejects hellos with an unknown version,
+// answers and frames compressed with an algorithm that was not negotiated.
+constexpr MessageCategoryType FRAME_CONTROL_CATEGORY = 0xFF;
+constexpr MessageIdType FRAME_CONTROL_COMPRESSION = 0xFFFF;
+constexpr MessageIdType FRAME_CONTROL_COMPRESSION_ANSWER = 0xFFFE;
+constexpr u8 FRAME_COMPRESSION_VERSION = 1;
+constexpr size_t FRAME_COMPRESSION_HELLO_SIZE = 6;
+
 // TCP session implementation
 class NEXT_GEN_API TcpSession : public Session, public std::enable_shared_from_this<TcpSession> {
 public:
@@ -63,6 +85,13 @@ public:
     // Get socket
     asio::ip::tcp::socket& getSocket();
     
+    // Delta encoding contexts of this connection, one per direction. A
+    // reconnect creates a new session, so the first messages are keyframes.
+    // Use the send context from one thread in the order messages are sent,
+    // and the receive context in the order messages are delivered.
+    DeltaContext& getSendDeltaContext() { return send_delta_context_; }
+    DeltaContext& getReceiveDeltaContext() { return receive_delta_context_; }
+    
 private:
     // Read header
     void readHeader();
@@ -82,6 +111,23 @@ private:
     // Handle write
     void handleWrite(const std::error_code& error, std::size_t bytes_transferred);
     
+    // Build a frame, compressing the body if negotiated and above the threshold
+    std::vector<u8> buildFrame(MessageCategoryType category, MessageIdType id,
+                               const std::vector<u8>& body, CompressionAlgorithm algorithm);
+    
+    // Queue a frame for writing
+    void queueFrame(std::vector<u8> frame);
+    
+    // Decompress a frame body into body_data
+    Result<void> decompressBody(CompressionAlgorithm algorithm, const u8* data, size_t size,
+                                std::vector<u8>& body_data);
+    
+    // Answer the peer's compression hello
+    void handleCompressionHello(const u8* data, size_t size);
+    
+    // Deliver decoded message to the service
+    void deliverMessage(std::unique_ptr<Message> message);
+    
     // Reset idle timer
     void resetIdleTimer();
     
@@ -103,6 +149,9 @@ private:
     // Read buffer
     std::vector<u8> read_buffer_;
     
+    // Time the current frame header arrived (monotonic nanoseconds)
+    u64 frame_start_ns_;
+    
     // Write queue
     std::queue<std::vector<u8>> write_queue_;
     
@@ -112,6 +161,19 @@ private:
     // Last activity time
     std::chrono::steady_clock::time_point last_activity_time_;
     
+    // Compression for outgoing frames (CompressionAlgorithm), set after negotiation
+    std::atomic<u8> send_compression_;
+    
+    // Dictionary agreed with the peer (null if none), fixed after negotiation
+    std::shared_ptr<const CompressionDictionary> compression_dictionary_;
+    
+    // Compression hello handled (accepted once per session)
+    bool compression_negotiated_;
+    
+    // Delta encoding baselines per direction
+    DeltaContext send_delta_context_;
+    DeltaContext receive_delta_context_;
+    
     // Session attributes
     std::unordered_map<std::string, std::string> attributes_;
     
@@ -69,6 +69,9 @@ struct UdpServiceConfig : public NetServiceConfig {
 };
 
 // UDP service class
+//
+// The socket is polled by the service worker in updateNetworkTasks(), so
+// with thread placement enabled its IO runs on the service node.
 class NEXT_GEN_API UdpService : public NetService {
 public:
     UdpService(const std::string& name, const UdpServiceConfig& config = UdpServiceConfig());
@@ -0,0 +1,331 @@
+#ifndef NEXT_GEN_BINARY_LOG_H
+#define NEXT_GEN_BINARY_LOG_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include "../core/config.h"
+#include "error.h"
+#include "logger.h"
+#include "mapped_file.h"
+
+namespace next_gen {
+
+// Binary log segment layout (host byte order, decoded by tools/log_decoder):
+//
+//   BinaryLogFileHeader
+//   record*  := BinaryLogRecordHeader payload
+//
+// SITE records describe a call site (file, line, function, format string) and
+// are emitted once per segment before the first EVENT referencing them, so every
+// segment can be decoded on its own. EVENT records carry only the site ID and the
+// raw arguments. A record with size 0 marks the end of the written data.
+
+constexpr char BINARY_LOG_MAGIC[8] = {'N', 'G', 'B', 'L', 'O', 'G', '0', '1'};
+constexpr u16 BINARY_LOG_VERSION = 1;
+constexpr const char* BINARY_LOG_EXTENSION = ".nglog";
+
+// Record type
+enum class BinaryLogRecordType : u8 {
+    SITE = 1,
+    EVENT = 2
+};
+
+// Argument type tag
+enum class BinaryLogArgType : u8 {
+    BOOL = 1,
+    I64 = 2,
+    U64 = 3,
+    F64 = 4,
+    STRING = 5
+};
+
+// Segment file header
+struct BinaryLogFileHeader {
+    char magic[8];
+    u16 version;
+    u16 reserved;
+    u32 segment_index;
+    u64 start_time_ns;
+};
+
+// Record header
+struct BinaryLogRecordHeader {
+    u32 size;               // Total record size including this header
+    u8 type;                // BinaryLogRecordType
+    u8 level;               // LogLevel
+    u16 arg_count;          // Number of arguments (EVENT) / 0 (SITE)
+    u32 site_id;            // Call site ID
+    u32 thread_id;          // Logging thread index
+    u64 timestamp_ns;       // Nanoseconds since epoch (system clock)
+};
+
+static_assert(sizeof(BinaryLogFileHeader) == 24, "Unexpected binary log file header size");
+static_assert(sizeof(BinaryLogRecordHeader) == 24, "Unexpected binary log record header size");
+
+// Binary log configuration
+struct BinaryLogConfig {
+    std::string path = "next_gen";            // Segment base path, files are <path>.<index>.nglog
+    u64 segment_size = 64 * 1024 * 1024;      // Segment size in bytes
+    u32 max_segments = 8;                     // Segments to keep, 0 keeps all
+};
+
+namespace detail {
+
+// Argument encoding (type tag + raw value)
+template<typename T, typename Enable = void>
+struct BinaryLogArg;
+
+template<>
+struct BinaryLogArg<bool> {
+    static size_t size(bool) { return 1 + sizeof(u8); }
+    static u8* encode(u8* out, bool value) {
+        *out++ = static_cast<u8>(BinaryLogArgType::BOOL);
+        *out++ = value ? 1 : 0;
+        return out;
+    }
+};
+
+template<typename T>
+struct BinaryLogArg<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type> {
+    static size_t size(T) { return 1 + sizeof(i64); }
+    static u8* encode(u8* out, T value) {
+        i64 raw = static_cast<i64>(value);
+        *out++ = static_cast<u8>(BinaryLogArgType::I64);
+        std::memcpy(out, &raw, sizeof(raw));
+        return out + sizeof(raw);
+    }
+};
+
+template<typename T>
+struct BinaryLogArg<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                               !std::is_same<T, bool>::value>::type> {
+    static size_t size(T) { return 1 + sizeof(u64); }
+    static u8* encode(u8* out, T value) {
+        u64 raw = static_cast<u64>(value);
+        *out++ = static_cast<u8>(BinaryLogArgType::U64);
+        std::memcpy(out, &raw, sizeof(raw));
+        return out + sizeof(raw);
+    }
+};
+
+template<typename T>
+struct BinaryLogArg<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    using Underlying = typename std::underlying_type<T>::type;
+    static size_t size(T value) { return BinaryLogArg<Underlying>::size(static_cast<Underlying>(value)); }
+    static u8* encode(u8* out, T value) { return BinaryLogArg<Underlying>::encode(out, static_cast<Underlying>(value)); }
+};
+
+template<typename T>
+struct BinaryLogArg<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static size_t size(T) { return 1 + sizeof(f64); }
+    static u8* encode(u8* out, T value) {
+        f64 raw = static_cast<f64>(value);
+        *out++ = static_cast<u8>(BinaryLogArgType::F64);
+        std::memcpy(out, &raw, sizeof(raw));
+        return out + sizeof(raw);
+    }
+};
+
+inline size_t binaryLogStringSize(size_t length) {
+    return 1 + sizeof(u32) + length;
+}
+
+inline u8* binaryLogEncodeString(u8* out, const char* data, size_t length) {
+    u32 raw = static_cast<u32>(length);
+    *out++ = static_cast<u8>(BinaryLogArgType::STRING);
+    std::memcpy(out, &raw, sizeof(raw));
+    out += sizeof(raw);
+    if (length > 0) {
+        std::memcpy(out, data, length);
+    }
+    return out + length;
+}
+
+template<>
+struct BinaryLogArg<std::string> {
+    static size_t size(const std::string& value) { return binaryLogStringSize(value.size()); }
+    static u8* encode(u8* out, const std::string& value) {
+        return binaryLogEncodeString(out, value.data(), value.size());
+    }
+};
+
+template<>
+struct BinaryLogArg<const char*> {
+    static size_t size(const char* value) { return binaryLogStringSize(value ? std::strlen(value) : 0); }
+    static u8* encode(u8* out, const char* value) {
+        return binaryLogEncodeString(out, value, value ? std::strlen(value) : 0);
+    }
+};
+
+template<>
+struct BinaryLogArg<char*> : BinaryLogArg<const char*> {};
+
+template<>
+struct BinaryLogArg<std::string_view> {
+    static size_t size(std::string_view value) { return binaryLogStringSize(value.size()); }
+    static u8* encode(u8* out, std::string_view value) {
+        return binaryLogEncodeString(out, value.data(), value.size());
+    }
+};
+
+template<typename T>
+using BinaryLogArgOf = BinaryLogArg<typename std::decay<T>::type>;
+
+inline size_t binaryLogArgsSize() { return 0; }
+
+template<typename T, typename... Rest>
+size_t binaryLogArgsSize(const T& value, const Rest&... rest) {
+    return BinaryLogArgOf<T>::size(value) + binaryLogArgsSize(rest...);
+}
+
+inline u8* binaryLogEncodeArgs(u8* out) { return out; }
+
+template<typename T, typename... Rest>
+u8* binaryLogEncodeArgs(u8* out, const T& value, const Rest&... rest) {
+    out = BinaryLogArgOf<T>::encode(out, value);
+    return binaryLogEncodeArgs(out, rest...);
+}
+
+} // namespace detail
+
+// Binary logger
+//
+// Writes fixed-size record headers, call-site IDs and raw arguments into
+// memory-mapped, rotating segment files. No text formatting happens on the
+// logging thread; use tools/log_decoder to render segments as text or JSON.
+class NEXT_GEN_API BinaryLogger {
+public:
+    static BinaryLogger& instance();
+
+    // Open binary log
+    Result<void> open(const BinaryLogConfig& config = BinaryLogConfig());
+
+    // Close binary log (truncates the current segment)
+    void close();
+
+    // Check if binary log is open
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+
+    // Flush mapped pages to disk
+    void flush();
+
+    // Register call site, returns site ID
+    u32 registerSite(LogLevel level, const char* file, int line,
+                     const char* function, const char* format);
+
+    // Write event for a registered site
+    template<typename... Args>
+    void write(u32 site_id, LogLevel level, const Args&... args) {
+        writeAt(currentTimeNanos(), site_id, level, args...);
+    }
+
+    // Write event with explicit timestamp (nanoseconds since epoch)
+    template<typename... Args>
+    void writeAt(u64 timestamp_ns, u32 site_id, LogLevel level, const Args&... args) {
+        if (!isOpen()) {
+            return;
+        }
+
+        size_t payload_size = detail::binaryLogArgsSize(args...);
+        size_t record_size = sizeof(BinaryLogRecordHeader) + payload_size;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        u8* out = reserve(site_id, record_size);
+        if (!out) {
+            return;
+        }
+
+        detail::binaryLogEncodeArgs(out + sizeof(BinaryLogRecordHeader), args...);
+        commit(out, BinaryLogRecordType::EVENT, level, static_cast<u16>(sizeof...(Args)),
+               site_id, timestamp_ns, record_size);
+    }
+
+    // Get the logging thread index
+    static u32 currentThreadIndex();
+
+    // Get current time in nanoseconds since epoch
+    static u64 currentTimeNanos();
+
+private:
+    struct Site {
+        LogLevel level;
+        std::string file;
+        int line;
+        std::string function;
+        std::string format;
+    };
+
+    BinaryLogger() : open_(false), segment_index_(0), write_pos_(0) {}
+    ~BinaryLogger() { close(); }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    // Reserve space for a record, emitting the site record and rotating if needed
+    u8* reserve(u32 site_id, size_t record_size);
+
+    // Write record header (size last, so readers never see a partial record)
+    void commit(u8* out, BinaryLogRecordType type, LogLevel level, u16 arg_count,
+                u32 site_id, u64 timestamp_ns, size_t record_size);
+
+    // Emit site record into current segment
+    bool emitSite(u32 site_id);
+
+    // Open next segment and apply retention
+    Result<void> openSegment();
+
+    // Segment file path
+    std::string segmentPath(u32 index) const;
+
+    BinaryLogConfig config_;
+    std::atomic<bool> open_;
+    std::mutex mutex_;
+    MappedFile file_;
+    u32 segment_index_;
+    size_t write_pos_;
+    std::vector<bool> emitted_sites_;
+
+    std::mutex sites_mutex_;
+    std::vector<Site> sites_;
+};
+
+// Log sink adapter that routes regular Logger records into the binary log.
+// Each (file, line) becomes a site with format "{}" and the message as argument.
+class NEXT_GEN_API BinaryLogSink : public LogSink {
+public:
+    void log(const LogRecord& record) override;
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, u32> sites_;
+};
+
+} // namespace next_gen
+
+// Binary logging macros: the format string is stored once per segment and the
+// arguments are written raw. Placeholders are "{}", rendered by the decoder.
+#define NEXT_GEN_BLOG(level, format, ...) \
+    do { \
+        if ((level) >= next_gen::Logger::instance().getLevel() && \
+            next_gen::BinaryLogger::instance().isOpen()) { \
+            static const next_gen::u32 next_gen_blog_site_ = \
+                next_gen::BinaryLogger::instance().registerSite( \
+                    (level), __FILE__, __LINE__, __FUNCTION__, format); \
+            next_gen::BinaryLogger::instance().write(next_gen_blog_site_, (level), ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define NEXT_GEN_BLOG_TRACE(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::TRACE, format, ##__VA_ARGS__)
+#define NEXT_GEN_BLOG_DEBUG(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::DEBUG, format, ##__VA_ARGS__)
+#define NEXT_GEN_BLOG_INFO(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::INFO, format, ##__VA_ARGS__)
+#define NEXT_GEN_BLOG_WARNING(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::WARNING, format, ##__VA_ARGS__)
+#define NEXT_GEN_BLOG_ERROR(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::ERROR, format, ##__VA_ARGS__)
+#define NEXT_GEN_BLOG_FATAL(format, ...) NEXT_GEN_BLOG(next_gen::LogLevel::FATAL, format, ##__VA_ARGS__)
+
+#endif // NEXT_GEN_BINARY_LOG_H
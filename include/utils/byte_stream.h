@@ -0,0 +1,247 @@
+#ifndef NEXT_GEN_BYTE_STREAM_H
+#define NEXT_GEN_BYTE_STREAM_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include "../core/config.h"
+
+namespace next_gen {
+
+// Previous field values for delta-encoded messages
+//
+// One context is kept per session and direction and attached to the
+// ByteStream a message is serialized into or parsed from; TcpSession owns a
+// pair (getSendDeltaContext / getReceiveDeltaContext). A context is not
+// thread-safe, must not be shared between sessions and has to be reset
+// whenever the peer loses its baselines (e.g. after reconnect). Baselines are
+// keyed by message type, so each message is encoded against the previous
+// message of the same type. The writer sends a keyframe (full values) when
+// there is no baseline yet or every keyframe_interval messages.
+class DeltaContext {
+public:
+    // Previous values of one message type
+    struct Baseline {
+        std::vector<u64> values;
+        u32 since_keyframe = 0;
+        bool valid = false;
+    };
+
+    // keyframe_interval 0 sends a keyframe only when there is no baseline
+    explicit DeltaContext(u32 keyframe_interval = 0) : keyframe_interval_(keyframe_interval) {}
+
+    // Get baseline for a message type, invalidated if the field count changed
+    Baseline& baseline(u32 message_key, size_t field_count) {
+        Baseline& entry = baselines_[message_key];
+        if (entry.values.size() != field_count) {
+            entry.values.assign(field_count, 0);
+            entry.valid = false;
+        }
+        return entry;
+    }
+
+    // Get keyframe interval
+    u32 getKeyframeInterval() const { return keyframe_interval_; }
+
+    // Drop all baselines, next messages are keyframes (e.g. after reconnect)
+    void reset() { baselines_.clear(); }
+
+private:
+    u32 keyframe_interval_;
+    std::unordered_map<u32, Baseline> baselines_;
+};
+
+// Byte stream used by generated message serializers
+//
+// Values are written in host byte order. A stream either owns its buffer
+// (write, or read from a copied vector) or reads in place from external
+// memory such as a network receive buffer. Reads past the end set the error
+// flag and leave the destination untouched.
+class ByteStream {
+public:
+    // Empty stream for writing
+    ByteStream() : read_data_(nullptr), read_size_(0), read_pos_(0), error_(false), delta_context_(nullptr) {}
+
+    // Stream reading from a copy of data
+    explicit ByteStream(const std::vector<u8>& data)
+        : data_(data), read_data_(data_.data()), read_size_(data_.size()), read_pos_(0), error_(false),
+          delta_context_(nullptr) {}
+
+    // Stream reading in place from external memory (must outlive the stream)
+    ByteStream(const u8* data, size_t size)
+        : read_data_(data), read_size_(size), read_pos_(0), error_(false), delta_context_(nullptr) {}
+
+    ByteStream(const ByteStream&) = delete;
+    ByteStream& operator=(const ByteStream&) = delete;
+
+    // Write arithmetic value
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type write(T value) {
+        writeBytes(&value, sizeof(T));
+    }
+
+    // Write string with u16 length prefix (any allocator, e.g. std::pmr::string)
+    template<typename Alloc>
+    void write(const std::basic_string<char, std::char_traits<char>, Alloc>& value) {
+        u16 size = static_cast<u16>(value.size());
+        write(size);
+        writeBytes(value.data(), size);
+    }
+
+    // Write unsigned LEB128 varint (1-10 bytes)
+    void writeVarint(u64 value) {
+        u8 buffer[MAX_VARINT_SIZE];
+        size_t size = 0;
+        while (value >= 0x80) {
+            buffer[size++] = static_cast<u8>(value | 0x80);
+            value >>= 7;
+        }
+        buffer[size++] = static_cast<u8>(value);
+        writeBytes(buffer, size);
+    }
+
+    // Write raw bytes
+    void writeBytes(const void* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        size_t offset = data_.size();
+        data_.resize(offset + size);
+        std::memcpy(data_.data() + offset, data, size);
+        read_data_ = data_.data();
+        read_size_ = data_.size();
+    }
+
+    // Read arithmetic value
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type read(T& value) {
+        readBytes(&value, sizeof(T));
+    }
+
+    // Read string with u16 length prefix
+    template<typename Alloc>
+    void read(std::basic_string<char, std::char_traits<char>, Alloc>& value) {
+        u16 size = 0;
+        read(size);
+        const u8* data = readView(size);
+        if (data) {
+            value.assign(reinterpret_cast<const char*>(data), size);
+        }
+    }
+
+    // Read unsigned LEB128 varint
+    bool readVarint(u64& value) {
+        u64 result = 0;
+        for (size_t i = 0; i < MAX_VARINT_SIZE; ++i) {
+            const u8* byte = readView(1);
+            if (!byte) {
+                return false;
+            }
+            result |= static_cast<u64>(*byte & 0x7F) << (7 * i);
+            if ((*byte & 0x80) == 0) {
+                value = result;
+                return true;
+            }
+        }
+        error_ = true;
+        return false;
+    }
+
+    // Get encoded size of a varint
+    static size_t varintSize(u64 value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    // Read raw bytes
+    bool readBytes(void* data, size_t size) {
+        const u8* source = readView(size);
+        if (!source) {
+            return false;
+        }
+        if (size > 0) {
+            std::memcpy(data, source, size);
+        }
+        return true;
+    }
+
+    // Consume size bytes and return a pointer to them without copying, or
+    // nullptr if not enough data remains. The pointer is valid as long as the
+    // underlying buffer is.
+    const u8* readView(size_t size) {
+        if (error_ || size > read_size_ - read_pos_) {
+            error_ = true;
+            return nullptr;
+        }
+        const u8* data = read_data_ + read_pos_;
+        read_pos_ += size;
+        return data;
+    }
+
+    // Overwrite previously written bytes (e.g. a length placeholder)
+    void patchBytes(size_t offset, const void* data, size_t size) {
+        if (offset + size <= data_.size()) {
+            std::memcpy(data_.data() + offset, data, size);
+        }
+    }
+
+    // Skip bytes on read
+    bool skip(size_t size) { return readView(size) != nullptr; }
+
+    // Reserve write capacity
+    void reserve(size_t size) { data_.reserve(size); }
+
+    // Get written data
+    const std::vector<u8>& getData() const { return data_; }
+
+    // Take written data
+    std::vector<u8> releaseData() {
+        read_data_ = nullptr;
+        read_size_ = 0;
+        read_pos_ = 0;
+        return std::move(data_);
+    }
+
+    // Get bytes left to read
+    size_t remaining() const { return read_size_ - read_pos_; }
+
+    // Get read position
+    size_t getReadPosition() const { return read_pos_; }
+
+    // Get write position (bytes written so far)
+    size_t getWritePosition() const { return data_.size(); }
+
+    // Check if a read ran past the end or hit malformed data
+    bool hasError() const { return error_; }
+
+    // Mark stream as failed (malformed data)
+    void setError() { error_ = true; }
+
+    // Attach delta context used by delta-encoded fields (not owned)
+    void setDeltaContext(DeltaContext* context) { delta_context_ = context; }
+
+    // Get attached delta context, nullptr if none
+    DeltaContext* getDeltaContext() const { return delta_context_; }
+
+    // Maximum encoded size of a 64-bit varint
+    static constexpr size_t MAX_VARINT_SIZE = 10;
+
+private:
+    std::vector<u8> data_;
+    const u8* read_data_;
+    size_t read_size_;
+    size_t read_pos_;
+    bool error_;
+    DeltaContext* delta_context_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_BYTE_STREAM_H
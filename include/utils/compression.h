@@ -0,0 +1,104 @@
+#ifndef NEXT_GEN_COMPRESSION_H
+#define NEXT_GEN_COMPRESSION_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "../core/config.h"
+#include "error.h"
+
+namespace next_gen {
+
+// Compression algorithm (value is also the frame flag and the negotiation mask bit)
+enum class CompressionAlgorithm : u8 {
+    NONE = 0,
+    LZ4 = 1,        // In-tree LZ4 block format, always available
+    ZSTD = 2        // Requires a build with NEXT_GEN_HAS_ZSTD
+};
+
+// Bit for an algorithm in a negotiation mask
+constexpr u8 compressionMaskBit(CompressionAlgorithm algorithm) {
+    return static_cast<u8>(1u << static_cast<u8>(algorithm));
+}
+
+// Raw-content dictionary shared by both peers.
+// Small repetitive messages compress poorly on their own; with a dictionary
+// trained on captured traffic, matches can reference the dictionary content.
+class NEXT_GEN_API CompressionDictionary {
+public:
+    // Maximum dictionary size (LZ4 match window)
+    static constexpr size_t MAX_SIZE = 64 * 1024;
+
+    // Create dictionary from content (truncated to the last MAX_SIZE bytes)
+    static std::shared_ptr<const CompressionDictionary> create(std::vector<u8> content);
+
+    // Load dictionary content from file
+    static Result<std::shared_ptr<const CompressionDictionary>> loadFromFile(const std::string& path);
+
+    // Save dictionary content to file
+    Result<void> saveToFile(const std::string& path) const;
+
+    // Dictionary ID (hash of the content, never 0), exchanged during negotiation
+    u32 getId() const { return id_; }
+
+    // Dictionary content
+    const std::vector<u8>& getContent() const { return content_; }
+
+private:
+    friend class Compression;
+
+    CompressionDictionary() : id_(0) {}
+
+    std::vector<u8> content_;
+    u32 id_;
+
+    // LZ4 hash table over the content, copied into each compression call
+    std::vector<u32> lz4_table_;
+
+    // Digested zstd dictionaries (ZSTD_CDict / ZSTD_DDict), empty without zstd
+    std::shared_ptr<void> zstd_cdict_;
+    std::shared_ptr<void> zstd_ddict_;
+};
+
+// Block compression used by the frame layer
+class NEXT_GEN_API Compression {
+public:
+    // Check if algorithm is available in this build
+    static bool isAvailable(CompressionAlgorithm algorithm);
+
+    // Mask of available algorithms
+    static u8 availableMask();
+
+    // Maximum compressed size for input of the given size
+    static size_t compressBound(CompressionAlgorithm algorithm, size_t size);
+
+    // Compress src into dst. Returns the compressed size, or 0 if the output
+    // does not fit in capacity (pass capacity < size to keep only useful results)
+    static size_t compress(CompressionAlgorithm algorithm, const u8* src, size_t size,
+                           u8* dst, size_t capacity,
+                           const CompressionDictionary* dictionary = nullptr, int level = 0);
+
+    // Decompress src into dst, which must be exactly original_size bytes
+    static bool decompress(CompressionAlgorithm algorithm, const u8* src, size_t size,
+                           u8* dst, size_t original_size,
+                           const CompressionDictionary* dictionary = nullptr);
+
+    // Train a dictionary from sample messages (frame bodies).
+    // Picks the segments whose substrings occur in the most samples; the most
+    // common segments are placed at the end, closest to the compressed data.
+    static std::shared_ptr<const CompressionDictionary> trainDictionary(
+        const std::vector<std::vector<u8>>& samples, size_t max_size = 16 * 1024);
+};
+
+// Frame compression configuration
+struct CompressionConfig {
+    CompressionAlgorithm algorithm = CompressionAlgorithm::NONE;   // Preferred algorithm, NONE disables
+    u32 threshold = 512;                                           // Minimum body size to compress
+    int level = 0;                                                 // Algorithm level (zstd), 0 for default
+    u32 max_decompressed_size = 16 * 1024 * 1024;                  // Reject frames that expand beyond this
+    std::shared_ptr<const CompressionDictionary> dictionary;       // Optional shared dictionary
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_COMPRESSION_H
@@ -5,6 +5,10 @@
 #include <exception>
 #include <system_error>
 #include <memory>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <type_traits>
 #include "../core/config.h"
 
 namespace next_gen {
@@ -38,6 +42,7 @@ enum class ErrorCode {
     SERVICE_ALREADY_EXISTS,
     SERVICE_NOT_STARTED,
     SERVICE_ALREADY_STARTED,
+    SERVICE_OVERLOADED,
     
     // Session errors
     SESSION_ERROR,
@@ -49,7 +54,8 @@ enum class ErrorCode {
     MODULE_ERROR,
     MODULE_NOT_FOUND,
     MODULE_ALREADY_EXISTS,
-    MODULE_INITIALIZATION_FAILED
+    MODULE_INITIALIZATION_FAILED,
+    CIRCULAR_DEPENDENCY
 };
 
 // Error category
@@ -84,6 +90,7 @@ public:
             case ErrorCode::SERVICE_ALREADY_EXISTS: return "Service already exists";
             case ErrorCode::SERVICE_NOT_STARTED: return "Service not started";
             case ErrorCode::SERVICE_ALREADY_STARTED: return "Service already started";
+            case ErrorCode::SERVICE_OVERLOADED: return "Service overloaded";
             case ErrorCode::SESSION_ERROR: return "Session error";
             case ErrorCode::SESSION_NOT_FOUND: return "Session not found";
             case ErrorCode::SESSION_ALREADY_EXISTS: return "Session already exists";
@@ -92,6 +99,7 @@ public:
             case ErrorCode::MODULE_NOT_FOUND: return "Module not found";
             case ErrorCode::MODULE_ALREADY_EXISTS: return "Module already exists";
             case ErrorCode::MODULE_INITIALIZATION_FAILED: return "Module initialization failed";
+            case ErrorCode::CIRCULAR_DEPENDENCY: return "Circular dependency";
             default: return "Unknown error code";
         }
     }
@@ -121,55 +129,196 @@ public:
     }
 };
 
-// Result template class for returning value or error
+namespace detail {
+
+// Error state shared by Result<T> and Result<void>: the error code plus an
+// optional message. Nothing is allocated on success, the Error object itself is
+// only built when error() is called. Building it is thread-safe, so a const
+// Result may be shared between threads (e.g. through a shared future).
+class ResultError {
+public:
+    ResultError() : code_(ErrorCode::SUCCESS), failed_(false), error_(nullptr) {}
+    
+    explicit ResultError(ErrorCode code) : code_(code), failed_(true), error_(nullptr) {}
+    
+    ResultError(ErrorCode code, const std::string& message)
+        : code_(code), failed_(true), message_(new std::string(message)), error_(nullptr) {}
+    
+    explicit ResultError(const Error& error)
+        : code_(error.code()), failed_(true), error_(new Error(error)) {}
+    
+    ResultError(const ResultError& other)
+        : code_(other.code_), failed_(other.failed_),
+          message_(other.message_ ? new std::string(*other.message_) : nullptr),
+          error_(nullptr) {
+        const Error* error = other.error_.load(std::memory_order_acquire);
+        if (error) {
+            error_.store(new Error(*error), std::memory_order_relaxed);
+        }
+    }
+    
+    ResultError(ResultError&& other) noexcept
+        : code_(other.code_), failed_(other.failed_),
+          message_(std::move(other.message_)),
+          error_(other.error_.exchange(nullptr, std::memory_order_acq_rel)) {}
+    
+    ~ResultError() { delete error_.load(std::memory_order_acquire); }
+    
+    ResultError& operator=(const ResultError& other) {
+        if (this != &other) {
+            ResultError copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    
+    ResultError& operator=(ResultError&& other) noexcept {
+        if (this != &other) {
+            ResultError moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+    
+    // Check if this is an error
+    bool failed() const { return failed_; }
+    
+    // Get error code
+    ErrorCode code() const { return code_; }
+    
+    // Get error, built on first use (concurrent callers agree on one instance)
+    const Error& error() const {
+        if (!failed_) {
+            static const Error success(ErrorCode::SUCCESS);
+            return success;
+        }
+        const Error* error = error_.load(std::memory_order_acquire);
+        if (error) {
+            return *error;
+        }
+        const Error* built = message_ ? new Error(code_, *message_) : new Error(code_);
+        if (error_.compare_exchange_strong(error, built, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return *built;
+        }
+        delete built;
+        return *error;
+    }
+    
+private:
+    void swap(ResultError& other) noexcept {
+        std::swap(code_, other.code_);
+        std::swap(failed_, other.failed_);
+        message_.swap(other.message_);
+        const Error* error = error_.load(std::memory_order_relaxed);
+        error_.store(other.error_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.error_.store(error, std::memory_order_relaxed);
+    }
+    
+    ErrorCode code_;
+    bool failed_;
+    std::unique_ptr<std::string> message_;
+    mutable std::atomic<const Error*> error_;
+};
+
+} // namespace detail
+
+// Result template class for returning value or error.
+// The value is stored in place; success paths never allocate.
 template<typename T>
 class Result {
 public:
     // Success constructor
-    Result(const T& value) : value_(new T(value)), has_error_(false) {}
-    Result(T&& value) : value_(new T(std::move(value))), has_error_(false) {}
+    Result(const T& value) { new (&value_) T(value); }
+    Result(T&& value) { new (&value_) T(std::move(value)); }
     
     // Error constructor
-    Result(ErrorCode code, const std::string& what_arg)
-        : error_(std::make_unique<Error>(code, what_arg)), has_error_(true), value_(nullptr) {}
+    Result(ErrorCode code, const std::string& what_arg) : error_(code, what_arg) {}
+    
+    Result(ErrorCode code) : error_(code) {}
+    
+    Result(const Error& error) : error_(error) {}
+    
+    Result(const Result& other) : error_(other.error_) {
+        if (!has_error()) {
+            new (&value_) T(other.value_);
+        }
+    }
+    
+    Result(Result&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : error_(std::move(other.error_)) {
+        if (!has_error()) {
+            new (&value_) T(std::move(other.value_));
+        }
+    }
+    
+    // Copy first, so a throwing copy leaves this result unchanged
+    Result& operator=(const Result& other) {
+        if (this != &other) {
+            Result copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
     
-    Result(ErrorCode code)
-        : error_(std::make_unique<Error>(code)), has_error_(true), value_(nullptr) {}
+    Result& operator=(Result&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            destroy();
+            if (!other.has_error()) {
+                // Holds no value until the move completes, so a throwing
+                // move never leaves a destroyed value marked as present
+                error_ = detail::ResultError(ErrorCode::UNKNOWN_ERROR);
+                new (&value_) T(std::move(other.value_));
+            }
+            error_ = std::move(other.error_);
+        }
+        return *this;
+    }
     
-    Result(const Error& error)
-        : error_(std::make_unique<Error>(error.code(), error.what())), has_error_(true), value_(nullptr) {}
+    ~Result() { destroy(); }
     
     // Check if has error
-    bool has_error() const { return has_error_; }
+    bool has_error() const { return error_.failed(); }
+    
+    // Get error code (SUCCESS if no error)
+    ErrorCode code() const { return error_.code(); }
     
     // Get value, throw exception if has error
-    const T& value() const {
-        if (has_error_) {
-            throw *error_;
+    const T& value() const & {
+        if (has_error()) {
+            throw error();
         }
-        return *value_;
+        return value_;
     }
     
-    T& value() {
-        if (has_error_) {
-            throw *error_;
+    T& value() & {
+        if (has_error()) {
+            throw error();
         }
-        return *value_;
+        return value_;
     }
     
-    // Get error, return success if no error
-    const Error& error() const {
-        if (!has_error_) {
-            static const Error success(ErrorCode::SUCCESS);
-            return success;
+    // Move value out of a temporary or moved result
+    T&& value() && {
+        if (has_error()) {
+            throw error();
         }
-        return *error_;
+        return std::move(value_);
     }
     
+    // Get error, return success if no error
+    const Error& error() const { return error_.error(); }
+    
 private:
-    std::unique_ptr<T> value_;
-    std::unique_ptr<Error> error_;
-    bool has_error_;
+    void destroy() {
+        if (!has_error()) {
+            value_.~T();
+        }
+    }
+    
+    union {
+        T value_;
+    };
+    detail::ResultError error_;
 };
 
 // Specialized void result class for operations that don't return a value
@@ -177,33 +326,26 @@ template<>
 class Result<void> {
 public:
     // Success constructor
-    Result() : has_error_(false) {}
+    Result() {}
     
     // Error constructor
-    Result(ErrorCode code, const std::string& what_arg)
-        : error_(std::make_unique<Error>(code, what_arg)), has_error_(true) {}
+    Result(ErrorCode code, const std::string& what_arg) : error_(code, what_arg) {}
     
-    Result(ErrorCode code)
-        : error_(std::make_unique<Error>(code)), has_error_(true) {}
+    Result(ErrorCode code) : error_(code) {}
     
-    Result(const Error& error)
-        : error_(std::make_unique<Error>(error.code(), error.what())), has_error_(true) {}
+    Result(const Error& error) : error_(error) {}
     
     // Check if has error
-    bool has_error() const { return has_error_; }
+    bool has_error() const { return error_.failed(); }
+    
+    // Get error code (SUCCESS if no error)
+    ErrorCode code() const { return error_.code(); }
     
     // Get error, return success if no error
-    const Error& error() const {
-        if (!has_error_) {
-            static const Error success(ErrorCode::SUCCESS);
-            return success;
-        }
-        return *error_;
-    }
+    const Error& error() const { return error_.error(); }
     
 private:
-    std::unique_ptr<Error> error_;
-    bool has_error_;
+    detail::ResultError error_;
 };
 
 } // namespace next_gen
@@ -12,6 +12,9 @@
 #include <iomanip>
 #include <functional>
 #include <thread>
+#include <deque>
+#include <condition_variable>
+#include <atomic>
 #include "../core/config.h"
 
 namespace next_gen {
@@ -63,17 +66,50 @@ public:
     void log(const LogRecord& record) override;
 };
 
+// File log sink rotation options
+struct FileSinkConfig {
+    u64 max_file_size = 0;          // Rotate when file reaches this size in bytes, 0 disables
+    u64 rotate_interval_ms = 0;     // Rotate after this interval, 0 disables
+    u32 max_files = 0;              // Rotated files to keep, 0 keeps all
+    bool compress = true;           // Gzip rotated files in background (requires zlib)
+};
+
 // File log sink
 class FileSink : public LogSink {
 public:
-    FileSink(const std::string& filename);
+    FileSink(const std::string& filename, const FileSinkConfig& config = FileSinkConfig());
     ~FileSink();
     
     void log(const LogRecord& record) override;
     
 private:
+    // Check if the next write of the given size needs a rotation
+    bool needsRotation(size_t next_write_size) const;
+    
+    // Rename current file and reopen (called by the writer)
+    void rotate();
+    
+    // Background compression and retention
+    void backgroundWorker();
+    
+    // Compress file, returns true on success
+    bool compressFile(const std::string& path);
+    
+    // Remove rotated files beyond max_files
+    void applyRetention();
+    
     std::string filename_;
     std::ofstream file_;
+    FileSinkConfig config_;
+    u64 current_size_;
+    std::chrono::steady_clock::time_point opened_at_;
+    u32 rotation_seq_;
+    
+    std::thread worker_thread_;
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    std::deque<std::string> rotated_files_;
+    bool stopping_;
 };
 
 // Logger manager
@@ -87,6 +123,9 @@ public:
     // Initialize logger with file
     void init(const std::string& filename, LogLevel level = LogLevel::INFO);
     
+    // Initialize logger with file rotation options
+    void init(const std::string& filename, const FileSinkConfig& config, LogLevel level = LogLevel::INFO);
+    
     // Set log level
     void setLevel(LogLevel level);
     
@@ -123,6 +162,9 @@ public:
                const std::string& file = "", int line = 0, 
                const std::string& function = "");
     
+    // Report suppressed counts still pending in rate limited call sites
+    void flush();
+    
 private:
     Logger() {
         // Add console sink by default
@@ -139,6 +181,44 @@ private:
     LogLevel level_;
 };
 
+// Per-call-site log rate limiter, one static instance per macro expansion.
+// Suppressed records are counted and reported with the next emitted record;
+// counts left when a call site goes quiet are reported by Logger::flush() and
+// when the limiter is destroyed at shutdown.
+class NEXT_GEN_API LogRateLimiter {
+public:
+    LogRateLimiter(LogLevel level, const char* file, int line, const char* function);
+    ~LogRateLimiter();
+    
+    LogRateLimiter(const LogRateLimiter&) = delete;
+    LogRateLimiter& operator=(const LogRateLimiter&) = delete;
+    
+    // Allow at most per_second records in each one second window
+    bool allowPerSecond(u32 per_second, u64& suppressed);
+    
+    // Allow the first of every n records
+    bool allowEveryN(u32 n, u64& suppressed);
+    
+    // Append suppressed-count summary to message
+    static std::string withSummary(const std::string& message, u64 suppressed);
+    
+    // Emit an "N messages suppressed" record for every call site with a pending count
+    static void flushAll();
+    
+private:
+    // Emit the pending count of this call site, if any
+    void reportSuppressed();
+    
+    LogLevel level_;
+    const char* file_;
+    int line_;
+    const char* function_;
+    std::atomic<i64> window_start_ms_;
+    std::atomic<u32> window_count_;
+    std::atomic<u64> counter_;
+    std::atomic<u64> suppressed_;
+};
+
 } // namespace next_gen
 
 // Convenience logging macros
@@ -160,4 +240,53 @@ private:
 #define NEXT_GEN_LOG_FATAL(message) \
     next_gen::Logger::instance().fatal(message, __FILE__, __LINE__, __FUNCTION__)
 
+// Rate limited logging: at most per_second records per call site, the message
+// expression is not evaluated for suppressed records
+#define NEXT_GEN_LOG_LIMITED(level, message, per_second) \
+    do { \
+        if ((level) >= next_gen::Logger::instance().getLevel()) { \
+            static next_gen::LogRateLimiter next_gen_log_limiter_( \
+                (level), __FILE__, __LINE__, __FUNCTION__); \
+            next_gen::u64 next_gen_log_suppressed_ = 0; \
+            if (next_gen_log_limiter_.allowPerSecond((per_second), next_gen_log_suppressed_)) { \
+                next_gen::Logger::instance().log((level), \
+                    next_gen::LogRateLimiter::withSummary((message), next_gen_log_suppressed_), \
+                    __FILE__, __LINE__, __FUNCTION__); \
+            } \
+        } \
+    } while (0)
+
+// Sampled logging: first of every n records per call site
+#define NEXT_GEN_LOG_EVERY_N(level, message, n) \
+    do { \
+        if ((level) >= next_gen::Logger::instance().getLevel()) { \
+            static next_gen::LogRateLimiter next_gen_log_limiter_( \
+                (level), __FILE__, __LINE__, __FUNCTION__); \
+            next_gen::u64 next_gen_log_suppressed_ = 0; \
+            if (next_gen_log_limiter_.allowEveryN((n), next_gen_log_suppressed_)) { \
+                next_gen::Logger::instance().log((level), \
+                    next_gen::LogRateLimiter::withSummary((message), next_gen_log_suppressed_), \
+                    __FILE__, __LINE__, __FUNCTION__); \
+            } \
+        } \
+    } while (0)
+
+#define NEXT_GEN_LOG_DEBUG_LIMITED(message, per_second) \
+    NEXT_GEN_LOG_LIMITED(next_gen::LogLevel::DEBUG, message, per_second)
+#define NEXT_GEN_LOG_INFO_LIMITED(message, per_second) \
+    NEXT_GEN_LOG_LIMITED(next_gen::LogLevel::INFO, message, per_second)
+#define NEXT_GEN_LOG_WARNING_LIMITED(message, per_second) \
+    NEXT_GEN_LOG_LIMITED(next_gen::LogLevel::WARNING, message, per_second)
+#define NEXT_GEN_LOG_ERROR_LIMITED(message, per_second) \
+    NEXT_GEN_LOG_LIMITED(next_gen::LogLevel::ERROR, message, per_second)
+
+#define NEXT_GEN_LOG_DEBUG_EVERY_N(message, n) \
+    NEXT_GEN_LOG_EVERY_N(next_gen::LogLevel::DEBUG, message, n)
+#define NEXT_GEN_LOG_INFO_EVERY_N(message, n) \
+    NEXT_GEN_LOG_EVERY_N(next_gen::LogLevel::INFO, message, n)
+#define NEXT_GEN_LOG_WARNING_EVERY_N(message, n) \
+    NEXT_GEN_LOG_EVERY_N(next_gen::LogLevel::WARNING, message, n)
+#define NEXT_GEN_LOG_ERROR_EVERY_N(message, n) \
+    NEXT_GEN_LOG_EVERY_N(next_gen::LogLevel::ERROR, message, n)
+
 #endif // NEXT_GEN_LOGGER_H
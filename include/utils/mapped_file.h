@@ -0,0 +1,61 @@
+#ifndef NEXT_GEN_MAPPED_FILE_H
+#define NEXT_GEN_MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include "../core/config.h"
+#include "error.h"
+
+namespace next_gen {
+
+// Memory-mapped file used by the binary writers (binary log, frame capture)
+class NEXT_GEN_API MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Create (or truncate) file with the given size and map it read-write
+    Result<void> create(const std::string& path, size_t size);
+
+    // Map an existing file read-only
+    Result<void> openReadOnly(const std::string& path);
+
+    // Flush dirty pages to disk (asynchronous flush if async is true)
+    void flush(bool async = true);
+
+    // Unmap and close file, truncating it to final_size if specified
+    void close(size_t final_size = static_cast<size_t>(-1));
+
+    // Check if file is mapped
+    bool isOpen() const { return data_ != nullptr; }
+
+    // Get mapped memory
+    u8* data() { return data_; }
+    const u8* data() const { return data_; }
+
+    // Get mapped size
+    size_t size() const { return size_; }
+
+    // Get file path
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    u8* data_;
+    size_t size_;
+    bool writable_;
+
+#ifdef NEXT_GEN_PLATFORM_WINDOWS
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_MAPPED_FILE_H
@@ -0,0 +1,196 @@
+#ifndef NEXT_GEN_METRICS_H
+#define NEXT_GEN_METRICS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include "../core/config.h"
+#include "error.h"
+
+namespace next_gen {
+
+// Metric labels, exported in the given order
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Metric type
+enum class MetricType {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+// Monotonic clock in nanoseconds, used for latency measurements
+inline u64 metricsNowNanos() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Monotonic counter sharded per thread, each shard on its own cache line
+class NEXT_GEN_API Counter {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    // Increment counter
+    void inc(u64 n = 1) {
+        shards_[shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Get counter value (sum of all shards)
+    u64 value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<u64> value{0};
+    };
+
+    // Shard of the calling thread
+    static size_t shardIndex();
+
+    Shard shards_[SHARD_COUNT];
+};
+
+// Gauge holding the last set value
+class NEXT_GEN_API Gauge {
+public:
+    Gauge() : value_(0) {}
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    // Set gauge value
+    void set(i64 value) { value_.store(value, std::memory_order_relaxed); }
+
+    // Increment gauge
+    void inc(i64 n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+
+    // Decrement gauge
+    void dec(i64 n = 1) { value_.fetch_sub(n, std::memory_order_relaxed); }
+
+    // Get gauge value
+    i64 value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<i64> value_;
+};
+
+// Latency histogram with HDR-style log-linear buckets.
+// Values below 16 are exact, above that each power of two is split into 16
+// sub-buckets, giving a relative error below 6.25% over the full u64 range.
+// Values are recorded in nanoseconds and exported in seconds.
+class NEXT_GEN_API Histogram {
+public:
+    static constexpr u32 SUB_BUCKET_BITS = 4;
+    static constexpr u32 SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr u32 BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    Histogram();
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    // Record value
+    void record(u64 value) {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        u64 max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Get number of recorded values
+    u64 count() const { return count_.load(std::memory_order_relaxed); }
+
+    // Get sum of recorded values
+    u64 sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    // Get largest recorded value
+    u64 max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Get value at quantile (0.0 - 1.0), upper bound of the matching bucket
+    u64 percentile(f64 quantile) const;
+
+    // Reset histogram
+    void reset();
+
+    // Bucket index of value
+    static u32 bucketIndex(u64 value);
+
+    // Largest value mapped to bucket
+    static u64 bucketUpperBound(u32 index);
+
+private:
+    std::atomic<u64> buckets_[BUCKET_COUNT];
+    std::atomic<u64> count_;
+    std::atomic<u64> sum_;
+    std::atomic<u64> max_;
+};
+
+// Metrics registry
+//
+// Metrics are created once and looked up by callers at setup time; the returned
+// references stay valid for the lifetime of the process, so hot paths only touch
+// the metric itself.
+class NEXT_GEN_API MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    // Get or create counter
+    Counter& counter(const std::string& name, const std::string& help,
+                     const MetricLabels& labels = MetricLabels());
+
+    // Get or create gauge
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const MetricLabels& labels = MetricLabels());
+
+    // Get or create histogram
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const MetricLabels& labels = MetricLabels());
+
+    // Export snapshot of all metrics in Prometheus text format
+    std::string exportPrometheus() const;
+
+    // Write Prometheus snapshot to file (written to a temporary file, then renamed)
+    Result<void> exportToFile(const std::string& path) const;
+
+private:
+    struct Family {
+        std::string help;
+        MetricType type;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    MetricsRegistry() = default;
+    ~MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // Get family, nullptr if registered with another type
+    Family* getFamily(const std::string& name, const std::string& help, MetricType type);
+
+    // Format labels as {k="v",...}
+    static std::string formatLabels(const MetricLabels& labels);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+
+    // Detached metrics returned on type conflicts, never exported
+    std::vector<std::unique_ptr<Counter>> detached_counters_;
+    std::vector<std::unique_ptr<Gauge>> detached_gauges_;
+    std::vector<std::unique_ptr<Histogram>> detached_histograms_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_METRICS_H
@@ -0,0 +1,142 @@
+#ifndef NEXT_GEN_THREAD_PLACEMENT_H
+#define NEXT_GEN_THREAD_PLACEMENT_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include "../core/config.h"
+#include "error.h"
+
+namespace next_gen {
+
+// Pinning of the framework threads
+enum class ThreadPinning : u8 {
+    NONE,       // Threads run on any CPU (default)
+    NODE,       // Threads run on any CPU of their NUMA node
+    CORE        // Each thread gets one CPU of its node, assigned round-robin
+};
+
+// NUMA node with the CPUs this process may use
+struct NumaNode {
+    u32 id;                     // Operating system node ID
+    std::vector<u32> cpus;
+};
+
+// CPU topology
+struct CpuTopology {
+    std::vector<NumaNode> nodes;        // Nodes without usable CPUs are left out
+    bool simulated = false;             // From ThreadPlacementConfig::topology
+
+    size_t cpuCount() const {
+        size_t count = 0;
+        for (const auto& node : nodes) {
+            count += node.cpus.size();
+        }
+        return count;
+    }
+};
+
+// Thread placement configuration
+struct ThreadPlacementConfig {
+    ThreadPinning pinning = ThreadPinning::NONE;
+
+    // Simulated topology: nodes as Linux CPU lists separated by ';', e.g.
+    // "0-1;2-3". Empty = detect from sysfs. Both are restricted to the CPUs
+    // of the process cpuset, so a cgroup or taskset shapes the topology.
+    std::string topology;
+
+    // Node index of a service (its worker and IO threads), others are
+    // assigned round-robin in start order
+    std::unordered_map<std::string, u32> service_nodes;
+
+    // Node index of the timer thread
+    u32 timer_node = 0;
+
+    // Move preallocated queue buffers to the node of the consuming service
+    bool bind_queue_memory = true;
+};
+
+// Pinned thread
+struct ThreadPlacementRecord {
+    std::string thread;         // "service:<name>", "io:<name>" or "timer"
+    u32 node;                   // Node index in the topology
+    std::vector<u32> cpus;
+};
+
+// Thread placement
+//
+// Services are assigned a NUMA node when they start. The service worker,
+// the IO threads of network services and the queue buffers the worker
+// consumes are placed on that node, so a session's IO and its handling
+// stay on one socket. Configure before starting the timer manager and the
+// services; threads already running keep their affinity.
+class NEXT_GEN_API ThreadPlacement {
+public:
+    static ThreadPlacement& instance();
+
+    // Apply a configuration and resolve the topology
+    Result<void> configure(const ThreadPlacementConfig& config);
+
+    // Check if threads are pinned
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    // Check if queue buffers are bound to their consumer's node
+    bool bindsQueueMemory() const;
+
+    // Get the resolved topology
+    CpuTopology getTopology() const;
+
+    // Get the node index of a service, stable once assigned
+    u32 assignServiceNode(const std::string& service_name);
+
+    // Get the node index of the timer thread
+    u32 getTimerNode() const;
+
+    // Pin the calling thread to a node (no-op when disabled)
+    Result<void> pinCurrentThread(u32 node, const std::string& thread_name);
+
+    // Bind memory to a node, pages already touched are migrated (Linux,
+    // no-op for simulated topologies). Only pages lying wholly inside the
+    // range are bound, so neighbouring allocations are never moved.
+    Result<void> bindMemory(void* address, size_t size, u32 node) const;
+
+    // Allocate zeroed memory on whole pages of its own, so bindMemory()
+    // covers all of it
+    static void* allocatePages(size_t size);
+
+    // Free memory from allocatePages (same size)
+    static void freePages(void* address, size_t size);
+
+    // Get the threads pinned so far
+    std::vector<ThreadPlacementRecord> getPlacements() const;
+
+    // Detect the NUMA nodes of this machine
+    static CpuTopology detectTopology();
+
+    // Parse a simulated topology ("0-1;2-3")
+    static Result<CpuTopology> parseTopology(const std::string& description);
+
+    // Parse a Linux CPU list ("0-3,8,10-11")
+    static Result<std::vector<u32>> parseCpuList(const std::string& list);
+
+private:
+    ThreadPlacement() : enabled_(false), next_service_node_(0) {}
+
+    ThreadPlacement(const ThreadPlacement&) = delete;
+    ThreadPlacement& operator=(const ThreadPlacement&) = delete;
+
+    ThreadPlacementConfig config_;
+    CpuTopology topology_;
+    std::atomic<bool> enabled_;
+    u32 next_service_node_;
+    std::unordered_map<std::string, u32> service_nodes_;
+    std::vector<u32> next_core_;                // Round-robin CPU per node (CORE)
+    std::vector<ThreadPlacementRecord> placements_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_THREAD_PLACEMENT_H
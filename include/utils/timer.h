@@ -46,6 +46,9 @@ public:
     // Stop timer manager
     void stop();
     
+    // Check if the timer thread is running
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+    
     // Create one-time timer
     TimerId createOnce(u64 delay_ms, std::function<void()> callback);
     
@@ -0,0 +1,90 @@
+#ifndef NEXT_GEN_TIMER_WHEEL_H
+#define NEXT_GEN_TIMER_WHEEL_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "../core/config.h"
+
+namespace next_gen {
+
+// Hashed timer wheel
+//
+// Single-threaded wheel of fixed-resolution slots holding (id, due time)
+// pairs in flat vectors. advance() only visits the slots that passed since
+// the previous call; entries due in a later revolution stay in their slot.
+// Intended for owners that tick from their own loop (e.g. a service worker),
+// it does no locking and no cancellation: owners validate ids on expiry.
+class NEXT_GEN_API TimerWheel {
+public:
+    static constexpr u64 NEVER = std::numeric_limits<u64>::max();
+
+    TimerWheel(u32 resolution_ms = 10, u32 slot_count = 256);
+
+    // Schedule id at an absolute time in milliseconds
+    void schedule(u32 id, u64 due_ms);
+
+    // Expire everything due at or before now_ms, calls fn(id, due_ms)
+    template<typename Fn>
+    void advance(u64 now_ms, Fn&& fn) {
+        if (now_ms < next_due_ms_) {
+            return;
+        }
+
+        u64 now_tick = std::max(now_ms / resolution_ms_, current_tick_);
+        u64 ticks = now_tick - current_tick_ + 1;
+        if (ticks > slots_.size()) {
+            ticks = slots_.size();
+        }
+
+        for (u64 i = 0; i < ticks; ++i) {
+            auto& slot = slots_[(current_tick_ + i) % slots_.size()];
+            size_t kept = 0;
+            for (size_t j = 0; j < slot.size(); ++j) {
+                if (slot[j].due_ms <= now_ms) {
+                    expired_.push_back(slot[j]);
+                } else {
+                    slot[kept++] = slot[j];
+                }
+            }
+            slot.resize(kept);
+        }
+        current_tick_ = now_tick;
+        size_ -= expired_.size();
+        updateNextDue();
+
+        // Callbacks may schedule again, expire from a separate buffer
+        for (size_t i = 0; i < expired_.size(); ++i) {
+            fn(expired_[i].id, expired_[i].due_ms);
+        }
+        expired_.clear();
+    }
+
+    // Earliest due time, NEVER when empty
+    u64 nextDue() const { return next_due_ms_; }
+
+    // Number of scheduled entries
+    size_t size() const { return size_; }
+
+    // Remove all entries
+    void clear();
+
+private:
+    struct Entry {
+        u64 due_ms;
+        u32 id;
+    };
+
+    void updateNextDue();
+
+    u32 resolution_ms_;
+    std::vector<std::vector<Entry>> slots_;
+    std::vector<Entry> expired_;
+    u64 current_tick_;
+    u64 next_due_ms_;
+    size_t size_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_TIMER_WHEEL_H
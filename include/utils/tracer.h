@@ -0,0 +1,118 @@
+#ifndef NEXT_GEN_TRACER_H
+#define NEXT_GEN_TRACER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <condition_variable>
+#include "../core/config.h"
+#include "error.h"
+#include "metrics.h"
+
+namespace next_gen {
+
+// Tracer configuration
+struct TracerConfig {
+    std::string path = "next_gen_trace.jsonl";  // Span file, one JSON object per line
+    f64 sample_rate = 0.01;                     // Fraction of received messages to trace
+    size_t max_pending_spans = 65536;           // Spans buffered before new ones are dropped
+    u32 flush_interval_ms = 100;                // Writer flush interval
+};
+
+// Completed span
+struct TraceSpan {
+    u64 trace_id;
+    const char* name;       // Static string (receive, queue, dispatch, send, ...)
+    u64 start_ns;           // Monotonic nanoseconds
+    u64 duration_ns;
+    u32 thread_id;
+    u32 session_id;
+    u16 message_id;
+    u8 category;
+};
+
+// Message tracer
+//
+// Sampled trace IDs are attached to messages where they enter the process
+// (TcpSession receive) and follow them through postMessage, the service queue,
+// dispatch and send. The ID of the message being dispatched is kept in a
+// thread-local so messages posted or sent by the handler inherit it. Spans are
+// buffered and written as JSON lines by a background thread.
+class NEXT_GEN_API Tracer {
+public:
+    static Tracer& instance();
+
+    // Open span file and start writer thread
+    Result<void> open(const TracerConfig& config = TracerConfig());
+
+    // Flush pending spans and stop writer thread
+    void close();
+
+    // Check if tracing is enabled
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Start a new trace if sampled, returns 0 if not traced
+    u64 startTrace();
+
+    // Record a completed span (no-op for trace ID 0)
+    void recordSpan(u64 trace_id, const char* name, u64 start_ns, u64 end_ns,
+                    u8 category = 0, u16 message_id = 0, u32 session_id = 0);
+
+    // Get number of spans dropped because the buffer was full
+    u64 getDroppedSpans() const { return dropped_spans_.load(std::memory_order_relaxed); }
+
+    // Trace ID of the message being processed on this thread
+    static u64 currentTraceId();
+
+    // Set trace ID of the message being processed on this thread
+    static void setCurrentTraceId(u64 trace_id);
+
+private:
+    Tracer() : enabled_(false), sample_threshold_(0), stopping_(false), wall_offset_ns_(0), dropped_spans_(0) {}
+    ~Tracer() { close(); }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // Writer thread
+    void writerLoop();
+
+    // Write spans as JSON lines
+    void writeSpans(const std::vector<TraceSpan>& spans);
+
+    TracerConfig config_;
+    std::atomic<bool> enabled_;
+    u64 sample_threshold_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<TraceSpan> pending_;
+    bool stopping_;
+    std::thread writer_thread_;
+    std::ofstream file_;
+    i64 wall_offset_ns_;
+    std::atomic<u64> dropped_spans_;
+};
+
+// Scoped trace ID: makes trace_id current on this thread for the scope
+class TraceScope {
+public:
+    explicit TraceScope(u64 trace_id) : previous_(Tracer::currentTraceId()) {
+        Tracer::setCurrentTraceId(trace_id);
+    }
+
+    ~TraceScope() { Tracer::setCurrentTraceId(previous_); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    u64 previous_;
+};
+
+} // namespace next_gen
+
+#endif // NEXT_GEN_TRACER_H
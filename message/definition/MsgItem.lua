@@ -9,40 +9,49 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             item_id = {
+                tag = 1,
                 type = "uint32",
                 desc = "物品唯一ID",
                 required = true
             },
             template_id = {
+                tag = 2,
                 type = "uint32",
                 desc = "物品模板ID",
+                encoding = "varint",
                 required = true
             },
             count = {
+                tag = 3,
                 type = "uint32",
                 desc = "数量",
+                encoding = "varint",
                 required = true,
                 default = "1"
             },
             quality = {
+                tag = 4,
                 type = "uint8",
                 desc = "品质",
                 required = true,
                 default = "0"
             },
             bind_status = {
+                tag = 5,
                 type = "uint8",
                 desc = "绑定状态: 0-未绑定, 1-已绑定",
                 required = true,
                 default = "0"
             },
             expire_time = {
+                tag = 6,
                 type = "uint64",
                 desc = "过期时间戳（0表示永不过期）",
                 required = true,
                 default = "0"
             },
             attrs = {
+                tag = 7,
                 type = "array<string>",
                 desc = "属性列表（JSON格式）",
                 required = false
@@ -58,12 +67,15 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             reason = {
+                tag = 1,
                 type = "uint16",
                 desc = "物品获得原因",
+                encoding = "varint",
                 required = true,
                 default = "0"
             },
             items = {
+                tag = 2,
                 type = "array<ItemInfo>",
                 desc = "添加的物品列表",
                 required = true
@@ -77,16 +89,21 @@ messages = {
         id = 3,         -- 消息ID
         desc = "服务器通知客户端移除物品",
         version = 1,    -- 版本号
+        arena = true,   -- 数组从分派器内存池分配
         fields = {
             reason = {
+                tag = 1,
                 type = "uint16",
                 desc = "物品移除原因",
+                encoding = "varint",
                 required = true,
                 default = "0"
             },
             items = {
+                tag = 2,
                 type = "array<uint32>",
                 desc = "移除的物品ID列表",
+                encoding = "varint",
                 required = true
             }
         }
@@ -100,23 +117,28 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             item_id = {
+                tag = 1,
                 type = "uint32",
                 desc = "物品唯一ID",
                 required = true
             },
             count = {
+                tag = 2,
                 type = "uint32",
                 desc = "使用数量",
+                encoding = "varint",
                 required = true,
                 default = "1"
             },
             target_id = {
+                tag = 3,
                 type = "uint64",
                 desc = "目标ID（如果有）",
                 required = false,
                 default = "0"
             },
             extra_data = {
+                tag = 4,
                 type = "string",
                 desc = "额外数据（JSON格式）",
                 required = false,
@@ -133,28 +155,35 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             result = {
+                tag = 1,
                 type = "int32",
                 desc = "结果: 0-成功, 非0-失败码",
+                encoding = "zigzag",
                 required = true
             },
             message = {
+                tag = 2,
                 type = "string",
                 desc = "结果描述",
                 required = false,
                 default = ""
             },
             item_id = {
+                tag = 3,
                 type = "uint32",
                 desc = "物品唯一ID",
                 required = true
             },
             remain_count = {
+                tag = 4,
                 type = "uint32",
                 desc = "物品剩余数量",
+                encoding = "varint",
                 required = true,
                 default = "0"
             },
             rewards = {
+                tag = 5,
                 type = "string",
                 desc = "使用物品后获得的奖励（JSON格式）",
                 required = false,
@@ -9,27 +9,32 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             account = {
+                tag = 1,
                 type = "string",
                 desc = "账号名称",
                 required = true
             },
             password = {
+                tag = 2,
                 type = "string",
                 desc = "密码（已加密）",
                 required = true
             },
             client_version = {
+                tag = 3,
                 type = "string",
                 desc = "客户端版本号",
                 required = true
             },
             device_info = {
+                tag = 4,
                 type = "string",
                 desc = "设备信息",
                 required = false,
                 default = ""
             },
             login_ip = {
+                tag = 5,
                 type = "string",
                 desc = "登录IP地址",
                 required = false,
@@ -46,34 +51,40 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             result = {
+                tag = 1,
                 type = "int32",
                 desc = "登录结果: 0-成功, 非0-失败码",
                 required = true
             },
             error_msg = {
+                tag = 2,
                 type = "string",
                 desc = "错误信息（如果登录失败）",
                 required = false,
                 default = ""
             },
             token = {
+                tag = 3,
                 type = "string",
                 desc = "登录成功后的会话令牌",
                 required = false,
                 default = ""
             },
             server_time = {
+                tag = 4,
                 type = "uint64",
                 desc = "服务器当前时间戳",
                 required = true
             },
             account_info = {
+                tag = 5,
                 type = "string", -- 在实际应用中可能是另一个消息类型
                 desc = "账号信息（JSON格式）",
                 required = false,
                 default = "{}"
             },
             server_list = {
+                tag = 6,
                 type = "array<string>",
                 desc = "可用服务器列表",
                 required = false
@@ -89,11 +100,13 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             client_time = {
+                tag = 1,
                 type = "uint64",
                 desc = "客户端当前时间戳",
                 required = true
             },
             session_id = {
+                tag = 2,
                 type = "uint32",
                 desc = "会话ID",
                 required = true
@@ -109,6 +122,7 @@ messages = {
         version = 1,    -- 版本号
         fields = {
             server_time = {
+                tag = 1,
                 type = "uint64",
                 desc = "服务器当前时间戳",
                 required = true
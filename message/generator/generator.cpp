@@ -3,6 +3,10 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
 #include "../../include/utils/logger.h"
 
 extern "C" {
@@ -80,18 +84,132 @@ bool MessageGenerator::initialize() {
     return true;
 }
 
-int MessageGenerator::generateAll() {
-    int count = 0;
+// Lua回调函数，用于获取消息定义
+static int lua_get_message_definition(lua_State* L) {
+    // 获取消息定义表
+    luaL_checktype(L, 1, LUA_TTABLE);
+    
+    // 创建结果表
+    lua_newtable(L);
+    
+    // 处理每个字段
+    lua_pushnil(L);  // 第一个键
+    while (lua_next(L, 1) != 0) {
+        // 键在索引 -2，值在索引 -1
+        if (lua_isstring(L, -2)) {
+            const char* key = lua_tostring(L, -2);
+            
+            // 复制键值对到结果表
+            lua_pushvalue(L, -2);  // 复制键
+            lua_pushvalue(L, -2);  // 复制值
+            lua_settable(L, -4);   // 设置到结果表
+        }
+        
+        // 移除值，保留键用于下一次迭代
+        lua_pop(L, 1);
+    }
     
-    // 遍历输入目录中的所有Lua文件
+    return 1;  // 返回结果表
+}
+
+// 清单文件版本，生成代码的格式变化时递增以使所有旧清单失效
+static const char* MANIFEST_VERSION = "msggen-manifest 1";
+
+// 清单文件名
+static const char* MANIFEST_FILE = ".msggen_manifest";
+
+// FNV-1a 64位哈希
+static uint64_t hashBytes(const std::string& data, uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 读取整个文件
+static bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+int MessageGenerator::generateAll() {
+    // 收集定义文件，按路径排序保证输出稳定
+    std::vector<std::string> lua_files;
     for (const auto& entry : fs::directory_iterator(config_.input_dir)) {
         if (entry.path().extension() == ".lua") {
-            std::string lua_file = entry.path().string();
-            if (generateFile(lua_file)) {
-                count++;
-            }
+            lua_files.push_back(entry.path().string());
+        }
+    }
+    std::sort(lua_files.begin(), lua_files.end());
+    
+    if (config_.incremental) {
+        loadManifest();
+    }
+    
+    std::vector<std::vector<MessageDefinition>> file_definitions(lua_files.size());
+    std::vector<uint64_t> file_hashes(lua_files.size(), 0);
+    std::vector<char> file_ok(lua_files.size(), 0);
+    
+    // 工作线程按索引领取文件，每个线程复用一个Lua状态
+    std::atomic<size_t> next_file{0};
+    auto worker = [&]() {
+        lua_State* L = createLuaState();
+        if (!L) {
+            return;
+        }
+        for (size_t i = next_file++; i < lua_files.size(); i = next_file++) {
+            file_ok[i] = processFile(L, lua_files[i], file_definitions[i], file_hashes[i]) ? 1 : 0;
+        }
+        lua_close(L);
+    };
+    
+    size_t thread_count = config_.jobs > 0 ? static_cast<size_t>(config_.jobs)
+                                           : std::max(1u, std::thread::hardware_concurrency());
+    thread_count = std::min(thread_count, std::max<size_t>(lua_files.size(), 1));
+    if (thread_count <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    // 汇总所有文件的消息定义，更新清单（失败的文件不记录，下次重新生成）
+    int count = 0;
+    message_definitions_.clear();
+    std::unordered_map<std::string, uint64_t> manifest;
+    for (size_t i = 0; i < lua_files.size(); ++i) {
+        if (!file_ok[i]) {
+            Logger::error("Failed to generate messages from {}", lua_files[i]);
+            continue;
         }
+        count++;
+        manifest[lua_files[i]] = file_hashes[i];
+        message_definitions_.insert(message_definitions_.end(),
+                                    file_definitions[i].begin(), file_definitions[i].end());
     }
+    std::sort(message_definitions_.begin(), message_definitions_.end(),
+              [](const MessageDefinition& a, const MessageDefinition& b) {
+        if (a.category != b.category) {
+            return a.category < b.category;
+        }
+        if (a.id != b.id) {
+            return a.id < b.id;
+        }
+        return a.name < b.name;
+    });
     
     // 生成工厂注册文件
     if (config_.generate_factory && !message_definitions_.empty()) {
@@ -105,20 +223,65 @@ int MessageGenerator::generateAll() {
         generateLegacyAdapters(legacy_file);
     }
     
+    // 生成编译期消息分派器
+    if (config_.generate_dispatcher && !message_definitions_.empty()) {
+        std::string dispatcher_file = fs::path(config_.output_dir) / "message_dispatcher.h";
+        generateDispatcher(dispatcher_file);
+    }
+    
+    if (config_.incremental) {
+        manifest_ = std::move(manifest);
+        saveManifest();
+    }
+    
     Logger::info("Generated {} message files", count);
     return count;
 }
 
 bool MessageGenerator::generateFile(const std::string& lua_file) {
-    if (!loadMessageDefinitions(lua_file)) {
+    lua_State* L = createLuaState();
+    if (!L) {
+        return false;
+    }
+    
+    std::vector<MessageDefinition> definitions;
+    uint64_t input_hash = 0;
+    bool result = processFile(L, lua_file, definitions, input_hash);
+    lua_close(L);
+    
+    message_definitions_ = std::move(definitions);
+    return result;
+}
+
+bool MessageGenerator::processFile(lua_State* L, const std::string& lua_file,
+                                   std::vector<MessageDefinition>& definitions, uint64_t& input_hash) {
+    std::string lua_content;
+    if (!readFile(lua_file, lua_content)) {
+        Logger::error("Failed to read {}", lua_file);
+        return false;
+    }
+    
+    // 汇总工厂注册需要完整的定义列表，所以总是解析定义文件
+    if (!loadMessageDefinitions(L, lua_file, definitions)) {
         Logger::error("Failed to load message definitions from {}", lua_file);
         return false;
     }
     
-    fs::path lua_path(lua_file);
-    std::string base_name = lua_path.stem().string();
+    // 输入没有变化且输出都存在时跳过生成
+    input_hash = computeInputHash(lua_content);
+    if (config_.incremental) {
+        auto it = manifest_.find(lua_file);
+        if (it != manifest_.end() && it->second == input_hash && outputsExist(definitions)) {
+            Logger::debug("Up to date: {}", lua_file);
+            return true;
+        }
+    }
     
-    for (const auto& msg_def : message_definitions_) {
+    return generateMessages(definitions);
+}
+
+bool MessageGenerator::generateMessages(const std::vector<MessageDefinition>& definitions) {
+    for (const auto& msg_def : definitions) {
         std::string msg_name = msg_def.name;
         
         // 生成头文件
@@ -147,42 +310,108 @@ bool MessageGenerator::generateFile(const std::string& lua_file) {
     return true;
 }
 
-// Lua回调函数，用于获取消息定义
-static int lua_get_message_definition(lua_State* L) {
-    // 获取消息定义表
-    luaL_checktype(L, 1, LUA_TTABLE);
-    
-    // 创建结果表
-    lua_newtable(L);
-    
-    // 处理每个字段
-    lua_pushnil(L);  // 第一个键
-    while (lua_next(L, 1) != 0) {
-        // 键在索引 -2，值在索引 -1
-        if (lua_isstring(L, -2)) {
-            const char* key = lua_tostring(L, -2);
+uint64_t MessageGenerator::computeInputHash(const std::string& lua_content) {
+    {
+        std::lock_guard<std::mutex> lock(template_mutex_);
+        if (!template_hash_ready_) {
+            // 模板目录下所有模板，按文件名排序
+            std::vector<fs::path> template_files;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(config_.template_dir, ec)) {
+                if (entry.path().extension() == ".template") {
+                    template_files.push_back(entry.path());
+                }
+            }
+            std::sort(template_files.begin(), template_files.end());
             
-            // 复制键值对到结果表
-            lua_pushvalue(L, -2);  // 复制键
-            lua_pushvalue(L, -2);  // 复制值
-            lua_settable(L, -4);   // 设置到结果表
+            uint64_t hash = hashBytes(MANIFEST_VERSION);
+            for (const auto& path : template_files) {
+                std::string content;
+                readFile(path.string(), content);
+                hash = hashBytes(path.filename().string(), hash);
+                hash = hashBytes(content, hash);
+            }
+            
+            // 影响生成结果的选项
+            std::stringstream options;
+            options << config_.packed_layout << config_.generate_header << config_.generate_source << '|'
+                    << config_.header_prefix << '|' << config_.header_extension << '|'
+                    << config_.source_prefix << '|' << config_.source_extension << '|'
+                    << config_.base_namespace;
+            for (const auto& entry : std::map<std::string, TypeMapping>(type_mappings_.begin(),
+                                                                        type_mappings_.end())) {
+                options << '|' << entry.first << '=' << entry.second.cpp_type;
+            }
+            template_hash_ = hashBytes(options.str(), hash);
+            template_hash_ready_ = true;
         }
-        
-        // 移除值，保留键用于下一次迭代
-        lua_pop(L, 1);
     }
+    return hashBytes(lua_content, template_hash_);
+}
+
+bool MessageGenerator::outputsExist(const std::vector<MessageDefinition>& definitions) const {
+    for (const auto& msg_def : definitions) {
+        if (config_.generate_header &&
+            !fs::exists(fs::path(config_.output_dir) /
+                        (config_.header_prefix + msg_def.name + config_.header_extension))) {
+            return false;
+        }
+        if (config_.generate_source &&
+            !fs::exists(fs::path(config_.output_dir) /
+                        (config_.source_prefix + msg_def.name + config_.source_extension))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MessageGenerator::loadManifest() {
+    manifest_.clear();
     
-    return 1;  // 返回结果表
+    std::ifstream file(fs::path(config_.output_dir) / MANIFEST_FILE);
+    if (!file.is_open()) {
+        return;
+    }
+    
+    // 第一行是版本，之后每行为"哈希 文件路径"
+    std::string line;
+    if (!std::getline(file, line) || line != MANIFEST_VERSION) {
+        return;
+    }
+    while (std::getline(file, line)) {
+        size_t space = line.find(' ');
+        if (space == std::string::npos) {
+            continue;
+        }
+        // 清单损坏时当作空清单，全部重新生成
+        try {
+            manifest_[line.substr(space + 1)] = std::stoull(line.substr(0, space), nullptr, 16);
+        } catch (const std::exception& e) {
+            Logger::warning("Ignoring corrupt manifest {}: {}",
+                            (fs::path(config_.output_dir) / MANIFEST_FILE).string(), e.what());
+            manifest_.clear();
+            return;
+        }
+    }
 }
 
-bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
-    message_definitions_.clear();
+void MessageGenerator::saveManifest() {
+    std::vector<std::pair<std::string, uint64_t>> entries(manifest_.begin(), manifest_.end());
+    std::sort(entries.begin(), entries.end());
     
-    // 创建Lua状态
+    std::stringstream ss;
+    ss << MANIFEST_VERSION << "\n";
+    for (const auto& entry : entries) {
+        ss << std::hex << entry.second << std::dec << ' ' << entry.first << "\n";
+    }
+    writeOutput((fs::path(config_.output_dir) / MANIFEST_FILE).string(), ss.str());
+}
+
+lua_State* MessageGenerator::createLuaState() {
     lua_State* L = luaL_newstate();
     if (!L) {
         Logger::error("Failed to create Lua state");
-        return false;
+        return nullptr;
     }
     
     // 加载标准库
@@ -191,10 +420,21 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
     // 注册辅助函数
     lua_register(L, "get_message_definition", lua_get_message_definition);
     
+    return L;
+}
+
+bool MessageGenerator::loadMessageDefinitions(lua_State* L, const std::string& lua_file,
+                                              std::vector<MessageDefinition>& definitions) {
+    definitions.clear();
+    
+    // 复用的Lua状态可能保留上一个文件的定义
+    lua_pushnil(L);
+    lua_setglobal(L, "messages");
+    
     // 加载Lua文件
     if (luaL_dofile(L, lua_file.c_str()) != 0) {
         Logger::error("Failed to load Lua file {}: {}", lua_file, lua_tostring(L, -1));
-        lua_close(L);
+        lua_settop(L, 0);
         return false;
     }
     
@@ -202,7 +442,7 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
     lua_getglobal(L, "messages");
     if (!lua_istable(L, -1)) {
         Logger::error("No 'messages' table found in {}", lua_file);
-        lua_close(L);
+        lua_settop(L, 0);
         return false;
     }
     
@@ -257,6 +497,20 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
             }
             lua_pop(L, 1);
             
+            // 获取布局（"packed"为紧凑布局）
+            lua_getfield(L, -1, "layout");
+            if (lua_isstring(L, -1)) {
+                msg_def.packed = std::string(lua_tostring(L, -1)) == "packed";
+            }
+            lua_pop(L, 1);
+            
+            // 是否使用内存池分配字符串和数组字段
+            lua_getfield(L, -1, "arena");
+            if (lua_isboolean(L, -1)) {
+                msg_def.arena = lua_toboolean(L, -1) != 0;
+            }
+            lua_pop(L, 1);
+            
             // 获取字段定义
             lua_getfield(L, -1, "fields");
             if (lua_istable(L, -1)) {
@@ -317,6 +571,49 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
                         }
                         lua_pop(L, 1);
                         
+                        // 获取编码方式，只对整数类型有效
+                        lua_getfield(L, -1, "encoding");
+                        if (lua_isstring(L, -1)) {
+                            std::string encoding = lua_tostring(L, -1);
+                            bool is_integer = field.type == "int8" || field.type == "uint8" ||
+                                              field.type == "int16" || field.type == "uint16" ||
+                                              field.type == "int32" || field.type == "uint32" ||
+                                              field.type == "int64" || field.type == "uint64";
+                            if (encoding == "varint") {
+                                field.encoding = FIELD_ENCODING_VARINT;
+                            } else if (encoding == "zigzag") {
+                                field.encoding = FIELD_ENCODING_ZIGZAG;
+                            } else if (encoding == "delta") {
+                                field.encoding = FIELD_ENCODING_DELTA;
+                            } else if (encoding != "fixed") {
+                                Logger::warning("Unknown encoding {} for field {}.{}, using fixed",
+                                                encoding, msg_name, field_name);
+                            }
+                            
+                            if (field.encoding != FIELD_ENCODING_FIXED && !is_integer) {
+                                Logger::warning("Encoding {} requires an integer field, {}.{} uses fixed",
+                                                encoding, msg_name, field_name);
+                                field.encoding = FIELD_ENCODING_FIXED;
+                            } else if (field.encoding == FIELD_ENCODING_DELTA && field.is_vector) {
+                                Logger::warning("Delta encoding is not supported for arrays, {}.{} uses zigzag",
+                                                msg_name, field_name);
+                                field.encoding = FIELD_ENCODING_ZIGZAG;
+                            }
+                        }
+                        lua_pop(L, 1);
+                        
+                        // 获取字段编号
+                        lua_getfield(L, -1, "tag");
+                        if (lua_isnumber(L, -1)) {
+                            lua_Integer tag = lua_tointeger(L, -1);
+                            if (tag <= 0 || tag >= (1 << 29)) {
+                                Logger::error("Invalid tag {} for field {}.{}", tag, msg_name, field_name);
+                            } else {
+                                field.tag = static_cast<uint32_t>(tag);
+                            }
+                        }
+                        lua_pop(L, 1);
+                        
                         msg_def.fields.push_back(field);
                     }
                     
@@ -325,7 +622,35 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
             }
             lua_pop(L, 1);
             
-            message_definitions_.push_back(msg_def);
+            // 带编号的消息：所有字段都必须有唯一编号，按编号排序
+            bool definition_valid = true;
+            size_t tagged_count = std::count_if(msg_def.fields.begin(), msg_def.fields.end(),
+                                                [](const MessageDefinition::Field& field) { return field.tag != 0; });
+            if (tagged_count > 0) {
+                std::sort(msg_def.fields.begin(), msg_def.fields.end(),
+                          [](const MessageDefinition::Field& a, const MessageDefinition::Field& b) {
+                    return a.tag < b.tag;
+                });
+                
+                if (tagged_count != msg_def.fields.size()) {
+                    Logger::error("Message {}: either all fields or none must have a tag", msg_name);
+                    definition_valid = false;
+                } else if (msg_def.fields.size() > 64) {
+                    Logger::error("Message {}: tagged messages support at most 64 fields", msg_name);
+                    definition_valid = false;
+                }
+                for (size_t i = 1; i < msg_def.fields.size() && definition_valid; ++i) {
+                    if (msg_def.fields[i].tag == msg_def.fields[i - 1].tag) {
+                        Logger::error("Message {}: duplicate tag {}", msg_name, msg_def.fields[i].tag);
+                        definition_valid = false;
+                    }
+                }
+                msg_def.tagged = true;
+            }
+            
+            if (definition_valid) {
+                definitions.push_back(msg_def);
+            }
             
             // 移除结果表
             lua_pop(L, 1);
@@ -334,6 +659,6 @@ bool MessageGenerator::loadMessageDefinitions(const std::string& lua_file) {
         lua_pop(L, 1);
     }
     
-    lua_close(L);
-    return !message_definitions_.empty();
+    lua_settop(L, 0);
+    return !definitions.empty();
 }
@@ -4,12 +4,19 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include "../include/types.h"
 
+struct lua_State;
+
 namespace next_gen {
 namespace message {
 namespace generator {
 
+class TemplateEngine;
+class CompiledTemplate;
+
 /**
  * @brief 消息生成器配置
  */
@@ -24,7 +31,11 @@ struct GeneratorConfig {
     bool generate_source = true;    // 生成源文件
     bool generate_factory = true;   // 生成工厂注册
     bool generate_legacy = true;    // 生成旧系统兼容层
+    bool generate_dispatcher = true; // 生成编译期消息分派器（message_dispatcher.h）
     bool verbose = false;           // 是否输出详细信息
+    bool packed_layout = false;     // 所有消息使用紧凑布局（也可在Lua中按消息设置 layout = "packed"）
+    bool incremental = true;        // 增量生成：输入和模板都未变化的定义文件跳过生成
+    int jobs = 0;                   // 并行生成的线程数，0表示使用硬件线程数
     
     // 文件名配置
     std::string header_extension = ".h";
@@ -57,6 +68,9 @@ struct MessageDefinition {
     uint16_t id;                    // 消息ID
     std::string description;        // 消息描述
     uint16_t version;               // 消息版本
+    bool packed = false;            // 是否使用紧凑布局（layout = "packed"）
+    bool tagged = false;            // 字段是否带编号（使用带编号的兼容格式）
+    bool arena = false;             // 字符串和数组字段是否从内存池分配（arena = true）
     
     struct Field {
         std::string name;           // 字段名称
@@ -65,6 +79,8 @@ struct MessageDefinition {
         bool is_vector;             // 是否是向量类型
         bool is_required;           // 是否是必需字段
         std::string default_value;  // 默认值
+        FieldEncoding encoding = FIELD_ENCODING_FIXED;  // 编码方式（encoding = "varint" | "zigzag" | "fixed" | "delta"）
+        uint32_t tag = 0;           // 字段编号，0表示未编号
     };
     
     std::vector<Field> fields;      // 字段列表
@@ -94,7 +110,12 @@ public:
     /**
      * @brief 生成所有消息
      * 
-     * @return 生成的消息数量
+     * 定义文件在线程池中并行处理，每个工作线程复用一个Lua状态。
+     * 增量模式下，定义文件内容、模板和生成选项的哈希与清单（输出目录下的
+     * .msggen_manifest）一致且输出文件都存在时跳过该文件；内容没有变化的
+     * 输出文件不会重写，保留修改时间，避免构建系统重新编译。
+     * 
+     * @return 处理成功的定义文件数量
      */
     int generateAll();
     
@@ -136,7 +157,34 @@ public:
     
 private:
     // 从Lua文件加载消息定义
-    bool loadMessageDefinitions(const std::string& lua_file);
+    bool loadMessageDefinitions(lua_State* L, const std::string& lua_file,
+                                std::vector<MessageDefinition>& definitions);
+    
+    // 处理一个定义文件：解析、检查清单、生成头文件和源文件
+    bool processFile(lua_State* L, const std::string& lua_file,
+                     std::vector<MessageDefinition>& definitions, uint64_t& input_hash);
+    
+    // 生成一组消息的头文件和源文件
+    bool generateMessages(const std::vector<MessageDefinition>& definitions);
+    
+    // 创建Lua状态
+    lua_State* createLuaState();
+    
+    // 从缓存加载模板（每次运行只读取和编译一次）
+    bool loadTemplate(TemplateEngine& engine, const std::string& template_name);
+    
+    // 写入输出文件，内容没有变化时不写入
+    bool writeOutput(const std::string& output_file, const std::string& content);
+    
+    // 计算定义文件的输入哈希（文件内容、模板和生成选项）
+    uint64_t computeInputHash(const std::string& lua_content);
+    
+    // 检查定义文件的所有输出文件是否存在
+    bool outputsExist(const std::vector<MessageDefinition>& definitions) const;
+    
+    // 读取和保存增量生成清单
+    void loadManifest();
+    void saveManifest();
     
     // 生成头文件
     bool generateHeader(const MessageDefinition& message_def, const std::string& output_file);
@@ -150,17 +198,49 @@ private:
     // 生成旧系统兼容层
     bool generateLegacyAdapters(const std::string& output_file);
     
+    // 生成编译期消息分派器
+    bool generateDispatcher(const std::string& output_file);
+    
+    // 判断消息是否按紧凑布局生成
+    bool usePackedLayout(const MessageDefinition& message_def) const;
+    
+    // 拆分紧凑布局的定长字段和变长字段（按线路顺序）
+    void splitPackedFields(const MessageDefinition& message_def,
+                           std::vector<MessageDefinition::Field>& fixed_fields,
+                           std::vector<MessageDefinition::Field>& variable_fields) const;
+    
+    // 生成紧凑布局头文件
+    bool generatePackedHeader(const MessageDefinition& message_def, const std::string& output_file);
+    
+    // 生成紧凑布局源文件
+    bool generatePackedSource(const MessageDefinition& message_def, const std::string& output_file);
+    
+    // 获取定长类型的字节数，变长或自定义类型返回0
+    size_t getFixedTypeSize(const std::string& lua_type) const;
+    
     // 获取字段的C++类型
     std::string getCppType(const std::string& lua_type, bool is_vector);
     
-    // 获取字段的序列化代码
-    std::string getSerializeCode(const std::string& field_name, const std::string& field_type, bool is_vector);
+    // 获取字段的序列化代码（delta_index为增量字段序号）
+    std::string getSerializeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                                 FieldEncoding encoding = FIELD_ENCODING_FIXED, int delta_index = -1);
     
     // 获取字段的反序列化代码
-    std::string getDeserializeCode(const std::string& field_name, const std::string& field_type, bool is_vector);
+    std::string getDeserializeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                                   FieldEncoding encoding = FIELD_ENCODING_FIXED, int delta_index = -1);
     
     // 获取字段大小计算代码
-    std::string getSizeCode(const std::string& field_name, const std::string& field_type, bool is_vector);
+    std::string getSizeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                            FieldEncoding encoding = FIELD_ENCODING_FIXED);
+    
+    // 获取字段成员的C++类型（arena消息的字符串和数组使用std::pmr容器）
+    std::string getMemberType(const MessageDefinition::Field& field, bool arena);
+    
+    // 获取字段默认值的C++表达式，没有默认值时返回空字符串
+    std::string getDefaultValueCode(const MessageDefinition::Field& field);
+    
+    // 获取按编码方式读写单个值的FieldCodec类型
+    std::string getCodecType(const std::string& field_type, FieldEncoding encoding);
     
     // 生成器配置
     GeneratorConfig config_;
@@ -170,6 +250,17 @@ private:
     
     // 加载的消息定义
     std::vector<MessageDefinition> message_definitions_;
+    
+    // 模板缓存（模板名 -> 编译结果）
+    std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> template_cache_;
+    std::mutex template_mutex_;
+    
+    // 所有模板和生成选项的哈希，首次使用时计算
+    uint64_t template_hash_ = 0;
+    bool template_hash_ready_ = false;
+    
+    // 增量生成清单（定义文件路径 -> 输入哈希）
+    std::unordered_map<std::string, uint64_t> manifest_;
 };
 
 } // namespace generator
@@ -5,6 +5,8 @@
 #include <sstream>
 #include <cctype>
 #include <algorithm>
+#include <set>
+#include <unordered_map>
 #include "../../include/utils/logger.h"
 
 namespace fs = std::filesystem;
@@ -27,12 +29,113 @@ static std::string toLowerCase(const std::string& name) {
     return result;
 }
 
+// 辅助函数：转换字段名为大写
+static std::string toUpperCase(const std::string& name) {
+    std::string result = name;
+    std::transform(result.begin(), result.end(), result.begin(), 
+                   [](unsigned char c) { return std::toupper(c); });
+    return result;
+}
+
+// 辅助函数：生成C++字符串字面量
+static std::string toStringLiteral(const std::string& value) {
+    std::string result = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    result += "\"";
+    return result;
+}
+
+// 辅助函数：字段编码枚举名
+static std::string toEncodingEnum(next_gen::message::FieldEncoding encoding) {
+    switch (encoding) {
+        case next_gen::message::FIELD_ENCODING_VARINT: return "FIELD_ENCODING_VARINT";
+        case next_gen::message::FIELD_ENCODING_ZIGZAG: return "FIELD_ENCODING_ZIGZAG";
+        case next_gen::message::FIELD_ENCODING_DELTA: return "FIELD_ENCODING_DELTA";
+        default: return "FIELD_ENCODING_FIXED";
+    }
+}
+
+bool MessageGenerator::loadTemplate(TemplateEngine& engine, const std::string& template_name) {
+    std::shared_ptr<const CompiledTemplate> compiled;
+    {
+        std::lock_guard<std::mutex> lock(template_mutex_);
+        auto it = template_cache_.find(template_name);
+        if (it == template_cache_.end()) {
+            std::string template_file = fs::path(config_.template_dir) / template_name;
+            std::ifstream file(template_file, std::ios::binary);
+            if (!file.is_open()) {
+                Logger::error("Failed to load template from {}", template_file);
+                return false;
+            }
+            std::stringstream ss;
+            ss << file.rdbuf();
+            
+            // 每次运行每个模板只编译一次，编译结果在工作线程之间共享
+            std::string error;
+            auto result = CompiledTemplate::compile(ss.str(), &error);
+            if (!result) {
+                Logger::error("Failed to compile template {}: {}", template_file, error);
+                return false;
+            }
+            it = template_cache_.emplace(template_name, std::move(result)).first;
+        }
+        compiled = it->second;
+    }
+    
+    engine.load(std::move(compiled));
+    return true;
+}
+
+bool MessageGenerator::writeOutput(const std::string& output_file, const std::string& content) {
+    // 内容相同时不写入，保留修改时间
+    std::error_code ec;
+    if (fs::file_size(output_file, ec) == content.size() && !ec) {
+        std::ifstream in(output_file, std::ios::binary);
+        std::string existing(content.size(), '\0');
+        if (in.read(&existing[0], static_cast<std::streamsize>(existing.size())) && existing == content) {
+            Logger::debug("Unchanged: {}", output_file);
+            return true;
+        }
+    }
+    
+    // 先写临时文件再替换，中断时不会留下半个文件
+    std::string temp_file = output_file + ".tmp";
+    {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Logger::error("Failed to open output file: {}", temp_file);
+            return false;
+        }
+        out << content;
+        if (!out) {
+            Logger::error("Failed to write output file: {}", temp_file);
+            return false;
+        }
+    }
+    fs::rename(temp_file, output_file, ec);
+    if (ec) {
+        Logger::error("Failed to replace output file {}: {}", output_file, ec.message());
+        fs::remove(temp_file, ec);
+        return false;
+    }
+    
+    Logger::info("Updated: {}", output_file);
+    return true;
+}
+
 bool MessageGenerator::generateHeader(const MessageDefinition& message_def, const std::string& output_file) {
+    if (usePackedLayout(message_def)) {
+        return generatePackedHeader(message_def, output_file);
+    }
+    
     // 加载头文件模板
     TemplateEngine engine;
-    std::string template_file = fs::path(config_.template_dir) / "message_header.template";
-    if (!engine.loadFromFile(template_file)) {
-        Logger::error("Failed to load header template from {}", template_file);
+    if (!loadTemplate(engine, "message_header.template")) {
         return false;
     }
     
@@ -62,55 +165,71 @@ bool MessageGenerator::generateHeader(const MessageDefinition& message_def, cons
     
     engine.setCondition("has_additional_includes", has_additional_includes);
     engine.setVariable("additional_includes", includes.str());
+    engine.setCondition("is_arena", message_def.arena);
     
     // 设置字段循环
     std::vector<MessageDefinition::Field> fields = message_def.fields;
+    bool arena = message_def.arena;
     engine.setLoop("field", fields.size(), 
-                 [this, &fields](const std::string& loop_body, int index) -> std::string {
-        TemplateEngine field_engine;
-        field_engine.loadFromString(loop_body);
-        
+                 [this, &fields, arena](TemplateEngine& field_engine, int index) {
         const auto& field = fields[index];
         std::string field_name = field.name;
         std::string field_name_capitalized = toCamelCase(field_name);
         std::string field_name_lower = toLowerCase(field_name);
         std::string field_cpp_type = getCppType(field.type, field.is_vector);
+        std::string field_member_type = getMemberType(field, arena);
+        
+        // 访问器类型：arena字符串按string_view设置，arena数组从std::vector复制到内存池
+        std::string getter_type = field_cpp_type;
+        std::string param_type = field_cpp_type;
+        std::string assign_code = field_name_lower + " = value;";
+        if (field.is_vector) {
+            getter_type = "const " + field_member_type + "&";
+            param_type = "const std::vector<" + field_cpp_type + ">&";
+            if (arena) {
+                assign_code = field_name_lower + ".assign(value.begin(), value.end());";
+            }
+        } else if (arena && field.type == "string") {
+            getter_type = "const " + field_member_type + "&";
+            param_type = "std::string_view";
+            assign_code = field_name_lower + ".assign(value.data(), value.size());";
+        }
         
         field_engine.setVariable("field_name", field_name);
         field_engine.setVariable("field_name_capitalized", field_name_capitalized);
         field_engine.setVariable("field_name_lower", field_name_lower);
         field_engine.setVariable("field_cpp_type", field_cpp_type);
+        field_engine.setVariable("field_member_type", field_member_type);
+        field_engine.setVariable("field_getter_type", getter_type);
+        field_engine.setVariable("field_param_type", param_type);
+        field_engine.setVariable("field_assign_code", assign_code);
         field_engine.setVariable("field_description", field.description);
         field_engine.setVariable("field_is_vector", field.is_vector ? "true" : "false");
         field_engine.setCondition("field_is_vector", field.is_vector);
-        field_engine.setCondition("field_has_default", !field.default_value.empty());
-        field_engine.setVariable("field_default_value", field.default_value);
-        
-        return field_engine.render();
+        std::string default_value_code = getDefaultValueCode(field);
+        field_engine.setCondition("field_has_default", !default_value_code.empty());
+        field_engine.setVariable("field_default_value", default_value_code);
     });
     
     // 渲染模板并写入文件
     std::string content = engine.render();
     
-    std::ofstream out(output_file);
-    if (!out.is_open()) {
-        Logger::error("Failed to open output file: {}", output_file);
+    if (!writeOutput(output_file, content)) {
         return false;
     }
     
-    out << content;
-    out.close();
-    
-    Logger::info("Generated header file: {}", output_file);
+    Logger::debug("Generated header file: {}", output_file);
     return true;
 }
 
 bool MessageGenerator::generateSource(const MessageDefinition& message_def, const std::string& output_file) {
+    if (usePackedLayout(message_def)) {
+        return generatePackedSource(message_def, output_file);
+    }
+    
     // 加载源文件模板
     TemplateEngine engine;
-    std::string template_file = fs::path(config_.template_dir) / "message_source.template";
-    if (!engine.loadFromFile(template_file)) {
-        Logger::error("Failed to load source template from {}", template_file);
+    if (!loadTemplate(engine, "message_source.template")) {
         return false;
     }
     
@@ -121,46 +240,135 @@ bool MessageGenerator::generateSource(const MessageDefinition& message_def, cons
     engine.setVariable("header_include_path", header_path);
     engine.setVariable("message_class_name", message_def.name + "Message");
     
-    // 设置字段循环
+    // 增量字段序号
     std::vector<MessageDefinition::Field> fields = message_def.fields;
+    std::vector<int> delta_indices(fields.size(), -1);
+    int delta_count = 0;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (fields[i].encoding == FIELD_ENCODING_DELTA) {
+            delta_indices[i] = delta_count++;
+        }
+    }
+    
+    // 有增量字段时，消息体以关键帧标志字节开始
+    std::string delta_count_str = std::to_string(delta_count);
+    engine.setVariable("delta_size_code", delta_count > 0
+        ? "    size += sizeof(uint8_t);  // 关键帧标志\n" : "");
+    engine.setVariable("delta_write_begin_code", delta_count > 0
+        ? "    DeltaCoder delta = DeltaCoder::beginWrite(stream, CATEGORY, ID, " + delta_count_str + ");\n" : "");
+    engine.setVariable("delta_read_begin_code", delta_count > 0
+        ? "    DeltaCoder delta = DeltaCoder::beginRead(stream, CATEGORY, ID, " + delta_count_str + ");\n" : "");
+    
+    // 带编号的兼容格式
+    engine.setCondition("is_tagged", message_def.tagged);
+    uint64_t all_fields_mask = fields.size() >= 64 ? ~0ULL : (1ULL << fields.size()) - 1;
+    std::stringstream mask_str;
+    mask_str << "0x" << std::hex << all_fields_mask << "ULL";
+    engine.setVariable("all_fields_mask", mask_str.str());
+    
+    // 内存池分配
+    bool arena = message_def.arena;
+    engine.setCondition("is_arena", arena);
+    
+    // 设置字段循环
     engine.setLoop("field", fields.size(), 
-                 [this, &fields](const std::string& loop_body, int index) -> std::string {
-        TemplateEngine field_engine;
-        field_engine.loadFromString(loop_body);
-        
+                 [this, &fields, &delta_indices, arena](TemplateEngine& field_engine, int index) {
         const auto& field = fields[index];
         std::string field_name = field.name;
         std::string field_name_lower = toLowerCase(field_name);
         std::string field_cpp_type = getCppType(field.type, field.is_vector);
         
         // 获取序列化相关代码
-        std::string size_code = getSizeCode(field_name_lower, field.type, field.is_vector);
-        std::string serialize_code = getSerializeCode(field_name_lower, field.type, field.is_vector);
-        std::string deserialize_code = getDeserializeCode(field_name_lower, field.type, field.is_vector);
+        std::string size_code = getSizeCode(field_name_lower, field.type, field.is_vector, field.encoding);
+        std::string serialize_code = getSerializeCode(field_name_lower, field.type, field.is_vector,
+                                                      field.encoding, delta_indices[index]);
+        std::string deserialize_code = getDeserializeCode(field_name_lower, field.type, field.is_vector,
+                                                          field.encoding, delta_indices[index]);
+        
+        // 带编号格式的字段代码
+        if (field.tag != 0) {
+            bool is_builtin = type_mappings_.count(field.type) > 0;
+            size_t fixed_size = getFixedTypeSize(field.type);
+            bool is_varint = field.encoding != FIELD_ENCODING_FIXED;
+            bool is_block = field.is_vector || !is_builtin;
+            
+            // 线路类型
+            std::string wire_type = "TaggedWire::WIRE_LENGTH";
+            if (!field.is_vector && is_varint) {
+                wire_type = "TaggedWire::WIRE_VARINT";
+            } else if (!field.is_vector && fixed_size > 0) {
+                wire_type = "TaggedWire::WIRE_FIXED" + std::to_string(fixed_size * 8);
+            }
+            std::string key = "TaggedWire::makeKey(" + std::to_string(field.tag) + ", " + wire_type + ")";
+            size_t key_size = 1;
+            for (uint64_t key_value = static_cast<uint64_t>(field.tag) << 3; key_value >= 0x80; key_value >>= 7) {
+                ++key_size;
+            }
+            
+            std::string write_code = "TaggedWire::writeKey(stream, " + key + ");\n    ";
+            std::string read_code;
+            std::string tagged_size_code;
+            if (is_block) {
+                std::string mark = field_name_lower + "_mark";
+                write_code += "size_t " + mark + " = TaggedWire::beginLength(stream);\n    " +
+                              serialize_code + "\n    TaggedWire::endLength(stream, " + mark + ");";
+                read_code = "{\n    size_t end = TaggedWire::readLength(stream);\n    " + deserialize_code +
+                            "\n    TaggedWire::finishLength(stream, end);\n}";
+                tagged_size_code = size_code + "\n    size += " + std::to_string(key_size) + " + sizeof(uint32_t);";
+            } else if (field.type == "string") {
+                write_code += "TaggedWire::writeString(stream, " + field_name_lower + ");";
+                read_code = "TaggedWire::readString(stream, " + field_name_lower + ");";
+                tagged_size_code = "size += " + std::to_string(key_size) + " + sizeof(uint32_t) + " +
+                                   field_name_lower + ".size();";
+            } else {
+                write_code += serialize_code;
+                read_code = deserialize_code;
+                tagged_size_code = size_code + "\n    size += " + std::to_string(key_size) + ";";
+            }
+            
+            // 缺失字段的默认值
+            std::string default_value_code = getDefaultValueCode(field);
+            std::string reset_code;
+            if (!default_value_code.empty()) {
+                reset_code = field_name_lower + " = " + default_value_code + ";";
+            } else if (field.is_vector || field.type == "string") {
+                reset_code = field_name_lower + ".clear();";
+            } else {
+                reset_code = field_name_lower + " = " + getCppType(field.type, false) + "();";
+            }
+            
+            field_engine.setVariable("field_key", key);
+            field_engine.setVariable("field_bit", "(1ULL << " + std::to_string(index) + ")");
+            field_engine.setVariable("field_tagged_write_code", write_code);
+            field_engine.setVariable("field_tagged_read_code", read_code);
+            field_engine.setVariable("field_reset_code", reset_code);
+            size_code = tagged_size_code;
+        }
         
         // 获取toString相关代码
         std::string to_string_code;
         if (field.type == "string") {
             to_string_code = field.is_vector 
-                ? "ss << " + field_name_lower + "[i]"
-                : "ss << " + field_name_lower;
+                ? "ss << " + field_name_lower + "[i];"
+                : "ss << " + field_name_lower + ";";
         } else if (field.type == "bool") {
             to_string_code = field.is_vector 
-                ? "ss << (" + field_name_lower + "[i] ? \"true\" : \"false\")"
-                : "ss << (" + field_name_lower + " ? \"true\" : \"false\")";
+                ? "ss << (" + field_name_lower + "[i] ? \"true\" : \"false\");"
+                : "ss << (" + field_name_lower + " ? \"true\" : \"false\");";
         } else {
             to_string_code = field.is_vector 
-                ? "ss << " + field_name_lower + "[i]"
-                : "ss << " + field_name_lower;
+                ? "ss << " + field_name_lower + "[i];"
+                : "ss << " + field_name_lower + ";";
         }
         
         // 获取字段类型枚举
         std::string field_type_enum = "FIELD_TYPE_CUSTOM";
         auto it = type_mappings_.find(field.type);
         if (it != type_mappings_.end()) {
-            field_type_enum = "FIELD_TYPE_" + field.type;
+            field_type_enum = "FIELD_TYPE_" + toUpperCase(field.type);
         }
         
+        
         field_engine.setVariable("field_name", field_name);
         field_engine.setVariable("field_name_lower", field_name_lower);
         field_engine.setVariable("field_type_enum", field_type_enum);
@@ -168,89 +376,75 @@ bool MessageGenerator::generateSource(const MessageDefinition& message_def, cons
         field_engine.setVariable("field_description", field.description);
         field_engine.setVariable("field_is_vector_bool", field.is_vector ? "true" : "false");
         field_engine.setVariable("field_is_required_bool", field.is_required ? "true" : "false");
+        field_engine.setVariable("field_encoding_enum", toEncodingEnum(field.encoding));
         field_engine.setVariable("field_size_code", size_code);
         field_engine.setVariable("field_serialize_code", serialize_code);
         field_engine.setVariable("field_deserialize_code", deserialize_code);
         field_engine.setVariable("field_to_string_code", to_string_code);
         field_engine.setCondition("field_is_vector", field.is_vector);
-        field_engine.setCondition("field_has_default", !field.default_value.empty());
-        field_engine.setVariable("field_default_value", field.default_value);
+        std::string default_value_code = getDefaultValueCode(field);
+        field_engine.setCondition("field_has_default", !default_value_code.empty());
+        field_engine.setVariable("field_default_value", default_value_code);
         
-        return field_engine.render();
+        // 构造函数初始化：默认值，arena消息的字符串和数组还要传入内存资源
+        std::string init_args = default_value_code;
+        if (arena && (field.is_vector || field.type == "string")) {
+            init_args += init_args.empty() ? "resource" : ", resource";
+        }
+        field_engine.setCondition("field_has_init", !init_args.empty());
+        field_engine.setVariable("field_init_args", init_args);
     });
     
     // 渲染模板并写入文件
     std::string content = engine.render();
     
-    std::ofstream out(output_file);
-    if (!out.is_open()) {
-        Logger::error("Failed to open output file: {}", output_file);
+    if (!writeOutput(output_file, content)) {
         return false;
     }
     
-    out << content;
-    out.close();
-    
-    Logger::info("Generated source file: {}", output_file);
+    Logger::debug("Generated source file: {}", output_file);
     return true;
 }
 
 bool MessageGenerator::generateFactoryRegistration(const std::string& output_file) {
     // 加载工厂注册模板
     TemplateEngine engine;
-    std::string template_file = fs::path(config_.template_dir) / "factory_registration.template";
-    if (!engine.loadFromFile(template_file)) {
-        Logger::error("Failed to load factory registration template from {}", template_file);
+    if (!loadTemplate(engine, "factory_registration.template")) {
         return false;
     }
     
     // 设置消息循环
     engine.setLoop("message", message_definitions_.size(), 
-                 [this](const std::string& loop_body, int index) -> std::string {
-        TemplateEngine msg_engine;
-        msg_engine.loadFromString(loop_body);
-        
+                 [this](TemplateEngine& msg_engine, int index) {
         const auto& msg_def = message_definitions_[index];
         std::string header_name = config_.header_prefix + msg_def.name + config_.header_extension;
         std::string header_path = fs::path("message/generated") / header_name;
         
         msg_engine.setVariable("message_class_name", msg_def.name + "Message");
         msg_engine.setVariable("message_header_path", header_path);
-        
-        return msg_engine.render();
     });
     
     // 渲染模板并写入文件
     std::string content = engine.render();
     
-    std::ofstream out(output_file);
-    if (!out.is_open()) {
-        Logger::error("Failed to open output file: {}", output_file);
+    if (!writeOutput(output_file, content)) {
         return false;
     }
     
-    out << content;
-    out.close();
-    
-    Logger::info("Generated factory registration file: {}", output_file);
+    Logger::debug("Generated factory registration file: {}", output_file);
     return true;
 }
 
 bool MessageGenerator::generateLegacyAdapters(const std::string& output_file) {
     // 加载旧系统适配器模板
     TemplateEngine engine;
-    std::string template_file = fs::path(config_.template_dir) / "legacy_adapters.template";
-    if (!engine.loadFromFile(template_file)) {
-        Logger::error("Failed to load legacy adapters template from {}", template_file);
+    if (!loadTemplate(engine, "legacy_adapters.template")) {
         return false;
     }
     
     // 设置消息循环
     engine.setLoop("message", message_definitions_.size(), 
-                 [this](const std::string& loop_body, int index) -> std::string {
-        TemplateEngine msg_engine;
-        msg_engine.loadFromString(loop_body);
-        
+                 [this](TemplateEngine& msg_engine, int index) {
         const auto& msg_def = message_definitions_[index];
         std::string header_name = config_.header_prefix + msg_def.name + config_.header_extension;
         std::string header_path = fs::path("message/generated") / header_name;
@@ -258,23 +452,80 @@ bool MessageGenerator::generateLegacyAdapters(const std::string& output_file) {
         msg_engine.setVariable("message_name", msg_def.name);
         msg_engine.setVariable("message_class_name", msg_def.name + "Message");
         msg_engine.setVariable("message_header_path", header_path);
-        
-        return msg_engine.render();
     });
     
     // 渲染模板并写入文件
     std::string content = engine.render();
     
-    std::ofstream out(output_file);
-    if (!out.is_open()) {
-        Logger::error("Failed to open output file: {}", output_file);
+    if (!writeOutput(output_file, content)) {
+        return false;
+    }
+    
+    Logger::debug("Generated legacy adapters file: {}", output_file);
+    return true;
+}
+
+bool MessageGenerator::generateDispatcher(const std::string& output_file) {
+    TemplateEngine engine;
+    if (!loadTemplate(engine, "message_dispatcher.template")) {
         return false;
     }
     
-    out << content;
-    out.close();
+    // 按类别分组，组内按ID排序，保证switch稠密且输出稳定
+    std::vector<const MessageDefinition*> messages;
+    for (const auto& msg_def : message_definitions_) {
+        messages.push_back(&msg_def);
+    }
+    std::sort(messages.begin(), messages.end(), [](const MessageDefinition* a, const MessageDefinition* b) {
+        return a->category != b->category ? a->category < b->category : a->id < b->id;
+    });
+    
+    std::vector<std::pair<size_t, size_t>> categories;  // [begin, end) in messages
+    for (size_t i = 0; i < messages.size(); ++i) {
+        if (i > 0 && messages[i]->category == messages[i - 1]->category && messages[i]->id == messages[i - 1]->id) {
+            Logger::error("Messages {} and {} share category {} id {}, dispatcher not generated",
+                          messages[i - 1]->name, messages[i]->name, messages[i]->category, messages[i]->id);
+            return false;
+        }
+        if (categories.empty() || messages[categories.back().first]->category != messages[i]->category) {
+            categories.emplace_back(i, i);
+        }
+        categories.back().second = i + 1;
+    }
     
-    Logger::info("Generated legacy adapters file: {}", output_file);
+    auto setMessageVariables = [this](TemplateEngine& msg_engine, const MessageDefinition& msg_def) {
+        std::string header_name = config_.header_prefix + msg_def.name + config_.header_extension;
+        msg_engine.setVariable("message_name", msg_def.name);
+        msg_engine.setVariable("message_class_name", msg_def.name + "Message");
+        msg_engine.setVariable("message_header_path", (fs::path("message/generated") / header_name).string());
+        msg_engine.setVariable("message_id", std::to_string(msg_def.id));
+        msg_engine.setCondition("message_arena", msg_def.arena && !usePackedLayout(msg_def));
+    };
+    
+    engine.setVariable("message_count", std::to_string(messages.size()));
+    engine.setLoop("message", messages.size(),
+                 [&messages, &setMessageVariables](TemplateEngine& msg_engine, int index) {
+        setMessageVariables(msg_engine, *messages[index]);
+    });
+    engine.setLoop("category", categories.size(),
+                 [&messages, &categories, &setMessageVariables](TemplateEngine& category_engine, int index) {
+        size_t begin = categories[index].first;
+        size_t end = categories[index].second;
+        category_engine.setVariable("category_value", std::to_string(messages[begin]->category));
+        category_engine.setLoop("category_message", static_cast<int>(end - begin),
+                              [&messages, &setMessageVariables, begin](TemplateEngine& msg_engine, int offset) {
+            setMessageVariables(msg_engine, *messages[begin + offset]);
+        });
+    });
+    
+    // 渲染模板并写入文件
+    std::string content = engine.render();
+    
+    if (!writeOutput(output_file, content)) {
+        return false;
+    }
+    
+    Logger::debug("Generated dispatcher file: {}", output_file);
     return true;
 }
 
@@ -288,9 +539,63 @@ std::string MessageGenerator::getCppType(const std::string& lua_type, bool is_ve
     return lua_type + "Message";
 }
 
-std::string MessageGenerator::getSerializeCode(const std::string& field_name, const std::string& field_type, bool is_vector) {
+std::string MessageGenerator::getMemberType(const MessageDefinition::Field& field, bool arena) {
+    if (!arena) {
+        std::string cpp_type = getCppType(field.type, field.is_vector);
+        return field.is_vector ? "std::vector<" + cpp_type + ">" : cpp_type;
+    }
+    
+    std::string element_type = field.type == "string" ? "std::pmr::string" : getCppType(field.type, false);
+    return field.is_vector ? "std::pmr::vector<" + element_type + ">" : element_type;
+}
+
+std::string MessageGenerator::getDefaultValueCode(const MessageDefinition::Field& field) {
+    if (field.default_value.empty() || field.is_vector) {
+        return "";
+    }
+    
+    // 字符串默认值需要加引号
+    if (field.type == "string") {
+        return toStringLiteral(field.default_value);
+    }
+    
+    return field.default_value;
+}
+
+std::string MessageGenerator::getCodecType(const std::string& field_type, FieldEncoding encoding) {
+    return "FieldCodec<" + getCppType(field_type, false) + ", " + toEncodingEnum(encoding) + ">";
+}
+
+std::string MessageGenerator::getSerializeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                                               FieldEncoding encoding, int delta_index) {
     std::stringstream ss;
     
+    // 增量编码
+    if (encoding == FIELD_ENCODING_DELTA && !is_vector) {
+        ss << "delta.write(stream, " << field_name << ", " << delta_index << ");";
+        return ss.str();
+    }
+    
+    // 变长整数编码
+    if (encoding == FIELD_ENCODING_VARINT || encoding == FIELD_ENCODING_ZIGZAG) {
+        std::string codec = getCodecType(field_type, encoding);
+        if (is_vector) {
+            ss << "{\n";
+            ss << "    // 写入数组大小\n";
+            ss << "    uint16_t size = static_cast<uint16_t>(" << field_name << ".size());\n";
+            ss << "    stream.write(size);\n";
+            ss << "    \n";
+            ss << "    // 写入数组元素\n";
+            ss << "    for (const auto& item : " << field_name << ") {\n";
+            ss << "        " << codec << "::write(stream, item);\n";
+            ss << "    }\n";
+            ss << "}";
+        } else {
+            ss << codec << "::write(stream, " << field_name << ");";
+        }
+        return ss.str();
+    }
+    
     if (is_vector) {
         ss << "{\n";
         ss << "    // 写入数组大小\n";
@@ -325,9 +630,39 @@ std::string MessageGenerator::getSerializeCode(const std::string& field_name, co
     return ss.str();
 }
 
-std::string MessageGenerator::getDeserializeCode(const std::string& field_name, const std::string& field_type, bool is_vector) {
+std::string MessageGenerator::getDeserializeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                                                 FieldEncoding encoding, int delta_index) {
     std::stringstream ss;
     
+    // 增量编码
+    if (encoding == FIELD_ENCODING_DELTA && !is_vector) {
+        ss << "delta.read(stream, " << field_name << ", " << delta_index << ");";
+        return ss.str();
+    }
+    
+    // 变长整数编码
+    if (encoding == FIELD_ENCODING_VARINT || encoding == FIELD_ENCODING_ZIGZAG) {
+        std::string codec = getCodecType(field_type, encoding);
+        if (is_vector) {
+            ss << "{\n";
+            ss << "    // 读取数组大小\n";
+            ss << "    uint16_t size = 0;\n";
+            ss << "    stream.read(size);\n";
+            ss << "    \n";
+            ss << "    // 调整数组大小\n";
+            ss << "    " << field_name << ".resize(size);\n";
+            ss << "    \n";
+            ss << "    // 读取数组元素\n";
+            ss << "    for (uint16_t i = 0; i < size; ++i) {\n";
+            ss << "        " << codec << "::read(stream, " << field_name << "[i]);\n";
+            ss << "    }\n";
+            ss << "}";
+        } else {
+            ss << codec << "::read(stream, " << field_name << ");";
+        }
+        return ss.str();
+    }
+    
     if (is_vector) {
         ss << "{\n";
         ss << "    // 读取数组大小\n";
@@ -365,9 +700,35 @@ std::string MessageGenerator::getDeserializeCode(const std::string& field_name,
     return ss.str();
 }
 
-std::string MessageGenerator::getSizeCode(const std::string& field_name, const std::string& field_type, bool is_vector) {
+std::string MessageGenerator::getSizeCode(const std::string& field_name, const std::string& field_type, bool is_vector,
+                                          FieldEncoding encoding) {
     std::stringstream ss;
     
+    // 增量编码：差值依赖会话基线，按上界计算
+    if (encoding == FIELD_ENCODING_DELTA && !is_vector) {
+        ss << "size += DeltaCoder::MAX_FIELD_SIZE;";
+        return ss.str();
+    }
+    
+    // 变长整数编码
+    if (encoding == FIELD_ENCODING_VARINT || encoding == FIELD_ENCODING_ZIGZAG) {
+        std::string codec = getCodecType(field_type, encoding);
+        if (is_vector) {
+            ss << "{\n";
+            ss << "    // 数组大小字段\n";
+            ss << "    size += sizeof(uint16_t);\n";
+            ss << "    \n";
+            ss << "    // 数组元素大小\n";
+            ss << "    for (const auto& item : " << field_name << ") {\n";
+            ss << "        size += " << codec << "::size(item);\n";
+            ss << "    }\n";
+            ss << "}";
+        } else {
+            ss << "size += " << codec << "::size(" << field_name << ");";
+        }
+        return ss.str();
+    }
+    
     if (is_vector) {
         ss << "{\n";
         ss << "    // 数组大小字段\n";
@@ -408,3 +769,307 @@ std::string MessageGenerator::getSizeCode(const std::string& field_name, const s
     
     return ss.str();
 }
+
+size_t MessageGenerator::getFixedTypeSize(const std::string& lua_type) const {
+    static const std::unordered_map<std::string, size_t> sizes = {
+        {"int8", 1}, {"uint8", 1}, {"bool", 1},
+        {"int16", 2}, {"uint16", 2},
+        {"int32", 4}, {"uint32", 4}, {"float", 4},
+        {"int64", 8}, {"uint64", 8}, {"double", 8}
+    };
+    
+    auto it = sizes.find(lua_type);
+    return it != sizes.end() ? it->second : 0;
+}
+
+bool MessageGenerator::usePackedLayout(const MessageDefinition& message_def) const {
+    if (!config_.packed_layout && !message_def.packed) {
+        return false;
+    }
+    
+    // 紧凑布局支持：定长标量、字符串、定长标量数组（bool数组除外），且不使用变长编码
+    for (const auto& field : message_def.fields) {
+        if (field.encoding != FIELD_ENCODING_FIXED) {
+            Logger::warning("Message {} field {} uses a variable-length encoding, using default layout",
+                            message_def.name, field.name);
+            return false;
+        }
+        
+        bool supported = field.is_vector
+            ? getFixedTypeSize(field.type) > 0 && field.type != "bool"
+            : getFixedTypeSize(field.type) > 0 || field.type == "string";
+        if (!supported) {
+            Logger::warning("Message {} field {} ({}) is not supported by packed layout, using default layout",
+                            message_def.name, field.name, field.type);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void MessageGenerator::splitPackedFields(const MessageDefinition& message_def,
+                                         std::vector<MessageDefinition::Field>& fixed_fields,
+                                         std::vector<MessageDefinition::Field>& variable_fields) const {
+    for (const auto& field : message_def.fields) {
+        if (!field.is_vector && getFixedTypeSize(field.type) > 0) {
+            fixed_fields.push_back(field);
+        } else {
+            variable_fields.push_back(field);
+        }
+    }
+    
+    // Lua表遍历顺序不确定，按固定规则排序保证线路布局稳定：
+    // 定长字段按大小降序（自然对齐），再按名称；变长字段按名称
+    std::sort(fixed_fields.begin(), fixed_fields.end(),
+              [this](const MessageDefinition::Field& a, const MessageDefinition::Field& b) {
+        size_t size_a = getFixedTypeSize(a.type);
+        size_t size_b = getFixedTypeSize(b.type);
+        return size_a != size_b ? size_a > size_b : a.name < b.name;
+    });
+    std::sort(variable_fields.begin(), variable_fields.end(),
+              [](const MessageDefinition::Field& a, const MessageDefinition::Field& b) {
+        return a.name < b.name;
+    });
+}
+
+bool MessageGenerator::generatePackedHeader(const MessageDefinition& message_def, const std::string& output_file) {
+    // 加载紧凑布局头文件模板
+    TemplateEngine engine;
+    if (!loadTemplate(engine, "message_header_packed.template")) {
+        return false;
+    }
+
+    // 紧凑布局的变长字段使用默认分配器
+    if (message_def.arena) {
+        Logger::warning("Message {} uses packed layout, arena allocation is ignored", message_def.name);
+    }
+    
+    std::vector<MessageDefinition::Field> fixed_fields;
+    std::vector<MessageDefinition::Field> variable_fields;
+    splitPackedFields(message_def, fixed_fields, variable_fields);
+    
+    size_t fixed_size = 0;
+    for (const auto& field : fixed_fields) {
+        fixed_size += getFixedTypeSize(field.type);
+    }
+    
+    // 设置基本变量
+    engine.setVariable("message_name", message_def.name);
+    engine.setVariable("message_class_name", message_def.name + "Message");
+    engine.setVariable("message_description", message_def.description);
+    engine.setVariable("message_category", std::to_string(message_def.category));
+    engine.setVariable("message_id", std::to_string(message_def.id));
+    engine.setVariable("message_version", std::to_string(message_def.version));
+    engine.setVariable("fixed_size", std::to_string(fixed_size));
+    engine.setVariable("is_fixed_size", variable_fields.empty() ? "true" : "false");
+    engine.setCondition("has_fixed_fields", !fixed_fields.empty());
+    
+    // 定长字段循环
+    engine.setLoop("fixed_field", fixed_fields.size(), 
+                 [this, &fixed_fields](TemplateEngine& field_engine, int index) {
+        const auto& field = fixed_fields[index];
+        std::string field_name_lower = toLowerCase(field.name);
+        bool is_bool = field.type == "bool";
+        
+        field_engine.setVariable("field_name", field.name);
+        field_engine.setVariable("field_name_capitalized", toCamelCase(field.name));
+        field_engine.setVariable("field_name_lower", field_name_lower);
+        field_engine.setVariable("field_cpp_type", getCppType(field.type, false));
+        field_engine.setVariable("field_description", field.description);
+        
+        // bool在头部中以uint8_t存放，避免读取任意字节作为bool
+        field_engine.setVariable("field_storage_type", is_bool ? "uint8_t" : getCppType(field.type, false));
+        field_engine.setVariable("field_load_code",
+            is_bool ? "fields_." + field_name_lower + " != 0" : "fields_." + field_name_lower);
+        field_engine.setVariable("field_store_code",
+            is_bool ? "static_cast<uint8_t>(value ? 1 : 0)" : "value");
+    });
+    
+    // 变长字段循环
+    engine.setLoop("var_field", variable_fields.size(), 
+                 [this, &variable_fields](TemplateEngine& field_engine, int index) {
+        const auto& field = variable_fields[index];
+        std::string element_type = getCppType(field.type, false);
+        
+        field_engine.setVariable("field_name", field.name);
+        field_engine.setVariable("field_name_capitalized", toCamelCase(field.name));
+        field_engine.setVariable("field_name_lower", toLowerCase(field.name));
+        field_engine.setVariable("field_description", field.description);
+        field_engine.setVariable("field_owned_type",
+            field.is_vector ? "std::vector<" + element_type + ">" : element_type);
+        field_engine.setVariable("field_view_type",
+            field.is_vector ? "PackedArray<" + element_type + ">" : "std::string_view");
+    });
+    
+    // 渲染模板并写入文件
+    std::string content = engine.render();
+    
+    if (!writeOutput(output_file, content)) {
+        return false;
+    }
+    
+    Logger::debug("Generated packed header file: {}", output_file);
+    return true;
+}
+
+bool MessageGenerator::generatePackedSource(const MessageDefinition& message_def, const std::string& output_file) {
+    // 加载紧凑布局源文件模板
+    TemplateEngine engine;
+    if (!loadTemplate(engine, "message_source_packed.template")) {
+        return false;
+    }
+    
+    std::vector<MessageDefinition::Field> fixed_fields;
+    std::vector<MessageDefinition::Field> variable_fields;
+    splitPackedFields(message_def, fixed_fields, variable_fields);
+    
+    // 所有字段按线路顺序：定长字段在前
+    std::vector<MessageDefinition::Field> fields = fixed_fields;
+    fields.insert(fields.end(), variable_fields.begin(), variable_fields.end());
+    
+    // 设置基本变量
+    std::string header_name = config_.header_prefix + message_def.name + config_.header_extension;
+    std::string header_path = fs::path("message/generated") / header_name;
+    
+    engine.setVariable("header_include_path", header_path);
+    engine.setVariable("message_class_name", message_def.name + "Message");
+    
+    // 所有字段循环（字段信息、默认值、toString）
+    engine.setLoop("field", fields.size(), 
+                 [this, &fields](TemplateEngine& field_engine, int index) {
+        const auto& field = fields[index];
+        std::string field_name_lower = toLowerCase(field.name);
+        std::string getter = "get" + toCamelCase(field.name) + "()";
+        bool is_fixed = !field.is_vector && getFixedTypeSize(field.type) > 0;
+        bool is_byte = field.type == "int8" || field.type == "uint8";
+        
+        // 默认值初始化代码
+        std::string init_code;
+        if (!field.default_value.empty()) {
+            if (is_fixed) {
+                init_code = "    set" + toCamelCase(field.name) + "(" + field.default_value + ");\n";
+            } else if (field.type == "string" && !field.is_vector) {
+                init_code = "    " + field_name_lower + " = " + toStringLiteral(field.default_value) + ";\n";
+            }
+        }
+        
+        // toString代码
+        std::stringstream to_string_code;
+        if (field.is_vector) {
+            to_string_code << "ss << \"{\";\n";
+            to_string_code << "    for (size_t i = 0; i < " << field_name_lower << ".size(); ++i) {\n";
+            to_string_code << "        if (i > 0) {\n";
+            to_string_code << "            ss << \", \";\n";
+            to_string_code << "        }\n";
+            to_string_code << "        ss << " << (is_byte ? "static_cast<int>(" + field_name_lower + "[i])" : field_name_lower + "[i]") << ";\n";
+            to_string_code << "    }\n";
+            to_string_code << "    ss << \"}\";";
+        } else if (field.type == "bool") {
+            to_string_code << "ss << (" << getter << " ? \"true\" : \"false\");";
+        } else if (is_byte) {
+            to_string_code << "ss << static_cast<int>(" << getter << ");";
+        } else {
+            to_string_code << "ss << " << getter << ";";
+        }
+        
+        field_engine.setVariable("field_name", field.name);
+        field_engine.setVariable("field_type_enum", "FIELD_TYPE_" + toUpperCase(field.type));
+        field_engine.setVariable("field_type_name", field.type);
+        field_engine.setVariable("field_description", field.description);
+        field_engine.setVariable("field_is_vector_bool", field.is_vector ? "true" : "false");
+        field_engine.setVariable("field_is_required_bool", field.is_required ? "true" : "false");
+        field_engine.setVariable("field_init_code", init_code);
+        field_engine.setVariable("field_to_string_code", to_string_code.str());
+    });
+    
+    // 变长字段循环（序列化、反序列化、视图解析）
+    engine.setLoop("var_field", variable_fields.size(), 
+                 [this, &variable_fields](TemplateEngine& field_engine, int index) {
+        const auto& field = variable_fields[index];
+        std::string name = toLowerCase(field.name);
+        std::string element_type = getCppType(field.type, false);
+        std::string element_size = field.is_vector ? "sizeof(" + element_type + ")" : "1";
+        std::string count_expr = field.is_vector ? "count" : "length";
+        
+        std::stringstream size_code;
+        size_code << "size += sizeof(uint32_t) + static_cast<MessageSizeType>(" << name << ".size()";
+        if (field.is_vector) {
+            size_code << " * " << element_size;
+        }
+        size_code << ");";
+        
+        // uint32长度前缀 + 一次拷贝整段数据（uint16会截断超过65535的字段）
+        std::stringstream serialize_code;
+        serialize_code << "{\n";
+        serialize_code << "        uint32_t " << count_expr << " = static_cast<uint32_t>(" << name << ".size());\n";
+        serialize_code << "        stream.write(" << count_expr << ");\n";
+        serialize_code << "        stream.writeBytes(" << name << ".data(), " << count_expr;
+        if (field.is_vector) {
+            serialize_code << " * " << element_size;
+        }
+        serialize_code << ");\n";
+        serialize_code << "    }";
+        
+        std::stringstream deserialize_code;
+        deserialize_code << "{\n";
+        deserialize_code << "        uint32_t " << count_expr << " = 0;\n";
+        deserialize_code << "        stream.read(" << count_expr << ");\n";
+        deserialize_code << "        const uint8_t* data = stream.readView(" << count_expr;
+        if (field.is_vector) {
+            deserialize_code << " * " << element_size;
+        }
+        deserialize_code << ");\n";
+        deserialize_code << "        if (data) {\n";
+        if (field.is_vector) {
+            deserialize_code << "            " << name << ".resize(count);\n";
+            deserialize_code << "            std::memcpy(" << name << ".data(), data, count * " << element_size << ");\n";
+        } else {
+            deserialize_code << "            " << name << ".assign(reinterpret_cast<const char*>(data), length);\n";
+        }
+        // 数据不足：标记流错误，不保留旧值
+        deserialize_code << "        } else {\n";
+        deserialize_code << "            " << name << ".clear();\n";
+        deserialize_code << "            stream.setError();\n";
+        deserialize_code << "        }\n";
+        deserialize_code << "    }";
+        
+        // 视图直接引用缓冲区
+        std::stringstream view_code;
+        view_code << "{\n";
+        view_code << "        uint32_t " << count_expr << " = 0;\n";
+        view_code << "        stream.read(" << count_expr << ");\n";
+        view_code << "        const uint8_t* data = stream.readView(" << count_expr;
+        if (field.is_vector) {
+            view_code << " * " << element_size;
+        }
+        view_code << ");\n";
+        view_code << "        if (!data) {\n";
+        view_code << "            stream.setError();\n";
+        view_code << "            return false;\n";
+        view_code << "        }\n";
+        if (field.is_vector) {
+            view_code << "        " << name << "_ = PackedArray<" << element_type << ">(data, count);\n";
+        } else {
+            view_code << "        " << name << "_ = std::string_view(reinterpret_cast<const char*>(data), length);\n";
+        }
+        view_code << "    }";
+        
+        field_engine.setVariable("field_name", field.name);
+        field_engine.setVariable("field_name_lower", name);
+        field_engine.setVariable("field_size_code", size_code.str());
+        field_engine.setVariable("field_serialize_code", serialize_code.str());
+        field_engine.setVariable("field_deserialize_code", deserialize_code.str());
+        field_engine.setVariable("field_view_code", view_code.str());
+    });
+    
+    // 渲染模板并写入文件
+    std::string content = engine.render();
+    
+    if (!writeOutput(output_file, content)) {
+        return false;
+    }
+    
+    Logger::debug("Generated packed source file: {}", output_file);
+    return true;
+}
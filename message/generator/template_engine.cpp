@@ -1,219 +1,321 @@
 #include "template_engine.h"
 #include <fstream>
 #include <sstream>
-#include <regex>
+#include <algorithm>
 #include "../../include/utils/logger.h"
 
 namespace next_gen {
 namespace message {
 namespace generator {
 
+namespace {
+
+// 名称字符
+bool isNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// 跳过空白
+size_t skipSpaces(const std::string& source, size_t pos) {
+    while (pos < source.size() && (source[pos] == ' ' || source[pos] == '\t')) {
+        ++pos;
+    }
+    return pos;
+}
+
+// 读取名称，返回名称结束位置
+size_t readName(const std::string& source, size_t pos) {
+    while (pos < source.size() && isNameChar(source[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+// 位置所在行号，用于错误信息
+size_t lineOf(const std::string& source, size_t pos) {
+    return 1 + std::count(source.begin(), source.begin() + pos, '\n');
+}
+
+} // namespace
+
+std::shared_ptr<const CompiledTemplate> CompiledTemplate::compile(const std::string& source, std::string* error) {
+    auto compiled = std::make_shared<CompiledTemplate>();
+    compiled->source_ = source;
+    auto& code = compiled->code_;
+
+    // 未闭合的块（指令索引）
+    struct Block {
+        enum Kind { IF, ELSE, FOR } kind;
+        size_t instruction;
+    };
+    std::vector<Block> blocks;
+
+    auto fail = [&](const std::string& message, size_t pos) -> std::shared_ptr<const CompiledTemplate> {
+        if (error) {
+            *error = message + " at line " + std::to_string(lineOf(source, pos));
+        }
+        return nullptr;
+    };
+
+    auto emit = [&](OpCode op, uint32_t slot, size_t offset, size_t length) {
+        code.push_back(Instruction{op, slot, static_cast<uint32_t>(offset), static_cast<uint32_t>(length), 0});
+    };
+
+    size_t text_start = 0;
+    auto flushText = [&](size_t end) {
+        if (end > text_start) {
+            emit(OP_TEXT, 0, text_start, end - text_start);
+        }
+    };
+
+    size_t pos = 0;
+    while ((pos = source.find('{', pos)) != std::string::npos && pos + 1 < source.size()) {
+        char kind = source[pos + 1];
+
+        if (kind == '{') {
+            // {{ name }}
+            size_t name_start = skipSpaces(source, pos + 2);
+            size_t name_end = readName(source, name_start);
+            size_t close = skipSpaces(source, name_end);
+            if (name_end == name_start || source.compare(close, 2, "}}") != 0) {
+                ++pos;
+                continue;
+            }
+            size_t tag_end = close + 2;
+            flushText(pos);
+            emit(OP_VARIABLE, compiled->internSlot(source.substr(name_start, name_end - name_start)),
+                 pos, tag_end - pos);
+            pos = text_start = tag_end;
+            continue;
+        }
+
+        if (kind != '%') {
+            ++pos;
+            continue;
+        }
+
+        // {% keyword [name] %}
+        size_t keyword_start = skipSpaces(source, pos + 2);
+        size_t keyword_end = readName(source, keyword_start);
+        size_t name_start = skipSpaces(source, keyword_end);
+        size_t name_end = readName(source, name_start);
+        size_t close = skipSpaces(source, name_end);
+        if (source.compare(close, 2, "%}") != 0) {
+            ++pos;
+            continue;
+        }
+        size_t tag_end = close + 2;
+        std::string keyword = source.substr(keyword_start, keyword_end - keyword_start);
+        std::string name = source.substr(name_start, name_end - name_start);
+        bool has_name = name_end > name_start;
+
+        if (keyword == "if" && has_name) {
+            flushText(pos);
+            blocks.push_back(Block{Block::IF, code.size()});
+            emit(OP_IF, compiled->internSlot(name), pos, 0);
+        } else if (keyword == "else" && !has_name) {
+            if (blocks.empty() || blocks.back().kind != Block::IF) {
+                return fail("Unexpected {% else %}", pos);
+            }
+            flushText(pos);
+            size_t jump = code.size();
+            emit(OP_JUMP, 0, pos, 0);
+            code[blocks.back().instruction].jump = static_cast<uint32_t>(code.size());
+            blocks.back() = Block{Block::ELSE, jump};
+        } else if (keyword == "endif" && !has_name) {
+            if (blocks.empty() || blocks.back().kind == Block::FOR) {
+                return fail("Unexpected {% endif %}", pos);
+            }
+            flushText(pos);
+            code[blocks.back().instruction].jump = static_cast<uint32_t>(code.size());
+            blocks.pop_back();
+        } else if (keyword == "for" && has_name) {
+            flushText(pos);
+            blocks.push_back(Block{Block::FOR, code.size()});
+            emit(OP_FOR, compiled->internSlot(name), pos, 0);
+            // 开始标记后的换行不属于循环体
+            if (tag_end < source.size() && source[tag_end] == '\n') {
+                ++tag_end;
+            }
+        } else if (keyword == "endfor" && !has_name) {
+            if (blocks.empty() || blocks.back().kind != Block::FOR) {
+                return fail("Unexpected {% endfor %}", pos);
+            }
+            flushText(pos);
+            code[blocks.back().instruction].jump = static_cast<uint32_t>(code.size());
+            blocks.pop_back();
+            // 结束标记后的换行一并移除
+            if (tag_end < source.size() && source[tag_end] == '\n') {
+                ++tag_end;
+            }
+        } else {
+            // 未知标记按文本输出
+            ++pos;
+            continue;
+        }
+
+        pos = text_start = tag_end;
+    }
+    flushText(source.size());
+
+    if (!blocks.empty()) {
+        return fail(blocks.back().kind == Block::FOR ? "Missing {% endfor %}" : "Missing {% endif %}",
+                    code[blocks.back().instruction].offset);
+    }
+
+    return compiled;
+}
+
+int CompiledTemplate::findSlot(const std::string& name) const {
+    auto it = slots_.find(name);
+    return it != slots_.end() ? static_cast<int>(it->second) : -1;
+}
+
+uint32_t CompiledTemplate::internSlot(const std::string& name) {
+    auto it = slots_.find(name);
+    if (it != slots_.end()) {
+        return it->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(slot_names_.size());
+    slot_names_.push_back(name);
+    slots_.emplace(name, slot);
+    return slot;
+}
+
 TemplateEngine::TemplateEngine() {}
 
+TemplateEngine::TemplateEngine(std::shared_ptr<const CompiledTemplate> compiled) {
+    load(std::move(compiled));
+}
+
 bool TemplateEngine::loadFromFile(const std::string& template_file) {
     std::ifstream file(template_file);
     if (!file.is_open()) {
         Logger::error("Failed to open template file: {}", template_file);
         return false;
     }
-    
+
     std::stringstream ss;
     ss << file.rdbuf();
-    template_content_ = ss.str();
-    
+    return loadFromString(ss.str());
+}
+
+bool TemplateEngine::loadFromString(const std::string& template_content) {
+    std::string error;
+    auto compiled = CompiledTemplate::compile(template_content, &error);
+    if (!compiled) {
+        Logger::error("Failed to compile template: {}", error);
+        load(nullptr);
+        return false;
+    }
+    load(std::move(compiled));
     return true;
 }
 
-void TemplateEngine::loadFromString(const std::string& template_content) {
-    template_content_ = template_content;
+void TemplateEngine::load(std::shared_ptr<const CompiledTemplate> compiled) {
+    compiled_ = std::move(compiled);
+    size_t slot_count = compiled_ ? compiled_->getSlotCount() : 0;
+    variables_.assign(slot_count, std::string());
+    variable_set_.assign(slot_count, 0);
+    conditions_.assign(slot_count, 0);
+    loops_.assign(slot_count, Loop());
 }
 
 void TemplateEngine::setVariable(const std::string& name, const std::string& value) {
-    variables_[name] = value;
+    int slot = compiled_ ? compiled_->findSlot(name) : -1;
+    if (slot >= 0) {
+        variables_[slot] = value;
+        variable_set_[slot] = 1;
+    }
 }
 
-void TemplateEngine::setList(const std::string& name, 
+void TemplateEngine::setList(const std::string& name,
                            const std::vector<std::string>& items,
                            const std::string& separator) {
-    std::stringstream ss;
+    std::string value;
     for (size_t i = 0; i < items.size(); ++i) {
-        ss << items[i];
+        value += items[i];
         if (i < items.size() - 1) {
-            ss << separator;
+            value += separator;
         }
     }
-    variables_[name] = ss.str();
+    setVariable(name, value);
 }
 
 void TemplateEngine::setCondition(const std::string& name, bool value) {
-    conditions_[name] = value;
+    int slot = compiled_ ? compiled_->findSlot(name) : -1;
+    if (slot >= 0) {
+        conditions_[slot] = value ? 1 : 0;
+    }
 }
 
-void TemplateEngine::setLoop(const std::string& loop_name, 
-                           int item_count,
-                           std::function<std::string(const std::string&, int)> handler) {
-    loops_[loop_name] = [item_count, handler](const std::string& loop_body) -> std::string {
-        std::stringstream result;
-        for (int i = 0; i < item_count; ++i) {
-            result << handler(loop_body, i);
-        }
-        return result.str();
-    };
+void TemplateEngine::setLoop(const std::string& loop_name, int item_count, LoopHandler handler) {
+    int slot = compiled_ ? compiled_->findSlot(loop_name) : -1;
+    if (slot >= 0) {
+        loops_[slot].item_count = item_count;
+        loops_[slot].handler = std::move(handler);
+    }
 }
 
-std::string TemplateEngine::render() const {
-    std::string result = template_content_;
-    
-    // 处理循环语句
-    result = processLoops(result);
-    
-    // 处理条件语句
-    result = processConditions(result);
-    
-    // 替换变量
-    result = replaceVariables(result);
-    
-    return result;
-}
-
-std::string TemplateEngine::replaceVariables(const std::string& content) const {
-    std::string result = content;
-    
-    // 使用正则表达式替换变量
-    std::regex var_regex("\\{\\{\\s*([a-zA-Z0-9_]+)\\s*\\}\\}");
-    std::smatch match;
-    
-    std::string::const_iterator search_start(result.cbegin());
-    std::string temp_result;
-    
-    while (std::regex_search(search_start, result.cend(), match, var_regex)) {
-        temp_result.append(match.prefix());
-        
-        std::string var_name = match[1].str();
-        auto it = variables_.find(var_name);
-        
-        if (it != variables_.end()) {
-            temp_result.append(it->second);
-        } else {
-            // 保留未知变量
-            temp_result.append(match[0].str());
-        }
-        
-        search_start = match.suffix().first;
-    }
-    
-    temp_result.append(search_start, result.cend());
-    result = temp_result;
-    
-    return result;
-}
-
-std::string TemplateEngine::processConditions(const std::string& content) const {
-    std::string result = content;
-    
-    // 处理条件语句
-    std::regex if_regex("\\{\\%\\s*if\\s+([a-zA-Z0-9_]+)\\s*\\%\\}(.+?)\\{\\%\\s*endif\\s*\\%\\}");
-    std::smatch match;
-    
-    std::string::const_iterator search_start(result.cbegin());
-    std::string temp_result;
-    
-    while (std::regex_search(search_start, result.cend(), match, if_regex, 
-                             std::regex_constants::match_default | std::regex_constants::format_default)) {
-        temp_result.append(match.prefix());
-        
-        std::string cond_name = match[1].str();
-        std::string cond_body = match[2].str();
-        
-        auto it = conditions_.find(cond_name);
-        if (it != conditions_.end() && it->second) {
-            // 条件为真，保留内容
-            temp_result.append(cond_body);
-        }
-        
-        search_start = match.suffix().first;
-    }
-    
-    temp_result.append(search_start, result.cend());
-    result = temp_result;
-    
-    // 处理else语句
-    std::regex ifelse_regex("\\{\\%\\s*if\\s+([a-zA-Z0-9_]+)\\s*\\%\\}(.+?)\\{\\%\\s*else\\s*\\%\\}(.+?)\\{\\%\\s*endif\\s*\\%\\}");
-    
-    search_start = result.cbegin();
-    temp_result.clear();
-    
-    while (std::regex_search(search_start, result.cend(), match, ifelse_regex, 
-                             std::regex_constants::match_default | std::regex_constants::format_default)) {
-        temp_result.append(match.prefix());
-        
-        std::string cond_name = match[1].str();
-        std::string if_body = match[2].str();
-        std::string else_body = match[3].str();
-        
-        auto it = conditions_.find(cond_name);
-        if (it != conditions_.end() && it->second) {
-            // 条件为真，使用if部分
-            temp_result.append(if_body);
-        } else {
-            // 条件为假，使用else部分
-            temp_result.append(else_body);
-        }
-        
-        search_start = match.suffix().first;
+std::string TemplateEngine::render() {
+    std::string output;
+    render(output);
+    return output;
+}
+
+void TemplateEngine::render(std::string& output) {
+    if (!compiled_) {
+        return;
     }
-    
-    temp_result.append(search_start, result.cend());
-    result = temp_result;
-    
-    return result;
-}
-
-std::string TemplateEngine::processLoops(const std::string& content) const {
-    std::string result = content;
-    
-    for (const auto& loop_pair : loops_) {
-        const std::string& loop_name = loop_pair.first;
-        const auto& loop_handler = loop_pair.second;
-        
-        std::regex loop_start_regex("\\{\\%\\s*for\\s+" + loop_name + "\\s*\\%\\}");
-        std::regex loop_end_regex("\\{\\%\\s*endfor\\s*\\%\\}");
-        
-        size_t start_pos = 0;
-        while ((start_pos = result.find("{% for " + loop_name + " %}", start_pos)) != std::string::npos) {
-            size_t end_pos = 0;
-            std::string loop_body = extractLoopBody(result, loop_name, start_pos, end_pos);
-            
-            if (end_pos != std::string::npos) {
-                // 替换循环
-                std::string expanded = loop_handler(loop_body);
-                result.replace(start_pos, end_pos - start_pos + 13, expanded);  // 13 = length of "{% endfor %}"
-            } else {
-                // 没有找到结束标记，跳过
-                start_pos += 8 + loop_name.length();
+    output.reserve(output.size() + compiled_->getSourceSize() * 2);
+    execute(0, compiled_->code_.size(), output);
+}
+
+void TemplateEngine::execute(size_t begin, size_t end, std::string& output) {
+    const auto& code = compiled_->code_;
+    const std::string& source = compiled_->source_;
+
+    size_t pc = begin;
+    while (pc < end) {
+        const auto& instruction = code[pc];
+        switch (instruction.op) {
+            case CompiledTemplate::OP_TEXT:
+                output.append(source, instruction.offset, instruction.length);
+                ++pc;
+                break;
+
+            case CompiledTemplate::OP_VARIABLE:
+                if (variable_set_[instruction.slot]) {
+                    output += variables_[instruction.slot];
+                } else {
+                    // 保留未知变量
+                    output.append(source, instruction.offset, instruction.length);
+                }
+                ++pc;
+                break;
+
+            case CompiledTemplate::OP_IF:
+                pc = conditions_[instruction.slot] ? pc + 1 : instruction.jump;
+                break;
+
+            case CompiledTemplate::OP_JUMP:
+                pc = instruction.jump;
+                break;
+
+            case CompiledTemplate::OP_FOR: {
+                // 复制处理函数，处理函数内可以为嵌套循环重新设置循环
+                Loop loop = loops_[instruction.slot];
+                for (int i = 0; i < loop.item_count; ++i) {
+                    if (loop.handler) {
+                        loop.handler(*this, i);
+                    }
+                    execute(pc + 1, instruction.jump, output);
+                }
+                pc = instruction.jump;
+                break;
             }
         }
     }
-    
-    return result;
-}
-
-std::string TemplateEngine::extractLoopBody(const std::string& content, 
-                                          const std::string& loop_name,
-                                          size_t start_pos,
-                                          size_t& end_pos) const {
-    // 循环开始标记长度
-    size_t start_tag_len = 8 + loop_name.length();  // "{% for " + loop_name + " %}"
-    
-    // 查找循环结束标记
-    size_t body_start = start_pos + start_tag_len;
-    end_pos = content.find("{% endfor %}", body_start);
-    
-    if (end_pos != std::string::npos) {
-        return content.substr(body_start, end_pos - body_start);
-    }
-    
-    return "";
 }
 
 } // namespace generator
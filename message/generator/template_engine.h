@@ -1,105 +1,191 @@
 #pragma once
 
 #include <string>
-#include <map>
+#include <vector>
+#include <memory>
+#include <cstdint>
 #include <functional>
+#include <unordered_map>
 
 namespace next_gen {
 namespace message {
 namespace generator {
 
+/**
+ * @brief 编译后的模板
+ *
+ * 模板只解析一次，编译为指令序列：文本片段引用源码区间，变量、条件和循环
+ * 按名称分配槽位，渲染时按槽位索引取值，不再做字符串查找。编译结果只读，
+ * 可以在多个线程的TemplateEngine之间共享。
+ *
+ * 语法：
+ * - {{ name }}：变量，未设置的变量原样保留
+ * - {% if name %} ... {% else %} ... {% endif %}：条件，可以嵌套
+ * - {% for name %} ... {% endfor %}：循环，可以嵌套；开始和结束标记后的换行不输出
+ */
+class CompiledTemplate {
+public:
+    /**
+     * @brief 编译模板
+     *
+     * @param source 模板内容
+     * @param error 编译失败时的错误信息
+     * @return 编译结果，语法错误（标记不配对）时返回nullptr
+     */
+    static std::shared_ptr<const CompiledTemplate> compile(const std::string& source, std::string* error = nullptr);
+
+    /**
+     * @brief 查找名称对应的槽位
+     *
+     * @return 槽位索引，模板中没有使用该名称时返回-1
+     */
+    int findSlot(const std::string& name) const;
+
+    /**
+     * @brief 获取槽位数量
+     */
+    size_t getSlotCount() const { return slot_names_.size(); }
+
+    /**
+     * @brief 获取模板源码长度，用于预估输出大小
+     */
+    size_t getSourceSize() const { return source_.size(); }
+
+private:
+    friend class TemplateEngine;
+
+    enum OpCode : uint8_t {
+        OP_TEXT,        // 输出源码片段
+        OP_VARIABLE,    // 输出变量，未设置时输出原始标记
+        OP_IF,          // 条件为假时跳转到jump
+        OP_JUMP,        // 无条件跳转（if分支结束后跳过else分支）
+        OP_FOR          // 循环体为[当前+1, jump)
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t slot;
+        uint32_t offset;
+        uint32_t length;
+        uint32_t jump;
+    };
+
+    // 获取或分配槽位
+    uint32_t internSlot(const std::string& name);
+
+    std::string source_;
+    std::vector<Instruction> code_;
+    std::vector<std::string> slot_names_;
+    std::unordered_map<std::string, uint32_t> slots_;
+};
+
 /**
  * @brief 简单的模板引擎
- * 
- * 支持变量替换和条件语句
+ *
+ * 支持变量替换、条件语句和循环，模板编译一次后多次渲染。
+ * 循环处理函数在每次迭代前调用，在同一个引擎上设置本次迭代的变量和条件，
+ * 循环体内可以访问外层的变量。
  */
 class TemplateEngine {
 public:
+    /**
+     * @brief 循环处理函数，接收引擎和迭代索引，设置本次迭代的变量
+     */
+    using LoopHandler = std::function<void(TemplateEngine&, int)>;
+
     /**
      * @brief 构造函数
      */
     TemplateEngine();
-    
+
+    /**
+     * @brief 使用已编译的模板构造
+     */
+    explicit TemplateEngine(std::shared_ptr<const CompiledTemplate> compiled);
+
     /**
      * @brief 从文件加载模板
-     * 
+     *
      * @param template_file 模板文件路径
      * @return 是否加载成功
      */
     bool loadFromFile(const std::string& template_file);
-    
+
     /**
      * @brief 从字符串加载模板
-     * 
+     *
      * @param template_content 模板内容
+     * @return 是否编译成功
+     */
+    bool loadFromString(const std::string& template_content);
+
+    /**
+     * @brief 加载已编译的模板，清除之前设置的所有值
      */
-    void loadFromString(const std::string& template_content);
-    
+    void load(std::shared_ptr<const CompiledTemplate> compiled);
+
     /**
      * @brief 设置变量
-     * 
+     *
      * @param name 变量名
      * @param value 变量值
      */
     void setVariable(const std::string& name, const std::string& value);
-    
+
     /**
      * @brief 设置列表变量
-     * 
+     *
      * @param name 列表名
      * @param items 列表项
      * @param separator 分隔符
      */
-    void setList(const std::string& name, 
+    void setList(const std::string& name,
                 const std::vector<std::string>& items,
                 const std::string& separator = "\n");
-    
+
     /**
      * @brief 设置条件
-     * 
+     *
      * @param name 条件名
      * @param value 条件值
      */
     void setCondition(const std::string& name, bool value);
-    
+
     /**
-     * @brief 设置循环替换函数
-     * 
+     * @brief 设置循环
+     *
      * @param loop_name 循环名
      * @param item_count 项目数量
-     * @param handler 处理函数，接收循环体模板和索引，返回替换后的字符串
+     * @param handler 处理函数，每次迭代前调用
      */
-    void setLoop(const std::string& loop_name, 
-                int item_count,
-                std::function<std::string(const std::string&, int)> handler);
-    
+    void setLoop(const std::string& loop_name, int item_count, LoopHandler handler);
+
     /**
      * @brief 渲染模板
-     * 
+     *
      * @return 渲染后的内容
      */
-    std::string render() const;
-    
+    std::string render();
+
+    /**
+     * @brief 渲染模板，追加到output
+     */
+    void render(std::string& output);
+
 private:
-    std::string template_content_;
-    std::map<std::string, std::string> variables_;
-    std::map<std::string, bool> conditions_;
-    std::map<std::string, std::function<std::string(const std::string&)>> loops_;
-    
-    // 替换变量
-    std::string replaceVariables(const std::string& content) const;
-    
-    // 处理条件语句
-    std::string processConditions(const std::string& content) const;
-    
-    // 处理循环语句
-    std::string processLoops(const std::string& content) const;
-    
-    // 提取循环体
-    std::string extractLoopBody(const std::string& content, 
-                               const std::string& loop_name,
-                               size_t start_pos,
-                               size_t& end_pos) const;
+    struct Loop {
+        int item_count = 0;
+        LoopHandler handler;
+    };
+
+    // 执行指令区间[begin, end)
+    void execute(size_t begin, size_t end, std::string& output);
+
+    std::shared_ptr<const CompiledTemplate> compiled_;
+    std::vector<std::string> variables_;
+    std::vector<char> variable_set_;
+    std::vector<char> conditions_;
+    std::vector<Loop> loops_;
 };
 
 } // namespace generator
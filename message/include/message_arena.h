@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace next_gen {
+namespace message {
+
+/**
+ * @brief 消息内存池
+ *
+ * 启用 arena 的消息（Lua定义中 arena = true）的字符串和数组字段从这里分配。
+ * 单调分配：分配只移动指针，释放是空操作，reset() 一次性回收全部内存。
+ * 初始缓冲区在 reset() 后复用，消息不超过初始大小时解析过程不访问堆；
+ * 超出时从上游资源按块扩展，reset() 时归还。
+ *
+ * 非线程安全，每个分派线程使用自己的实例。
+ */
+class MessageArena {
+public:
+    // 默认初始缓冲区大小
+    static constexpr size_t DEFAULT_INITIAL_SIZE = 16 * 1024;
+
+    /**
+     * @brief 构造函数
+     *
+     * @param initial_size 初始缓冲区大小
+     * @param upstream 初始缓冲区用完后的上游资源
+     */
+    explicit MessageArena(size_t initial_size = DEFAULT_INITIAL_SIZE,
+                          std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : buffer_(new std::byte[initial_size]),
+          resource_(buffer_.get(), initial_size, upstream),
+          depth_(0) {}
+
+    MessageArena(const MessageArena&) = delete;
+    MessageArena& operator=(const MessageArena&) = delete;
+
+    /**
+     * @brief 获取内存资源，用于构造消息
+     */
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    /**
+     * @brief 回收全部内存，之前从这里分配的对象必须已经销毁
+     */
+    void reset() { resource_.release(); }
+
+    /**
+     * @brief 作用域
+     *
+     * 最外层作用域结束时重置内存池。处理函数内再次分派（嵌套作用域）时不会
+     * 回收外层消息仍在使用的内存。作用域必须先于使用内存池的消息构造，
+     * 保证消息先析构。
+     */
+    class Scope {
+    public:
+        explicit Scope(MessageArena& arena) : arena_(arena) { ++arena_.depth_; }
+
+        ~Scope() {
+            if (--arena_.depth_ == 0) {
+                arena_.reset();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        MessageArena& arena_;
+    };
+
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+    int depth_;
+};
+
+} // namespace message
+} // namespace next_gen
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 #include "types.h"
 #include "../../include/utils/byte_stream.h"
 
@@ -80,9 +81,10 @@ public:
                ", version=" + std::to_string(getVersion()) + "]";
     }
     
-    // 辅助序列化方法
-    std::vector<uint8_t> toBytes() const {
+    // 辅助序列化方法（delta_context为会话发送方向的增量编码上下文，可为空）
+    std::vector<uint8_t> toBytes(DeltaContext* delta_context = nullptr) const {
         ByteStream stream;
+        stream.setDeltaContext(delta_context);
         // 先写入消息头（分类和ID）
         stream.write(category_);
         stream.write(id_);
@@ -90,16 +92,17 @@ public:
         // 序列化消息体
         serialize(stream);
         
-        return stream.getData();
+        return stream.releaseData();
     }
     
-    // 辅助反序列化方法
-    bool fromBytes(const std::vector<uint8_t>& data) {
+    // 辅助反序列化方法（delta_context为会话接收方向的增量编码上下文，可为空）
+    bool fromBytes(const std::vector<uint8_t>& data, DeltaContext* delta_context = nullptr) {
         if (data.size() < sizeof(MessageCategoryType) + sizeof(MessageIdType)) {
             return false;
         }
         
-        ByteStream stream(data);
+        ByteStream stream(data.data(), data.size());
+        stream.setDeltaContext(delta_context);
         
         // 读取并校验消息头（分类和ID）
         MessageCategoryType category;
@@ -152,6 +155,15 @@ protected:
         std::function<std::unique_ptr<MessageBase>()> creator) = 0;
 };
 
+/**
+ * @brief 生成的消息分派器（MessageDispatcher）的分派结果
+ */
+enum class DispatchResult {
+    OK,                 // 已分派到处理函数
+    UNKNOWN_MESSAGE,    // 消息集中没有该类别和ID
+    DECODE_ERROR        // 消息体解析失败
+};
+
 /**
  * @brief 消息处理器接口
  * 
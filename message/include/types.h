@@ -4,7 +4,8 @@
 #include <string>
 #include <vector>
 #include <type_traits>
-#include "../../include/core/common.h"
+#include <cstring>
+#include "../../include/core/config.h"
 #include "../../include/utils/byte_stream.h"
 
 namespace next_gen {
@@ -51,6 +52,293 @@ enum FieldType {
     FIELD_TYPE_CUSTOM = 15,
 };
 
+// 字段编码方式
+enum FieldEncoding {
+    FIELD_ENCODING_FIXED = 0,   // 定长（按类型宽度）
+    FIELD_ENCODING_VARINT = 1,  // 无符号变长整数，适合非负小整数
+    FIELD_ENCODING_ZIGZAG = 2,  // ZigZag变长整数，适合绝对值小的有符号整数
+    FIELD_ENCODING_DELTA = 3,   // 相对同类型上一条消息的差值（ZigZag变长）
+};
+
+// ZigZag编码：把有符号整数映射为无符号整数，绝对值小的数编码后也小
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+// ZigZag解码
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// 整数类型变长编码的最大字节数
+template<typename T>
+constexpr MessageSizeType maxVarintSize() {
+    return static_cast<MessageSizeType>((sizeof(T) * 8 + 6) / 7);
+}
+
+// 按编码方式序列化单个字段
+template<typename T, FieldEncoding Encoding>
+struct FieldCodec {
+    static MessageSizeType size(const T&) { return sizeof(T); }
+    static void write(ByteStream& stream, const T& value) { stream.write(value); }
+    static void read(ByteStream& stream, T& value) { stream.read(value); }
+};
+
+template<typename T>
+struct FieldCodec<T, FIELD_ENCODING_VARINT> {
+    static_assert(std::is_integral<T>::value, "varint encoding requires an integer type");
+    
+    static MessageSizeType size(const T& value) {
+        return static_cast<MessageSizeType>(ByteStream::varintSize(static_cast<uint64_t>(value)));
+    }
+    static void write(ByteStream& stream, const T& value) {
+        stream.writeVarint(static_cast<uint64_t>(value));
+    }
+    static void read(ByteStream& stream, T& value) {
+        uint64_t raw = 0;
+        if (stream.readVarint(raw)) {
+            value = static_cast<T>(raw);
+        }
+    }
+};
+
+template<typename T>
+struct FieldCodec<T, FIELD_ENCODING_ZIGZAG> {
+    static_assert(std::is_integral<T>::value, "zigzag encoding requires an integer type");
+    
+    static MessageSizeType size(const T& value) {
+        return static_cast<MessageSizeType>(ByteStream::varintSize(zigzagEncode(static_cast<int64_t>(value))));
+    }
+    static void write(ByteStream& stream, const T& value) {
+        stream.writeVarint(zigzagEncode(static_cast<int64_t>(value)));
+    }
+    static void read(ByteStream& stream, T& value) {
+        uint64_t raw = 0;
+        if (stream.readVarint(raw)) {
+            value = static_cast<T>(zigzagDecode(raw));
+        }
+    }
+};
+
+// 增量编码器
+//
+// 消息体以一个标志字节开始（bit0 = 关键帧），随后每个增量字段写入相对基线的
+// ZigZag变长差值。基线保存在字节流挂载的DeltaContext中（每个会话、每个方向一个），
+// 没有挂载上下文时总是发送关键帧。
+class DeltaCoder {
+public:
+    static constexpr uint8_t FLAG_KEYFRAME = 0x01;
+    
+    // 开始写入：决定是否发送关键帧并写入标志字节
+    static DeltaCoder beginWrite(ByteStream& stream, MessageCategoryType category, MessageIdType id,
+                                 size_t field_count) {
+        DeltaContext::Baseline* baseline = findBaseline(stream, category, id, field_count);
+        bool keyframe = true;
+        if (baseline && baseline->valid) {
+            uint32_t interval = stream.getDeltaContext()->getKeyframeInterval();
+            keyframe = interval > 0 && ++baseline->since_keyframe >= interval;
+        }
+        if (baseline && keyframe) {
+            baseline->since_keyframe = 0;
+        }
+        
+        stream.write(static_cast<uint8_t>(keyframe ? FLAG_KEYFRAME : 0));
+        return DeltaCoder(baseline, keyframe);
+    }
+    
+    // 开始读取：读取标志字节，非关键帧必须已有基线
+    static DeltaCoder beginRead(ByteStream& stream, MessageCategoryType category, MessageIdType id,
+                                size_t field_count) {
+        DeltaContext::Baseline* baseline = findBaseline(stream, category, id, field_count);
+        uint8_t flags = FLAG_KEYFRAME;
+        stream.read(flags);
+        
+        bool keyframe = (flags & FLAG_KEYFRAME) != 0;
+        if (!keyframe && !(baseline && baseline->valid)) {
+            stream.setError();
+        }
+        return DeltaCoder(baseline, keyframe);
+    }
+    
+    // 写入第index个增量字段
+    template<typename T>
+    void write(ByteStream& stream, const T& value, size_t index) {
+        static_assert(std::is_integral<T>::value, "delta encoding requires an integer type");
+        uint64_t raw = static_cast<uint64_t>(value);
+        uint64_t previous = keyframe_ ? 0 : baseline_->values[index];
+        stream.writeVarint(zigzagEncode(static_cast<int64_t>(raw - previous)));
+        if (baseline_) {
+            baseline_->values[index] = raw;
+            baseline_->valid = true;
+        }
+    }
+    
+    // 读取第index个增量字段
+    template<typename T>
+    void read(ByteStream& stream, T& value, size_t index) {
+        static_assert(std::is_integral<T>::value, "delta encoding requires an integer type");
+        uint64_t delta = 0;
+        if (stream.hasError() || !stream.readVarint(delta)) {
+            return;
+        }
+        uint64_t previous = keyframe_ ? 0 : baseline_->values[index];
+        uint64_t raw = previous + static_cast<uint64_t>(zigzagDecode(delta));
+        value = static_cast<T>(raw);
+        if (baseline_) {
+            baseline_->values[index] = raw;
+            baseline_->valid = true;
+        }
+    }
+    
+    // 增量字段的最大编码字节数
+    static constexpr MessageSizeType MAX_FIELD_SIZE = maxVarintSize<uint64_t>();
+    
+    // 是否是关键帧
+    bool isKeyframe() const { return keyframe_; }
+    
+private:
+    DeltaCoder(DeltaContext::Baseline* baseline, bool keyframe)
+        : baseline_(baseline), keyframe_(keyframe) {}
+    
+    static DeltaContext::Baseline* findBaseline(ByteStream& stream, MessageCategoryType category,
+                                                MessageIdType id, size_t field_count) {
+        DeltaContext* context = stream.getDeltaContext();
+        if (!context) {
+            return nullptr;
+        }
+        uint32_t key = (static_cast<uint32_t>(category) << 16) | id;
+        return &context->baseline(key, field_count);
+    }
+    
+    DeltaContext::Baseline* baseline_;
+    bool keyframe_;
+};
+
+// 带字段编号的线路格式
+//
+// 消息体为：uint16版本号、（可选）增量关键帧标志、若干字段、结束标记0。
+// 每个字段以变长整数键 (tag << 3) | 线路类型 开头，读取端可以据此跳过未知字段。
+// 变长块（字符串、数组、嵌套消息）以uint32字节长度开头。
+class TaggedWire {
+public:
+    enum WireType : uint8_t {
+        WIRE_VARINT = 0,
+        WIRE_FIXED8 = 1,
+        WIRE_FIXED16 = 2,
+        WIRE_FIXED32 = 3,
+        WIRE_FIXED64 = 4,
+        WIRE_LENGTH = 5,
+    };
+    
+    // 计算字段键
+    static constexpr uint64_t makeKey(uint32_t tag, WireType wire_type) {
+        return (static_cast<uint64_t>(tag) << 3) | wire_type;
+    }
+    
+    // 写入字段键
+    static void writeKey(ByteStream& stream, uint64_t key) {
+        stream.writeVarint(key);
+    }
+    
+    // 写入结束标记
+    static void writeEnd(ByteStream& stream) {
+        stream.writeVarint(0);
+    }
+    
+    // 读取字段键，结束或出错时返回0
+    static uint64_t readKey(ByteStream& stream) {
+        uint64_t key = 0;
+        if (!stream.readVarint(key)) {
+            return 0;
+        }
+        return key;
+    }
+    
+    // 开始变长块，返回长度占位的位置
+    static size_t beginLength(ByteStream& stream) {
+        size_t mark = stream.getWritePosition();
+        stream.write(static_cast<uint32_t>(0));
+        return mark;
+    }
+    
+    // 结束变长块，回填长度
+    static void endLength(ByteStream& stream, size_t mark) {
+        uint32_t length = static_cast<uint32_t>(stream.getWritePosition() - mark - sizeof(uint32_t));
+        stream.patchBytes(mark, &length, sizeof(length));
+    }
+    
+    // 读取变长块长度，返回块结束位置
+    static size_t readLength(ByteStream& stream) {
+        uint32_t length = 0;
+        stream.read(length);
+        if (length > stream.remaining()) {
+            stream.setError();
+            return stream.getReadPosition();
+        }
+        return stream.getReadPosition() + length;
+    }
+    
+    // 完成变长块读取，跳过块中未读取的部分（新版本追加的内容）
+    static void finishLength(ByteStream& stream, size_t end) {
+        size_t position = stream.getReadPosition();
+        if (position > end) {
+            stream.setError();
+        } else {
+            stream.skip(end - position);
+        }
+    }
+    
+    // 写入字符串（变长块），支持任意分配器的字符串（如std::pmr::string）
+    template<typename Alloc>
+    static void writeString(ByteStream& stream, const std::basic_string<char, std::char_traits<char>, Alloc>& value) {
+        stream.write(static_cast<uint32_t>(value.size()));
+        stream.writeBytes(value.data(), value.size());
+    }
+    
+    // 读取字符串（变长块）
+    template<typename Alloc>
+    static void readString(ByteStream& stream, std::basic_string<char, std::char_traits<char>, Alloc>& value) {
+        uint32_t length = 0;
+        stream.read(length);
+        const uint8_t* data = stream.readView(length);
+        if (data) {
+            value.assign(reinterpret_cast<const char*>(data), length);
+        }
+    }
+    
+    // 跳过未知字段
+    static void skipField(ByteStream& stream, uint64_t key) {
+        switch (static_cast<WireType>(key & 0x07)) {
+            case WIRE_VARINT: {
+                uint64_t value = 0;
+                stream.readVarint(value);
+                break;
+            }
+            case WIRE_FIXED8:
+                stream.skip(1);
+                break;
+            case WIRE_FIXED16:
+                stream.skip(2);
+                break;
+            case WIRE_FIXED32:
+                stream.skip(4);
+                break;
+            case WIRE_FIXED64:
+                stream.skip(8);
+                break;
+            case WIRE_LENGTH: {
+                uint32_t length = 0;
+                stream.read(length);
+                stream.skip(length);
+                break;
+            }
+            default:
+                stream.setError();
+                break;
+        }
+    }
+};
+
 // 类型特征，用于类型安全和序列化
 template<typename T>
 struct TypeTraits {
@@ -63,6 +351,48 @@ struct TypeTraits {
     static void deserialize(ByteStream& stream, T& value);
 };
 
+// 紧凑布局中的数组视图
+//
+// 直接引用接收缓冲区中按主机字节序存放的元素，不做拷贝。元素可能未对齐，
+// 因此按值读取（memcpy）。视图只在底层缓冲区有效期内可用。
+template<typename T>
+class PackedArray {
+    static_assert(std::is_trivially_copyable<T>::value, "PackedArray requires trivially copyable elements");
+    
+public:
+    PackedArray() : data_(nullptr), size_(0) {}
+    PackedArray(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    
+    // 元素数量
+    size_t size() const { return size_; }
+    
+    // 是否为空
+    bool empty() const { return size_ == 0; }
+    
+    // 读取第index个元素
+    T operator[](size_t index) const {
+        T value;
+        std::memcpy(&value, data_ + index * sizeof(T), sizeof(T));
+        return value;
+    }
+    
+    // 原始字节
+    const uint8_t* data() const { return data_; }
+    
+    // 拷贝为vector
+    std::vector<T> toVector() const {
+        std::vector<T> result(size_);
+        if (size_ > 0) {
+            std::memcpy(result.data(), data_, size_ * sizeof(T));
+        }
+        return result;
+    }
+    
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
 // 字段信息结构，用于反射
 struct FieldInfo {
     std::string name;
@@ -71,6 +401,7 @@ struct FieldInfo {
     std::string description;
     bool is_vector;
     bool is_required;
+    FieldEncoding encoding;
     
     FieldInfo(
         const std::string& name_,
@@ -78,9 +409,11 @@ struct FieldInfo {
         const std::string& type_name_,
         const std::string& description_ = "",
         bool is_vector_ = false,
-        bool is_required_ = true
+        bool is_required_ = true,
+        FieldEncoding encoding_ = FIELD_ENCODING_FIXED
     ) : name(name_), type(type_), type_name(type_name_), 
-        description(description_), is_vector(is_vector_), is_required(is_required_) {}
+        description(description_), is_vector(is_vector_), is_required(is_required_),
+        encoding(encoding_) {}
 };
 
 // 消息信息结构，用于注册
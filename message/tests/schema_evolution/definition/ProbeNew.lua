@@ -0,0 +1,46 @@
+-- 线路格式兼容性测试：新版本定义（删除tag 3，新增tag 5、6）
+
+messages = {
+    ProbeNew = {
+        category = 250, -- 测试类别
+        id = 2,         -- 消息ID（与旧版本区分，便于链接到同一程序）
+        desc = "兼容性测试消息（版本2）",
+        version = 2,    -- 版本号
+        fields = {
+            uid = {
+                tag = 1,
+                type = "uint32",
+                desc = "编号",
+                required = true
+            },
+            nick = {
+                tag = 2,
+                type = "string",
+                desc = "名称",
+                required = true
+            },
+            -- tag 3 已删除，不再使用
+            level = {
+                tag = 4,
+                type = "uint16",
+                desc = "等级",
+                required = false,
+                default = "1"
+            },
+            title = {
+                tag = 5,
+                type = "string",
+                desc = "称号",
+                required = false,
+                default = "novice"
+            },
+            items = {
+                tag = 6,
+                type = "array<uint32>",
+                desc = "物品ID列表",
+                encoding = "varint",
+                required = false
+            }
+        }
+    }
+}
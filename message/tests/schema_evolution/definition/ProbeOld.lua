@@ -0,0 +1,39 @@
+-- 线路格式兼容性测试：旧版本定义（与 ProbeNew.lua 为同一消息的两个版本）
+
+messages = {
+    ProbeOld = {
+        category = 250, -- 测试类别
+        id = 1,         -- 消息ID
+        desc = "兼容性测试消息（版本1）",
+        version = 1,    -- 版本号
+        fields = {
+            uid = {
+                tag = 1,
+                type = "uint32",
+                desc = "编号",
+                required = true
+            },
+            nick = {
+                tag = 2,
+                type = "string",
+                desc = "名称",
+                required = true
+            },
+            score = {
+                tag = 3,
+                type = "int32",
+                desc = "分数（版本2已删除）",
+                encoding = "zigzag",
+                required = false,
+                default = "7"
+            },
+            level = {
+                tag = 4,
+                type = "uint16",
+                desc = "等级",
+                required = false,
+                default = "1"
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+// 线路格式兼容性测试
+//
+// ProbeOld（版本1）与 ProbeNew（版本2）由 definition/ 下的定义生成，是同一
+// 消息的两个版本：新版本删除了tag 3，新增了tag 5、6。测试两个方向的互相
+// 解析（跳过未知字段、缺失字段恢复默认值）以及同版本的快速路径。
+
+#include "message/generated/msg_ProbeOld.h"
+#include "message/generated/msg_ProbeNew.h"
+#include <iostream>
+#include <vector>
+
+using namespace next_gen;
+using namespace next_gen::message;
+
+namespace {
+
+int failures = 0;
+
+#define SCHEMA_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+template<typename T>
+std::vector<u8> encode(const T& message) {
+    ByteStream stream;
+    message.serialize(stream);
+    SCHEMA_CHECK(stream.getData().size() == message.getSerializedSize());
+    return stream.getData();
+}
+
+// 解析整个缓冲区，要求无错误且没有剩余数据
+template<typename T>
+void decode(const std::vector<u8>& bytes, T& message) {
+    ByteStream stream(bytes);
+    message.deserialize(stream);
+    SCHEMA_CHECK(!stream.hasError());
+    SCHEMA_CHECK(stream.remaining() == 0);
+}
+
+ProbeOldMessage makeOld() {
+    ProbeOldMessage message;
+    message.setUid(1001);
+    message.setNick("old-client");
+    message.setScore(-42);
+    message.setLevel(12);
+    return message;
+}
+
+ProbeNewMessage makeNew() {
+    ProbeNewMessage message;
+    message.setUid(2002);
+    message.setNick("new-client");
+    message.setLevel(30);
+    message.setTitle("veteran");
+    message.setItems({1, 300, 70000});
+    return message;
+}
+
+// 新版本发送、旧版本接收：tag 5、6 未知被跳过，tag 3 缺失恢复默认值
+void testNewToOld() {
+    ProbeOldMessage decoded;
+    decoded.setScore(99);
+    decode(encode(makeNew()), decoded);
+
+    SCHEMA_CHECK(decoded.getUid() == 2002);
+    SCHEMA_CHECK(decoded.getNick() == "new-client");
+    SCHEMA_CHECK(decoded.getLevel() == 30);
+    SCHEMA_CHECK(decoded.getScore() == 7);
+}
+
+// 旧版本发送、新版本接收：tag 3 未知被跳过，tag 5、6 缺失恢复默认值
+void testOldToNew() {
+    ProbeNewMessage decoded;
+    decoded.setTitle("stale");
+    decoded.setItems({5});
+    decode(encode(makeOld()), decoded);
+
+    SCHEMA_CHECK(decoded.getUid() == 1001);
+    SCHEMA_CHECK(decoded.getNick() == "old-client");
+    SCHEMA_CHECK(decoded.getLevel() == 12);
+    SCHEMA_CHECK(decoded.getTitle() == "novice");
+    SCHEMA_CHECK(decoded.getItems().empty());
+}
+
+// 同版本：按编号顺序匹配全部字段的快速路径
+void testSameVersion() {
+    ProbeOldMessage old_decoded;
+    decode(encode(makeOld()), old_decoded);
+    SCHEMA_CHECK(old_decoded.getUid() == 1001);
+    SCHEMA_CHECK(old_decoded.getNick() == "old-client");
+    SCHEMA_CHECK(old_decoded.getScore() == -42);
+    SCHEMA_CHECK(old_decoded.getLevel() == 12);
+
+    ProbeNewMessage new_decoded;
+    decode(encode(makeNew()), new_decoded);
+    SCHEMA_CHECK(new_decoded.getUid() == 2002);
+    SCHEMA_CHECK(new_decoded.getNick() == "new-client");
+    SCHEMA_CHECK(new_decoded.getLevel() == 30);
+    SCHEMA_CHECK(new_decoded.getTitle() == "veteran");
+    SCHEMA_CHECK((new_decoded.getItems() == std::vector<uint32_t>{1, 300, 70000}));
+
+    // 同版本但缺少字段时回退到通用路径，缺失字段仍恢复默认值
+    ProbeNewMessage sparse = makeNew();
+    sparse.setItems({});
+    ProbeNewMessage sparse_decoded;
+    decode(encode(sparse), sparse_decoded);
+    SCHEMA_CHECK(sparse_decoded.getTitle() == "veteran");
+    SCHEMA_CHECK(sparse_decoded.getItems().empty());
+}
+
+// 截断的消息必须报告错误
+void testTruncated() {
+    std::vector<u8> bytes = encode(makeNew());
+    bytes.resize(bytes.size() / 2);
+    ProbeOldMessage decoded;
+    ByteStream stream(bytes);
+    decoded.deserialize(stream);
+    SCHEMA_CHECK(stream.hasError());
+}
+
+} // namespace
+
+int main() {
+    testNewToOld();
+    testOldToNew();
+    testSameVersion();
+    testTruncated();
+
+    if (failures != 0) {
+        std::cerr << failures << " schema evolution check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Schema evolution checks passed" << std::endl;
+    return 0;
+}
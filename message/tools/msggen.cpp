@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include <filesystem>
 #include "../generator/generator.h"
 #include "../include/types.h"
@@ -15,6 +16,9 @@ void printUsage(const char* program_name) {
     std::cout << "  -o, --output DIR    Output directory for generated C++ files" << std::endl;
     std::cout << "  -t, --template DIR  Template directory" << std::endl;
     std::cout << "  -f, --file FILE     Process only specified Lua file" << std::endl;
+    std::cout << "  -p, --packed        Generate packed zero-copy serializers for all messages" << std::endl;
+    std::cout << "  -j, --jobs N        Number of generator threads (default: hardware threads)" << std::endl;
+    std::cout << "  -F, --force         Regenerate all files, ignoring the incremental manifest" << std::endl;
     std::cout << "  -v, --verbose       Enable verbose output" << std::endl;
     std::cout << "  -h, --help          Display this help message" << std::endl;
 }
@@ -37,6 +41,17 @@ int main(int argc, char* argv[]) {
             return 0;
         } else if (arg == "-v" || arg == "--verbose") {
             config.verbose = true;
+        } else if (arg == "-p" || arg == "--packed") {
+            config.packed_layout = true;
+        } else if (arg == "-F" || arg == "--force") {
+            config.incremental = false;
+        } else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc) {
+                config.jobs = std::atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: Missing job count" << std::endl;
+                return 1;
+            }
         } else if (arg == "-i" || arg == "--input") {
             if (i + 1 < argc) {
                 config.input_dir = argv[++i];
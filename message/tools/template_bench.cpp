@@ -0,0 +1,304 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include "../generator/template_engine.h"
+
+using namespace next_gen::message::generator;
+
+namespace {
+
+/**
+ * @brief 旧的正则模板引擎，仅用于对比
+ *
+ * 每次渲染都重新扫描模板：先展开循环，再处理条件，最后替换变量。
+ */
+class RegexTemplateEngine {
+public:
+    void loadFromString(const std::string& content) { template_content_ = content; }
+
+    void setVariable(const std::string& name, const std::string& value) { variables_[name] = value; }
+
+    void setCondition(const std::string& name, bool value) { conditions_[name] = value; }
+
+    void setLoop(const std::string& loop_name, int item_count,
+                 std::function<std::string(const std::string&, int)> handler) {
+        loops_[loop_name] = [item_count, handler](const std::string& loop_body) -> std::string {
+            std::stringstream result;
+            for (int i = 0; i < item_count; ++i) {
+                result << handler(loop_body, i);
+            }
+            return result.str();
+        };
+    }
+
+    std::string render() const {
+        return replaceVariables(processConditions(processLoops(template_content_)));
+    }
+
+private:
+    std::string replaceVariables(const std::string& content) const {
+        std::regex var_regex("\\{\\{\\s*([a-zA-Z0-9_]+)\\s*\\}\\}");
+        std::smatch match;
+        std::string::const_iterator search_start(content.cbegin());
+        std::string result;
+        while (std::regex_search(search_start, content.cend(), match, var_regex)) {
+            result.append(match.prefix());
+            auto it = variables_.find(match[1].str());
+            result.append(it != variables_.end() ? it->second : match[0].str());
+            search_start = match.suffix().first;
+        }
+        result.append(search_start, content.cend());
+        return result;
+    }
+
+    std::string processConditions(const std::string& content) const {
+        std::string result = replaceConditions(content,
+            "\\{\\%\\s*if\\s+([a-zA-Z0-9_]+)\\s*\\%\\}((?:(?!\\{\\%\\s*else\\s*\\%\\})[\\s\\S])+?)\\{\\%\\s*endif\\s*\\%\\}",
+            false);
+        return replaceConditions(result,
+            "\\{\\%\\s*if\\s+([a-zA-Z0-9_]+)\\s*\\%\\}([\\s\\S]+?)\\{\\%\\s*else\\s*\\%\\}([\\s\\S]+?)\\{\\%\\s*endif\\s*\\%\\}",
+            true);
+    }
+
+    std::string replaceConditions(const std::string& content, const char* pattern, bool has_else) const {
+        std::regex if_regex(pattern);
+        std::smatch match;
+        std::string::const_iterator search_start(content.cbegin());
+        std::string result;
+        while (std::regex_search(search_start, content.cend(), match, if_regex)) {
+            result.append(match.prefix());
+            auto it = conditions_.find(match[1].str());
+            bool value = it != conditions_.end() && it->second;
+            if (value) {
+                result.append(match[2].str());
+            } else if (has_else) {
+                result.append(match[3].str());
+            }
+            search_start = match.suffix().first;
+        }
+        result.append(search_start, content.cend());
+        return result;
+    }
+
+    std::string processLoops(const std::string& content) const {
+        std::string result = content;
+        for (const auto& loop_pair : loops_) {
+            std::string start_tag = "{% for " + loop_pair.first + " %}";
+            size_t start_pos = 0;
+            while ((start_pos = result.find(start_tag, start_pos)) != std::string::npos) {
+                size_t body_start = start_pos + start_tag.size();
+                if (body_start < result.size() && result[body_start] == '\n') {
+                    ++body_start;
+                }
+                size_t end_pos = result.find("{% endfor %}", body_start);
+                if (end_pos == std::string::npos) {
+                    start_pos += start_tag.size();
+                    continue;
+                }
+                size_t replace_end = end_pos + 12;
+                if (replace_end < result.size() && result[replace_end] == '\n') {
+                    ++replace_end;
+                }
+                std::string expanded = loop_pair.second(result.substr(body_start, end_pos - body_start));
+                result.replace(start_pos, replace_end - start_pos, expanded);
+                start_pos += expanded.size();
+            }
+        }
+        return result;
+    }
+
+    std::string template_content_;
+    std::map<std::string, std::string> variables_;
+    std::map<std::string, bool> conditions_;
+    std::map<std::string, std::function<std::string(const std::string&)>> loops_;
+};
+
+// 与生成器头文件模板结构相似的合成模板
+const char* BENCH_TEMPLATE =
+    "#pragma once\n"
+    "\n"
+    "namespace {{ namespace_name }} {\n"
+    "\n"
+    "/**\n"
+    " * @brief {{ message_name }}\n"
+    " * @category {{ message_category }}\n"
+    " * @id {{ message_id }}\n"
+    " */\n"
+    "class {{ message_class_name }} : public MessageBase {\n"
+    "public:\n"
+    "    static constexpr MessageCategoryType CATEGORY = {{ message_category }};\n"
+    "    static constexpr MessageIdType ID = {{ message_id }};\n"
+    "\n"
+    "{% for field %}\n"
+    "    /**\n"
+    "     * @brief {{ field_description }}\n"
+    "     */\n"
+    "    const {{ field_cpp_type }}& get{{ field_name_capitalized }}() const { return {{ field_name_lower }}; }\n"
+    "    void set{{ field_name_capitalized }}(const {{ field_cpp_type }}& value) { {{ field_name_lower }} = value; }\n"
+    "{% if field_is_vector %}    size_t get{{ field_name_capitalized }}Count() const { return {{ field_name_lower }}.size(); }\n"
+    "{% endif %}\n"
+    "{% endfor %}\n"
+    "{% if has_fields %}private:\n"
+    "{% for field %}\n"
+    "    {{ field_cpp_type }} {{ field_name_lower }};\n"
+    "{% endfor %}\n"
+    "{% else %}    // 没有字段\n"
+    "{% endif %}\n"
+    "};\n"
+    "\n"
+    "} // namespace {{ namespace_name }}\n";
+
+// 合成消息定义
+struct BenchField {
+    std::string name;
+    std::string cpp_type;
+    bool is_vector;
+};
+
+struct BenchMessage {
+    std::string name;
+    int category;
+    int id;
+    std::vector<BenchField> fields;
+};
+
+std::vector<BenchMessage> makeMessages(int message_count, int field_count) {
+    static const char* types[] = {"int32_t", "uint64_t", "std::string", "float", "uint8_t"};
+    std::vector<BenchMessage> messages;
+    for (int m = 0; m < message_count; ++m) {
+        BenchMessage message{"Message" + std::to_string(m), m / 64 + 1, m % 64 + 1, {}};
+        for (int f = 0; f < field_count; ++f) {
+            bool is_vector = f % 7 == 3;
+            std::string type = types[(m + f) % 5];
+            message.fields.push_back(BenchField{"field" + std::to_string(f),
+                                                is_vector ? "std::vector<" + type + ">" : type, is_vector});
+        }
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+std::string capitalize(std::string name) {
+    if (!name.empty()) {
+        name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+    }
+    return name;
+}
+
+// 旧引擎：每个字段新建引擎并重新解析循环体
+std::string renderRegex(const BenchMessage& message) {
+    RegexTemplateEngine engine;
+    engine.loadFromString(BENCH_TEMPLATE);
+    engine.setVariable("namespace_name", "bench");
+    engine.setVariable("message_name", message.name);
+    engine.setVariable("message_class_name", message.name + "Message");
+    engine.setVariable("message_category", std::to_string(message.category));
+    engine.setVariable("message_id", std::to_string(message.id));
+    engine.setCondition("has_fields", !message.fields.empty());
+    engine.setLoop("field", static_cast<int>(message.fields.size()),
+                   [&message](const std::string& loop_body, int index) -> std::string {
+        const auto& field = message.fields[index];
+        RegexTemplateEngine field_engine;
+        field_engine.loadFromString(loop_body);
+        field_engine.setVariable("field_description", field.name + " field");
+        field_engine.setVariable("field_cpp_type", field.cpp_type);
+        field_engine.setVariable("field_name_capitalized", capitalize(field.name));
+        field_engine.setVariable("field_name_lower", field.name);
+        field_engine.setCondition("field_is_vector", field.is_vector);
+        return field_engine.render();
+    });
+    return engine.render();
+}
+
+// 编译引擎：模板只编译一次，循环在同一个引擎上设置变量
+void renderCompiled(const std::shared_ptr<const CompiledTemplate>& compiled, const BenchMessage& message,
+                    std::string& output) {
+    TemplateEngine engine(compiled);
+    engine.setVariable("namespace_name", "bench");
+    engine.setVariable("message_name", message.name);
+    engine.setVariable("message_class_name", message.name + "Message");
+    engine.setVariable("message_category", std::to_string(message.category));
+    engine.setVariable("message_id", std::to_string(message.id));
+    engine.setCondition("has_fields", !message.fields.empty());
+    engine.setLoop("field", static_cast<int>(message.fields.size()),
+                   [&message](TemplateEngine& field_engine, int index) {
+        const auto& field = message.fields[index];
+        field_engine.setVariable("field_description", field.name + " field");
+        field_engine.setVariable("field_cpp_type", field.cpp_type);
+        field_engine.setVariable("field_name_capitalized", capitalize(field.name));
+        field_engine.setVariable("field_name_lower", field.name);
+        field_engine.setCondition("field_is_vector", field.is_vector);
+    });
+    engine.render(output);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int message_count = argc > 1 ? std::atoi(argv[1]) : 200;
+    int field_count = argc > 2 ? std::atoi(argv[2]) : 20;
+    if (message_count <= 0 || field_count < 0) {
+        std::cerr << "Usage: " << argv[0] << " [messages=200] [fields=20]" << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchMessage> messages = makeMessages(message_count, field_count);
+    std::cout << "Rendering " << message_count << " messages with " << field_count << " fields" << std::endl;
+
+    // 旧引擎
+    size_t regex_bytes = 0;
+    std::vector<std::string> regex_outputs;
+    regex_outputs.reserve(messages.size());
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& message : messages) {
+        regex_outputs.push_back(renderRegex(message));
+        regex_bytes += regex_outputs.back().size();
+    }
+    double regex_ms = elapsedMs(start);
+
+    // 编译引擎（计入编译时间）
+    size_t compiled_bytes = 0;
+    size_t mismatches = 0;
+    std::string output;
+    start = std::chrono::steady_clock::now();
+    std::string error;
+    auto compiled = CompiledTemplate::compile(BENCH_TEMPLATE, &error);
+    if (!compiled) {
+        std::cerr << "Failed to compile template: " << error << std::endl;
+        return 1;
+    }
+    double compiled_ms = 0.0;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        output.clear();
+        renderCompiled(compiled, messages[i], output);
+        compiled_bytes += output.size();
+
+        // 校验时间不计入
+        compiled_ms += elapsedMs(start);
+        if (output != regex_outputs[i]) {
+            ++mismatches;
+        }
+        start = std::chrono::steady_clock::now();
+    }
+
+    std::cout << "  regex:    " << regex_ms << " ms (" << regex_bytes << " bytes)" << std::endl;
+    std::cout << "  compiled: " << compiled_ms << " ms (" << compiled_bytes << " bytes)" << std::endl;
+    if (compiled_ms > 0.0) {
+        std::cout << "  speedup:  " << regex_ms / compiled_ms << "x" << std::endl;
+    }
+    if (mismatches > 0) {
+        std::cerr << "Output mismatch in " << mismatches << " message(s)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../../include/core/admission.h"
+#include "../../include/core/message_bus.h"
+#include "../../include/utils/logger.h"
+#include <cmath>
+
+namespace next_gen {
+
+const char* shedReasonName(ShedReason reason) {
+    switch (reason) {
+        case ShedReason::NONE: return "none";
+        case ShedReason::QUEUE_FULL: return "queue_full";
+        case ShedReason::LOW_PRIORITY: return "low_priority";
+        case ShedReason::QUEUE_DELAY: return "queue_delay";
+        default: return "unknown";
+    }
+}
+
+AdmissionController::AdmissionController(const std::string& service_name, const AdmissionConfig& config)
+    : config_(config),
+      shed_watermark_(config.shed_watermark != 0 ? config.shed_watermark : config.max_queue_depth / 4 * 3),
+      target_ns_(static_cast<u64>(config.target_delay_ms) * 1000000),
+      interval_ns_(static_cast<u64>(config.interval_ms != 0 ? config.interval_ms : 100) * 1000000),
+      overloaded_(false),
+      first_above_ns_(0),
+      drop_next_ns_(0),
+      drop_count_(0) {
+    auto& registry = MetricsRegistry::instance();
+    shed_[0] = nullptr;
+    for (size_t i = 1; i < static_cast<size_t>(ShedReason::COUNT); ++i) {
+        shed_[i] = &registry.counter("next_gen_service_shed_total", "Messages shed by admission control",
+                                     {{"service", service_name}, {"reason", shedReasonName(static_cast<ShedReason>(i))}});
+    }
+}
+
+bool AdmissionController::isControl(const Message& message) {
+    if (!message.isEnvelope()) {
+        return false;
+    }
+    EnvelopeKind kind = static_cast<const MessageEnvelope&>(message).getKind();
+    return kind != EnvelopeKind::SEND && kind != EnvelopeKind::REQUEST;
+}
+
+ShedReason AdmissionController::admit(const Message& message, size_t depth) const {
+    if (isControl(message)) {
+        return ShedReason::NONE;
+    }
+    if (config_.max_queue_depth != 0 && depth >= config_.max_queue_depth) {
+        return ShedReason::QUEUE_FULL;
+    }
+    if (!isSheddable(message)) {
+        return ShedReason::NONE;
+    }
+    if (overloaded_.load(std::memory_order_relaxed)) {
+        return ShedReason::QUEUE_DELAY;
+    }
+
+    // Cut-off rises from 1 at the watermark to sheddable_categories at the limit
+    if (config_.max_queue_depth != 0 && depth >= shed_watermark_) {
+        size_t span = config_.max_queue_depth - shed_watermark_;
+        size_t cutoff = 1 + (config_.sheddable_categories - 1) * (depth - shed_watermark_) / (span != 0 ? span : 1);
+        if (message.getCategory() < cutoff) {
+            return ShedReason::LOW_PRIORITY;
+        }
+    }
+    return ShedReason::NONE;
+}
+
+bool AdmissionController::shouldDrop(const Message& message, u64 now_ns) {
+    if (target_ns_ == 0) {
+        return false;
+    }
+
+    u64 enqueue_ns = message.getEnqueueTime();
+    u64 delay_ns = (enqueue_ns != 0 && now_ns > enqueue_ns) ? now_ns - enqueue_ns : 0;
+
+    // Below target: leave the dropping state
+    if (delay_ns < target_ns_) {
+        first_above_ns_ = 0;
+        overloaded_.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Above target: start dropping only after a whole interval
+    if (first_above_ns_ == 0) {
+        first_above_ns_ = now_ns + interval_ns_;
+        return false;
+    }
+
+    if (!overloaded_.load(std::memory_order_relaxed)) {
+        if (now_ns < first_above_ns_) {
+            return false;
+        }
+        overloaded_.store(true, std::memory_order_relaxed);
+        NEXT_GEN_LOG_WARNING_LIMITED("Queue delay above target, shedding low priority messages", 1);
+
+        // Resume near the previous drop rate if the last episode was recent
+        bool recent = drop_count_ > 2 && now_ns < drop_next_ns_ + 16 * interval_ns_;
+        drop_count_ = recent ? drop_count_ - 2 : 0;
+        drop_next_ns_ = now_ns;
+    }
+
+    if (now_ns < drop_next_ns_ || !isSheddable(message)) {
+        return false;
+    }
+    ++drop_count_;
+    drop_next_ns_ = now_ns + controlLaw(drop_count_);
+    return true;
+}
+
+void AdmissionController::onQueueDrained() {
+    // No standing queue left; admit() would otherwise keep rejecting
+    // sheddable messages that no dequeue can clear
+    first_above_ns_ = 0;
+    overloaded_.store(false, std::memory_order_relaxed);
+}
+
+u64 AdmissionController::controlLaw(u64 count) const {
+    return static_cast<u64>(static_cast<double>(interval_ns_) / std::sqrt(static_cast<double>(count)));
+}
+
+AdmissionStats AdmissionController::getStats() const {
+    AdmissionStats stats;
+    for (size_t i = 1; i < static_cast<size_t>(ShedReason::COUNT); ++i) {
+        stats.shed[i] = shed_[i]->value();
+    }
+    stats.overloaded = isOverloaded();
+    return stats;
+}
+
+} // namespace next_gen
@@ -0,0 +1,162 @@
+#include "../../include/core/message_bus.h"
+#include "../../include/core/service.h"
+
+namespace next_gen {
+
+namespace {
+
+thread_local RequestContext current_request;
+
+} // namespace
+
+// Service handle
+
+Result<void> ServiceHandle::post(std::unique_ptr<Message> message) const {
+    if (!message) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Message cannot be null");
+    }
+    auto service = service_.lock();
+    if (!service) {
+        return Result<void>(ErrorCode::SERVICE_NOT_FOUND, "Service not available");
+    }
+    return service->postMessage(std::move(message));
+}
+
+Result<void> ServiceHandle::send(std::shared_ptr<const Message> message) const {
+    if (!message) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Message cannot be null");
+    }
+    return post(std::make_unique<MessageEnvelope>(EnvelopeKind::SEND, std::move(message)));
+}
+
+// Message bus
+
+MessageBus& MessageBus::instance() {
+    static MessageBus instance;
+    return instance;
+}
+
+Result<ServiceHandle> MessageBus::registerService(std::shared_ptr<Service> service) {
+    if (!service) {
+        return Result<ServiceHandle>(ErrorCode::INVALID_ARGUMENT, "Service cannot be null");
+    }
+
+    std::string name = service->getName();
+    ServiceId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = names_.find(name);
+        if (it != names_.end() && !services_[it->second - 1].service.expired()) {
+            return Result<ServiceHandle>(ErrorCode::SERVICE_ALREADY_EXISTS, "Service already registered: " + name);
+        }
+        services_.push_back(Entry{name, service});
+        id = static_cast<ServiceId>(services_.size());
+        names_[name] = id;
+    }
+
+    // Services built on BaseService can send requests and receive responses
+    auto base_service = std::dynamic_pointer_cast<BaseService>(service);
+    if (base_service) {
+        base_service->bus_id_.store(id, std::memory_order_release);
+    }
+
+    NEXT_GEN_LOG_DEBUG("Registered service on message bus: " + name + " (id " + std::to_string(id) + ")");
+    return Result<ServiceHandle>(ServiceHandle(id, service));
+}
+
+Result<void> MessageBus::unregisterService(const std::string& name) {
+    std::shared_ptr<Service> service;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = names_.find(name);
+        if (it == names_.end()) {
+            return Result<void>(ErrorCode::SERVICE_NOT_FOUND, "Service not registered: " + name);
+        }
+        Entry& entry = services_[it->second - 1];
+        service = entry.service.lock();
+        entry.service.reset();
+        names_.erase(it);
+    }
+
+    auto base_service = std::dynamic_pointer_cast<BaseService>(service);
+    if (base_service) {
+        base_service->bus_id_.store(INVALID_SERVICE_ID, std::memory_order_release);
+    }
+    return Result<void>();
+}
+
+ServiceHandle MessageBus::resolve(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(name);
+    if (it == names_.end()) {
+        return ServiceHandle();
+    }
+    return ServiceHandle(it->second, services_[it->second - 1].service);
+}
+
+ServiceHandle MessageBus::resolve(ServiceId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id == INVALID_SERVICE_ID || id > services_.size()) {
+        return ServiceHandle();
+    }
+    return ServiceHandle(id, services_[id - 1].service);
+}
+
+Result<void> MessageBus::send(const std::string& name, std::shared_ptr<const Message> message) const {
+    return resolve(name).send(std::move(message));
+}
+
+Result<void> MessageBus::send(ServiceId id, std::shared_ptr<const Message> message) const {
+    return resolve(id).send(std::move(message));
+}
+
+size_t MessageBus::publish(const std::vector<ServiceHandle>& targets, std::shared_ptr<const Message> message) const {
+    size_t delivered = 0;
+    for (const auto& target : targets) {
+        if (!target.send(message).has_error()) {
+            ++delivered;
+        }
+    }
+    return delivered;
+}
+
+Result<void> MessageBus::reply(std::shared_ptr<const Message> response) const {
+    return reply(current_request, std::move(response));
+}
+
+Result<void> MessageBus::reply(const RequestContext& request, std::shared_ptr<const Message> response) const {
+    if (!request.valid()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "No request to reply to");
+    }
+    if (!response) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Response cannot be null");
+    }
+    return resolve(request.source).post(std::make_unique<MessageEnvelope>(
+        EnvelopeKind::RESPONSE, std::move(response), INVALID_SERVICE_ID, request.correlation_id));
+}
+
+RequestContext MessageBus::currentRequest() {
+    return current_request;
+}
+
+std::vector<std::string> MessageBus::getServiceNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    names.reserve(names_.size());
+    for (const auto& pair : names_) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
+// Request scope
+
+RequestScope::RequestScope(const RequestContext& request) : previous_(current_request) {
+    current_request = request;
+}
+
+RequestScope::~RequestScope() {
+    current_request = previous_;
+}
+
+} // namespace next_gen
@@ -1,223 +1,941 @@
 #include "../../include/core/service.h"
+#include "../../include/module/module.h"
+#include "../../include/module/module_events.h"
 #include <chrono>
 #include <algorithm>
+#include <functional>
+#include <iterator>
 
 namespace next_gen {
 
-// Base service implementation methods
-
-Result<void> BaseService::registerMessageHandler(
-    MessageCategoryType category,
-    MessageIdType id,
-    std::unique_ptr<MessageHandler> handler) {
-    
-    if (!handler) {
-        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Handler cannot be null");
-    }
-    
-    auto key = makeHandlerKey(category, id);
-    
-    std::lock_guard<std::mutex> lock(handlers_mutex_);
-    auto it = message_handlers_.find(key);
-    if (it != message_handlers_.end()) {
-        return Result<void>(ErrorCode::HANDLER_ALREADY_REGISTERED, 
-            "Handler already registered for category " + 
-            std::to_string(category) + " and id " + std::to_string(id));
-    }
-    
-    message_handlers_[key] = std::move(handler);
-    
-    Logger::debug("Registered message handler for category {} and id {}", 
-                 category, id);
-    
-    return Result<void>();
+namespace {
+
+const char* modulePhaseName(int phase) {
+    switch (phase) {
+        case 0: return "init";
+        case 1: return "start";
+        default: return "stop";
+    }
+}
+
+std::string formatMillis(u64 duration_ns) {
+    return std::to_string(duration_ns / 1000000) + "." +
+           std::to_string((duration_ns / 100000) % 10) + " ms";
+}
+
+// Copy of a snapshot with one module added or removed
+std::unique_ptr<ModuleSnapshot> withModule(const ModuleSnapshot& current, const std::string& name,
+                                           const std::shared_ptr<ModuleInterface>& module, u32 type) {
+    std::unique_ptr<ModuleSnapshot> snapshot(new ModuleSnapshot(current));
+    snapshot->modules.push_back(module);
+    snapshot->by_name[name] = module;
+    // The first module registered with a type owns the type slot
+    if (type != INVALID_MODULE_TYPE) {
+        if (snapshot->by_type.size() <= type) {
+            snapshot->by_type.resize(type + 1);
+        }
+        if (!snapshot->by_type[type]) {
+            snapshot->by_type[type] = module;
+        }
+    }
+    return snapshot;
+}
+
+std::unique_ptr<ModuleSnapshot> withoutModule(const ModuleSnapshot& current,
+                                              const std::shared_ptr<ModuleInterface>& module) {
+    std::unique_ptr<ModuleSnapshot> snapshot(new ModuleSnapshot(current));
+    snapshot->modules.erase(std::remove(snapshot->modules.begin(), snapshot->modules.end(), module),
+                            snapshot->modules.end());
+    for (auto it = snapshot->by_name.begin(); it != snapshot->by_name.end();) {
+        it = it->second == module ? snapshot->by_name.erase(it) : std::next(it);
+    }
+    for (auto& slot : snapshot->by_type) {
+        if (slot == module) {
+            slot.reset();
+        }
+    }
+    return snapshot;
+}
+
+} // namespace
+
+// Module snapshot readers
+
+size_t ModuleReaders::shardIndex() {
+    static std::atomic<size_t> next_index(0);
+    thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return index;
 }
 
+bool ModuleReaders::idle() const {
+    // A read starting after this sees the snapshot stored before it
+    for (const auto& shard : shards_) {
+        if (shard.count.load(std::memory_order_seq_cst) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+u32 allocateModuleTypeId() {
+    static std::atomic<u32> next_type(0);
+    return next_type.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Base service module management
+
 Result<void> BaseService::registerModule(std::shared_ptr<ModuleInterface> module) {
     if (!module) {
         return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module cannot be null");
     }
-    
-    std::string module_name = module->getName();
-    
-    return registerModuleWithName(module_name, module);
+
+    return registerModuleImpl(module->getName(), module, INVALID_MODULE_TYPE);
 }
 
 Result<void> BaseService::registerModuleWithName(
-    const std::string& name, 
+    const std::string& name,
     std::shared_ptr<ModuleInterface> module) {
-    
+
+    return registerModuleImpl(name, module, INVALID_MODULE_TYPE);
+}
+
+Result<void> BaseService::registerModuleImpl(
+    const std::string& name,
+    std::shared_ptr<ModuleInterface> module,
+    u32 type) {
+
     if (name.empty()) {
         return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module name cannot be empty");
     }
-    
+
     if (!module) {
         return Result<void>(ErrorCode::INVALID_ARGUMENT, "Module cannot be null");
     }
-    
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    auto it = modules_.find(name);
-    if (it != modules_.end()) {
-        return Result<void>(ErrorCode::MODULE_ALREADY_REGISTERED, 
-            "Module already registered with name: " + name);
-    }
-    
-    modules_[name] = module;
-    
-    Logger::info("Registered module: {}", name);
-    
-    // 初始化模块
-    auto init_result = module->init();
-    if (init_result.has_error()) {
-        // 初始化失败，移除模块
-        modules_.erase(name);
-        return Result<void>(
-            init_result.getError().getCode(),
-            "Failed to initialize module: " + name + 
-            ", error: " + init_result.getError().getMessage()
-        );
-    }
-    
-    // 如果服务已经在运行，则启动模块
-    if (running_) {
-        auto start_result = module->start();
-        if (start_result.has_error()) {
-            // 启动失败，停止并移除模块
+
+    bool initialize = false;
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        const ModuleSnapshot* current = modules_.load(std::memory_order_relaxed);
+        if (current->by_name.find(name) != current->by_name.end()) {
+            return Result<void>(ErrorCode::MODULE_ALREADY_EXISTS,
+                "Module already registered with name: " + name);
+        }
+        publishModules(withModule(*current, name, module, type));
+        initialize = modules_initialized_;
+        start = modules_started_;
+    }
+
+    NEXT_GEN_LOG_DEBUG("Registered module: " + name);
+
+    // Late registration: bring the module up to the service's lifecycle state
+    if (initialize) {
+        auto result = module->init();
+        if (result.has_error()) {
+            std::lock_guard<std::mutex> lock(modules_mutex_);
+            publishModules(withoutModule(*modules_.load(std::memory_order_relaxed), module));
+            return Result<void>(result.error().code(),
+                "Failed to initialize module: " + name + ", error: " + result.error().message());
+        }
+        ModuleEventManager::instance().triggerInitEvent(module);
+    }
+
+    if (start) {
+        auto result = module->start();
+        if (result.has_error()) {
             module->stop();
-            modules_.erase(name);
-            return Result<void>(
-                start_result.getError().getCode(),
-                "Failed to start module: " + name + 
-                ", error: " + start_result.getError().getMessage()
-            );
+            std::lock_guard<std::mutex> lock(modules_mutex_);
+            publishModules(withoutModule(*modules_.load(std::memory_order_relaxed), module));
+            return Result<void>(result.error().code(),
+                "Failed to start module: " + name + ", error: " + result.error().message());
         }
+        {
+            std::lock_guard<std::mutex> lock(modules_mutex_);
+            started_modules_.insert(name);
+            modules_version_.fetch_add(1, std::memory_order_release);
+        }
+        ModuleEventManager::instance().triggerStartEvent(module);
     }
-    
+
+    reclaimModuleSnapshots();
     return Result<void>();
 }
 
 std::shared_ptr<ModuleInterface> BaseService::getModule(const std::string& name) {
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    auto it = modules_.find(name);
-    if (it != modules_.end()) {
+    ModuleReaders::Scope read(module_readers_);
+    const ModuleSnapshot* snapshot = modules_.load(std::memory_order_seq_cst);
+
+    auto it = snapshot->by_name.find(name);
+    if (it != snapshot->by_name.end()) {
         return it->second;
     }
-    
+
     return nullptr;
 }
 
-std::string BaseService::getName() const {
-    return name_;
+std::vector<std::shared_ptr<ModuleInterface>> BaseService::getAllModules() const {
+    ModuleReaders::Scope read(module_readers_);
+    return modules_.load(std::memory_order_seq_cst)->modules;
 }
 
-bool BaseService::isRunning() const {
-    return running_;
+bool BaseService::hasModule(const std::string& name) const {
+    ModuleReaders::Scope read(module_readers_);
+    const ModuleSnapshot* snapshot = modules_.load(std::memory_order_seq_cst);
+    return snapshot->by_name.find(name) != snapshot->by_name.end();
 }
 
-// 扩展功能：启动所有模块
-Result<void> BaseService::startAllModules() {
-    if (!running_) {
-        return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
+Result<void> BaseService::removeModule(const std::string& name) {
+    std::shared_ptr<ModuleInterface> module;
+    bool started = false;
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        const ModuleSnapshot* current = modules_.load(std::memory_order_relaxed);
+        auto it = current->by_name.find(name);
+        if (it == current->by_name.end()) {
+            return Result<void>(ErrorCode::MODULE_NOT_FOUND, "Module not found: " + name);
+        }
+        module = it->second;
+        publishModules(withoutModule(*current, module));
+        started = started_modules_.erase(name) > 0;
     }
-    
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    for (auto& pair : modules_) {
-        auto& module = pair.second;
-        auto result = module->start();
+
+    // Stop outside the lock, the module may still look up its peers
+    if (started) {
+        waitForModuleUpdates();
+        auto result = module->stop();
         if (result.has_error()) {
-            Logger::error("Failed to start module: {}, error: {}", 
-                        pair.first, result.getError().getMessage());
-            // 继续启动其他模块，不中断过程
+            NEXT_GEN_LOG_WARNING("Failed to stop removed module: " + name + ", error: " + result.error().message());
+        } else {
+            ModuleEventManager::instance().triggerStopEvent(module);
         }
     }
-    
+
+    NEXT_GEN_LOG_DEBUG("Removed module: " + name);
+
+    module.reset();
+    reclaimModuleSnapshots();
     return Result<void>();
 }
 
-// 扩展功能：停止所有模块
-Result<void> BaseService::stopAllModules() {
+void BaseService::reclaimModuleSnapshots() {
+    std::vector<std::unique_ptr<const ModuleSnapshot>> retired;
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        if (module_snapshots_.size() < 2 || !module_readers_.idle()) {
+            return;
+        }
+        retired.reserve(module_snapshots_.size() - 1);
+        std::move(module_snapshots_.begin(), module_snapshots_.end() - 1, std::back_inserter(retired));
+        module_snapshots_.erase(module_snapshots_.begin(), module_snapshots_.end() - 1);
+    }
+}
+
+std::vector<ModulePhaseTiming> BaseService::getModuleTimings() const {
     std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    for (auto& pair : modules_) {
-        auto& module = pair.second;
-        auto result = module->stop();
+    return module_timings_;
+}
+
+// Module lifecycle
+
+Result<std::vector<std::vector<std::shared_ptr<ModuleInterface>>>> BaseService::resolveModuleLevels() const {
+    using Levels = std::vector<std::vector<std::shared_ptr<ModuleInterface>>>;
+
+    ModuleReaders::Scope read(module_readers_);
+    const ModuleSnapshot* snapshot = modules_.load(std::memory_order_seq_cst);
+    const auto& modules = snapshot->by_name;
+
+    // Level of a module is one above its deepest dependency
+    std::unordered_map<std::string, u32> levels;
+    std::vector<std::string> path;
+    std::string error_message;
+    ErrorCode error_code = ErrorCode::SUCCESS;
+
+    std::function<bool(const std::string&)> visit = [&](const std::string& name) -> bool {
+        if (levels.find(name) != levels.end()) {
+            return true;
+        }
+        if (std::find(path.begin(), path.end(), name) != path.end()) {
+            error_code = ErrorCode::CIRCULAR_DEPENDENCY;
+            error_message = "Circular module dependency:";
+            for (const auto& entry : path) {
+                error_message += " " + entry + " ->";
+            }
+            error_message += " " + name;
+            return false;
+        }
+
+        path.push_back(name);
+        u32 level = 0;
+        for (const auto& dependency : ModuleDependencyManager::instance().getDependencies(name)) {
+            if (modules.find(dependency) == modules.end()) {
+                error_code = ErrorCode::MODULE_NOT_FOUND;
+                error_message = "Module " + name + " depends on unknown module: " + dependency;
+                return false;
+            }
+            if (!visit(dependency)) {
+                return false;
+            }
+            level = std::max(level, levels[dependency] + 1);
+        }
+        path.pop_back();
+
+        levels[name] = level;
+        return true;
+    };
+
+    // Visit in name order so that level contents are deterministic
+    std::vector<std::string> names;
+    names.reserve(modules.size());
+    for (const auto& pair : modules) {
+        names.push_back(pair.first);
+    }
+    std::sort(names.begin(), names.end());
+
+    Levels result;
+    for (const auto& name : names) {
+        if (!visit(name)) {
+            return Result<Levels>(error_code, error_message);
+        }
+    }
+
+    for (const auto& name : names) {
+        u32 level = levels[name];
+        if (result.size() <= level) {
+            result.resize(level + 1);
+        }
+        result[level].push_back(modules.at(name));
+    }
+
+    return Result<Levels>(std::move(result));
+}
+
+Result<void> BaseService::runModulePhase(
+    ModulePhase phase, u32 level,
+    const std::vector<std::shared_ptr<ModuleInterface>>& modules,
+    std::vector<std::shared_ptr<ModuleInterface>>* completed) {
+
+    if (modules.empty()) {
+        return Result<void>();
+    }
+
+    const char* phase_name = modulePhaseName(static_cast<int>(phase));
+    std::vector<ModulePhaseTiming> timings(modules.size());
+    std::vector<Result<void>> results(modules.size());
+
+    auto run_one = [&](size_t index) {
+        auto& module = modules[index];
+        u64 start_ns = metricsNowNanos();
+        Result<void> result;
+        try {
+            switch (phase) {
+                case ModulePhase::INIT: result = module->init(); break;
+                case ModulePhase::START: result = module->start(); break;
+                case ModulePhase::STOP: result = module->stop(); break;
+            }
+        } catch (const std::exception& e) {
+            result = Result<void>(ErrorCode::MODULE_ERROR, std::string("Exception: ") + e.what());
+        } catch (...) {
+            result = Result<void>(ErrorCode::MODULE_ERROR, "Unknown exception");
+        }
+
+        ModulePhaseTiming& timing = timings[index];
+        timing.module = module->getName();
+        timing.phase = phase_name;
+        timing.level = level;
+        timing.duration_ns = metricsNowNanos() - start_ns;
+        timing.succeeded = !result.has_error();
+
+        // Notify subscribers (on the thread that ran the phase)
+        if (timing.succeeded) {
+            try {
+                switch (phase) {
+                    case ModulePhase::INIT: ModuleEventManager::instance().triggerInitEvent(module); break;
+                    case ModulePhase::START: ModuleEventManager::instance().triggerStartEvent(module); break;
+                    case ModulePhase::STOP: ModuleEventManager::instance().triggerStopEvent(module); break;
+                }
+            } catch (const std::exception& e) {
+                NEXT_GEN_LOG_ERROR("Exception in " + std::string(phase_name) + " event of module " +
+                                   timing.module + ": " + e.what());
+            } catch (...) {
+                NEXT_GEN_LOG_ERROR("Unknown exception in " + std::string(phase_name) + " event of module " +
+                                   timing.module);
+            }
+        }
+        results[index] = std::move(result);
+    };
+
+    // Modules of one level do not depend on each other, run them concurrently
+    u32 threads = module_parallelism_ ? module_parallelism_ : std::thread::hardware_concurrency();
+    threads = std::max<u32>(1, std::min<u32>(threads, static_cast<u32>(modules.size())));
+
+    if (threads == 1) {
+        for (size_t i = 0; i < modules.size(); ++i) {
+            run_one(i);
+        }
+    } else {
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1); i < modules.size(); i = next.fetch_add(1)) {
+                run_one(i);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (u32 i = 1; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    Result<void> first_error;
+    for (size_t i = 0; i < modules.size(); ++i) {
+        const ModulePhaseTiming& timing = timings[i];
+        NEXT_GEN_LOG_INFO("Module " + timing.module + " " + phase_name + " (level " +
+                          std::to_string(level) + "): " + formatMillis(timing.duration_ns) +
+                          (timing.succeeded ? "" : ", failed"));
+
+        if (!results[i].has_error()) {
+            if (completed) {
+                completed->push_back(modules[i]);
+            }
+        } else if (!first_error.has_error()) {
+            first_error = Result<void>(results[i].error().code(),
+                "Failed to " + std::string(phase_name) + " module: " + timing.module +
+                ", error: " + results[i].error().message());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        module_timings_.insert(module_timings_.end(), timings.begin(), timings.end());
+    }
+
+    return first_error;
+}
+
+Result<void> BaseService::initAllModules() {
+    auto levels = resolveModuleLevels();
+    if (levels.has_error()) {
+        return Result<void>(levels.error());
+    }
+
+    u64 start_ns = metricsNowNanos();
+    const auto& module_levels = levels.value();
+    for (size_t level = 0; level < module_levels.size(); ++level) {
+        auto result = runModulePhase(ModulePhase::INIT, static_cast<u32>(level), module_levels[level], nullptr);
         if (result.has_error()) {
-            Logger::error("Failed to stop module: {}, error: {}", 
-                        pair.first, result.getError().getMessage());
-            // 继续停止其他模块，不中断过程
+            return result;
         }
     }
-    
+
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        modules_initialized_ = true;
+    }
+
+    if (!module_levels.empty()) {
+        NEXT_GEN_LOG_INFO("Modules of service " + name_ + " initialized in " +
+                          std::to_string(module_levels.size()) + " levels: " +
+                          formatMillis(metricsNowNanos() - start_ns));
+    }
+
     return Result<void>();
 }
 
-// 扩展功能：更新所有模块
-Result<void> BaseService::updateAllModules(u64 elapsed_ms) {
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    for (auto& pair : modules_) {
-        auto& module = pair.second;
-        auto result = module->update(elapsed_ms);
+Result<void> BaseService::startAllModules() {
+    auto levels = resolveModuleLevels();
+    if (levels.has_error()) {
+        return Result<void>(levels.error());
+    }
+
+    u64 start_ns = metricsNowNanos();
+    const auto& module_levels = levels.value();
+    std::vector<std::vector<std::shared_ptr<ModuleInterface>>> started(module_levels.size());
+
+    for (size_t level = 0; level < module_levels.size(); ++level) {
+        auto result = runModulePhase(ModulePhase::START, static_cast<u32>(level), module_levels[level], &started[level]);
+
+        {
+            std::lock_guard<std::mutex> lock(modules_mutex_);
+            for (const auto& module : started[level]) {
+                started_modules_.insert(module->getName());
+            }
+        }
+
         if (result.has_error()) {
-            Logger::warning("Error updating module: {}, error: {}", 
-                          pair.first, result.getError().getMessage());
-            // 继续更新其他模块，不中断过程
+            // Roll back: stop what was started, dependents first
+            stopAllModules();
+            return result;
         }
     }
-    
+
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        modules_started_ = true;
+        module_ticks_enabled_ = true;
+        modules_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    if (!module_levels.empty()) {
+        NEXT_GEN_LOG_INFO("Modules of service " + name_ + " started in " +
+                          std::to_string(module_levels.size()) + " levels: " +
+                          formatMillis(metricsNowNanos() - start_ns));
+    }
+
     return Result<void>();
 }
 
-// 扩展功能：获取所有模块
-std::vector<std::shared_ptr<ModuleInterface>> BaseService::getAllModules() const {
-    std::vector<std::shared_ptr<ModuleInterface>> result;
-    
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    result.reserve(modules_.size());
-    for (const auto& pair : modules_) {
-        result.push_back(pair.second);
+Result<void> BaseService::stopAllModules() {
+    // No more updates once stopping begins
+    module_ticks_enabled_ = false;
+    modules_version_.fetch_add(1, std::memory_order_release);
+    waitForModuleUpdates();
+
+    std::vector<std::vector<std::shared_ptr<ModuleInterface>>> module_levels;
+    auto levels = resolveModuleLevels();
+    if (levels.has_error()) {
+        // Dependencies changed after start, still stop everything that runs
+        NEXT_GEN_LOG_WARNING("Stopping modules without dependency order: " + levels.error().message());
+        module_levels.push_back(getAllModules());
+    } else {
+        module_levels = std::move(levels.value());
     }
-    
-    return result;
+
+    // Only stop modules that were started
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        for (auto& modules : module_levels) {
+            modules.erase(std::remove_if(modules.begin(), modules.end(),
+                [this](const std::shared_ptr<ModuleInterface>& module) {
+                    return started_modules_.find(module->getName()) == started_modules_.end();
+                }), modules.end());
+        }
+    }
+
+    u64 start_ns = metricsNowNanos();
+    size_t stopped = 0;
+    for (size_t level = module_levels.size(); level-- > 0;) {
+        auto result = runModulePhase(ModulePhase::STOP, static_cast<u32>(level), module_levels[level], nullptr);
+        if (result.has_error()) {
+            // Keep stopping the remaining modules
+            NEXT_GEN_LOG_ERROR(result.error().message());
+        }
+        stopped += module_levels[level].size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        started_modules_.clear();
+        modules_started_ = false;
+    }
+
+    if (stopped > 0) {
+        NEXT_GEN_LOG_INFO("Modules of service " + name_ + " stopped: " +
+                          formatMillis(metricsNowNanos() - start_ns));
+    }
+
+    return Result<void>();
 }
 
-// 扩展功能：检查模块是否存在
-bool BaseService::hasModule(const std::string& name) const {
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    return modules_.find(name) != modules_.end();
+// Module updates
+
+void BaseService::waitForModuleUpdates() {
+    // On the worker (from a handler or an update) the round in progress
+    // skips its remaining updates once it sees the new version
+    if (std::this_thread::get_id() == worker_thread_.get_id()) {
+        return;
+    }
+
+    // The worker holds tick_run_mutex_ for a whole round and checks the
+    // version under it, so no update starts after this returns
+    std::lock_guard<std::mutex> lock(tick_run_mutex_);
 }
 
-// 扩展功能：移除模块
-Result<void> BaseService::removeModule(const std::string& name) {
-    std::lock_guard<std::mutex> lock(modules_mutex_);
-    
-    auto it = modules_.find(name);
-    if (it == modules_.end()) {
-        return Result<void>(ErrorCode::MODULE_NOT_FOUND, "Module not found: " + name);
-    }
-    
-    auto module = it->second;
-    
-    // 如果模块在运行，先停止它
+void BaseService::rebuildModuleTicks(u64 now_ms) {
+    std::vector<ModuleTickEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(modules_mutex_);
+        tick_version_ = modules_version_.load(std::memory_order_acquire);
+        if (module_ticks_enabled_) {
+            const ModuleSnapshot* snapshot = modules_.load(std::memory_order_acquire);
+            for (const auto& name : started_modules_) {
+                auto it = snapshot->by_name.find(name);
+                if (it == snapshot->by_name.end() || it->second->getUpdateInterval() == 0) {
+                    continue;
+                }
+                ModuleTickEntry entry;
+                entry.module = it->second;
+                entry.name = name;
+                entry.interval_ms = it->second->getUpdateInterval();
+                entry.phase_ms = it->second->getUpdatePhase();
+                entry.last_ms = now_ms;
+                entry.due_ms = 0;
+                entry.duration = nullptr;
+                entries.push_back(std::move(entry));
+            }
+        }
+    }
+
+    // Deterministic phase assignment for modules started together
+    std::sort(entries.begin(), entries.end(), [](const ModuleTickEntry& a, const ModuleTickEntry& b) {
+        return a.name < b.name;
+    });
+
+    for (auto& entry : entries) {
+        // Modules already scheduled keep their phase and next update
+        auto old = std::find_if(tick_entries_.begin(), tick_entries_.end(), [&entry](const ModuleTickEntry& e) {
+            return e.module == entry.module && e.interval_ms == entry.interval_ms;
+        });
+        if (old != tick_entries_.end()) {
+            entry.phase_ms = old->phase_ms;
+            entry.last_ms = old->last_ms;
+            entry.due_ms = old->due_ms;
+            entry.duration = old->duration;
+            entry.events = old->events;
+            continue;
+        }
+
+        // Spread modules of one interval over it (golden ratio sequence keeps
+        // the offsets apart as modules are added one by one)
+        if (entry.phase_ms == AUTO_UPDATE_PHASE) {
+            u32 index = auto_phase_counters_[entry.interval_ms]++;
+            f64 fraction = index * 0.6180339887498949;
+            fraction -= static_cast<u64>(fraction);
+            entry.phase_ms = static_cast<u32>(fraction * entry.interval_ms);
+        } else {
+            entry.phase_ms %= entry.interval_ms;
+        }
+
+        entry.due_ms = now_ms - now_ms % entry.interval_ms + entry.phase_ms;
+        if (entry.due_ms <= now_ms) {
+            entry.due_ms += entry.interval_ms;
+        }
+        entry.duration = &moduleUpdateMetric(entry.name);
+        entry.events = ModuleEventManager::instance().getSlot(entry.module->getName());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tick_mutex_);
+        tick_entries_.swap(entries);
+    }
+
+    tick_wheel_.clear();
+    for (size_t i = 0; i < tick_entries_.size(); ++i) {
+        tick_wheel_.schedule(static_cast<u32>(i), tick_entries_[i].due_ms);
+    }
+}
+
+void BaseService::tickModules(u64 now_ms) {
+    std::lock_guard<std::mutex> run_lock(tick_run_mutex_);
+    if (modules_version_.load(std::memory_order_acquire) != tick_version_) {
+        rebuildModuleTicks(now_ms);
+    }
+
+    tick_wheel_.advance(now_ms, [this, now_ms](u32 index, u64 due_ms) {
+        // Modules changed during this round: the remaining updates run after
+        // the rebuild, which reschedules every entry at its due time
+        if (modules_version_.load(std::memory_order_acquire) != tick_version_) {
+            return;
+        }
+        ModuleTickEntry& entry = tick_entries_[index];
+
+        u64 elapsed_ms = now_ms - entry.last_ms;
+        u64 start_ns = metricsNowNanos();
+        try {
+            auto result = entry.module->update(elapsed_ms);
+            if (result.has_error()) {
+                NEXT_GEN_LOG_WARNING("Error updating module: " + entry.name + ", error: " + result.error().message());
+            }
+            entry.events->triggerUpdateEvent(entry.module, elapsed_ms);
+        } catch (const std::exception& e) {
+            NEXT_GEN_LOG_ERROR("Exception in update of module " + entry.name + ": " + e.what());
+        } catch (...) {
+            NEXT_GEN_LOG_ERROR("Unknown exception in update of module " + entry.name);
+        }
+        entry.duration->record(metricsNowNanos() - start_ns);
+        entry.last_ms = now_ms;
+
+        // Fixed rate on the module's phase, updates missed under load are skipped
+        entry.due_ms = due_ms + entry.interval_ms;
+        if (entry.due_ms <= now_ms) {
+            entry.due_ms += ((now_ms - entry.due_ms) / entry.interval_ms + 1) * entry.interval_ms;
+        }
+        tick_wheel_.schedule(index, entry.due_ms);
+    });
+}
+
+std::vector<ModuleTickStats> BaseService::getModuleTickStats() const {
+    std::lock_guard<std::mutex> lock(tick_mutex_);
+
+    std::vector<ModuleTickStats> stats;
+    stats.reserve(tick_entries_.size());
+    for (const auto& entry : tick_entries_) {
+        ModuleTickStats item;
+        item.module = entry.name;
+        item.interval_ms = entry.interval_ms;
+        item.phase_ms = entry.phase_ms;
+        item.ticks = entry.duration->count();
+        item.p99_ns = entry.duration->percentile(0.99);
+        item.max_ns = entry.duration->max();
+        stats.push_back(std::move(item));
+    }
+    return stats;
+}
+
+// Message bus requests
+
+Result<void> BaseService::request(const ServiceHandle& target, std::shared_ptr<const Message> message,
+                                  u32 timeout_ms, ResponseCallback callback) {
+    if (!message || !callback) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Message and callback cannot be null");
+    }
+    if (!running_) {
+        return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
+    }
+
+    ServiceId self = bus_id_.load(std::memory_order_acquire);
+    if (self == INVALID_SERVICE_ID) {
+        return Result<void>(ErrorCode::SERVICE_NOT_FOUND,
+                            "Service must be registered with the message bus to send requests: " + name_);
+    }
+    if (timeout_ms > 0 && !TimerManager::instance().isRunning()) {
+        return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Timer manager not running, request timeout cannot fire");
+    }
+
+    u64 request_id = next_request_id_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        pending_requests_[request_id] = PendingRequest{std::move(callback), 0};
+    }
+
+    // The deadline is delivered through the queue like the response, so both
+    // complete on this service's thread and only the first one counts
+    if (timeout_ms > 0) {
+        TimerId timer = TimerManager::instance().createOnce(timeout_ms, [self, request_id]() {
+            MessageBus::instance().resolve(self).post(std::make_unique<MessageEnvelope>(
+                EnvelopeKind::TIMEOUT, nullptr, INVALID_SERVICE_ID, request_id));
+        });
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        auto it = pending_requests_.find(request_id);
+        if (it != pending_requests_.end()) {
+            it->second.timer = timer;
+        } else {
+            TimerManager::instance().cancel(timer);
+        }
+    }
+
+    auto result = target.post(std::make_unique<MessageEnvelope>(
+        EnvelopeKind::REQUEST, std::move(message), self, request_id));
+    if (result.has_error()) {
+        TimerId timer = 0;
+        {
+            std::lock_guard<std::mutex> lock(requests_mutex_);
+            auto it = pending_requests_.find(request_id);
+            if (it != pending_requests_.end()) {
+                timer = it->second.timer;
+                pending_requests_.erase(it);
+            }
+        }
+        if (timer != 0) {
+            TimerManager::instance().cancel(timer);
+        }
+        return result;
+    }
+
+    return Result<void>();
+}
+
+std::future<Result<std::shared_ptr<const Message>>> BaseService::request(
+    const ServiceHandle& target, std::shared_ptr<const Message> message, u32 timeout_ms) {
+
+    auto promise = std::make_shared<std::promise<Result<std::shared_ptr<const Message>>>>();
+    auto future = promise->get_future();
+
+    auto result = request(target, std::move(message), timeout_ms,
+        [promise](Result<std::shared_ptr<const Message>> response) {
+            promise->set_value(std::move(response));
+        });
+    if (result.has_error()) {
+        promise->set_value(Result<std::shared_ptr<const Message>>(result.error().code(), result.error().message()));
+    }
+    return future;
+}
+
+void BaseService::handleEnvelope(const MessageEnvelope& envelope) {
+    switch (envelope.getKind()) {
+        case EnvelopeKind::SEND:
+            onMessage(*envelope.getPayload());
+            break;
+        case EnvelopeKind::REQUEST: {
+            RequestScope scope(RequestContext{envelope.getSource(), envelope.getCorrelationId()});
+            onMessage(*envelope.getPayload());
+            break;
+        }
+        case EnvelopeKind::RESPONSE:
+            completeRequest(envelope.getCorrelationId(),
+                            Result<std::shared_ptr<const Message>>(envelope.getPayload()));
+            break;
+        case EnvelopeKind::TIMEOUT:
+            completeRequest(envelope.getCorrelationId(),
+                            Result<std::shared_ptr<const Message>>(ErrorCode::TIMEOUT, "Request timed out"));
+            break;
+        case EnvelopeKind::TASK:
+            if (envelope.getTask()) {
+                envelope.getTask()();
+            }
+            break;
+    }
+}
+
+// Admission control
+
+Result<void> BaseService::setAdmissionConfig(const AdmissionConfig& config) {
     if (running_) {
-        module->stop();
-    }
-    
-    // 移除模块
-    modules_.erase(it);
-    
-    Logger::info("Removed module: {}", name);
-    
+        return Result<void>(ErrorCode::SERVICE_ALREADY_STARTED, "Admission control must be configured before start");
+    }
+    if (config.max_queue_depth != 0 && config.shed_watermark > config.max_queue_depth) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Shed watermark above max queue depth");
+    }
+    admission_.reset(config.enabled ? new AdmissionController(name_, config) : nullptr);
+    return Result<void>();
+}
+
+Result<void> BaseService::admitMessage(std::unique_ptr<Message> message) {
+    // Bus responses, timeouts and tasks complete pending work, never shed them
+    if (AdmissionController::isControl(*message)) {
+        return pushControl(*message_queue_, *control_overflow_, std::move(message));
+    }
+
+    ShedReason reason = admission_->admit(*message, message_queue_->size());
+    if (reason == ShedReason::NONE) {
+        if (message_queue_->tryPush(message)) {
+            return Result<void>();
+        }
+        if (message_queue_->isShutdown()) {
+            return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
+        }
+        reason = ShedReason::QUEUE_FULL;
+    }
+
+    admission_->recordShed(reason);
+    NEXT_GEN_LOG_WARNING_LIMITED("Service " + name_ + " overloaded, message shed: " + shedReasonName(reason), 1);
+    return Result<void>(ErrorCode::SERVICE_OVERLOADED,
+                        "Service overloaded: " + name_ + " (" + shedReasonName(reason) + ")");
+}
+
+Result<void> BaseService::pushControl(MessageQueue& queue, ControlOverflow& overflow,
+                                      std::unique_ptr<Message> message) {
+    // A blocking push could wait on the worker, which may itself be
+    // waiting for this response or task
+    if (!overflow.pending.load(std::memory_order_acquire) && queue.tryPush(message)) {
+        return Result<void>();
+    }
+    if (queue.isShutdown()) {
+        return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
+    }
+
+    // Queue behind the parked messages, so control messages stay in order
+    std::lock_guard<std::mutex> lock(overflow.mutex);
+    if (overflow.messages.empty() && queue.tryPush(message)) {
+        return Result<void>();
+    }
+    overflow.messages.push_back(std::move(message));
+    overflow.pending.store(true, std::memory_order_release);
     return Result<void>();
 }
 
-// 辅助函数实现
-u32 BaseService::makeHandlerKey(MessageCategoryType category, MessageIdType id) {
-    return (static_cast<u32>(category) << 16) | static_cast<u32>(id);
+void BaseService::refillControlOverflow(MessageQueue& queue, ControlOverflow& overflow) {
+    std::lock_guard<std::mutex> lock(overflow.mutex);
+    while (!overflow.messages.empty() && queue.tryPush(overflow.messages.front())) {
+        overflow.messages.pop_front();
+    }
+    overflow.pending.store(!overflow.messages.empty(), std::memory_order_release);
+}
+
+// Tasks and message ownership
+
+Result<void> BaseService::execute(std::function<void()> task) {
+    if (!task) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Task cannot be null");
+    }
+    if (!running_) {
+        return Result<void>(ErrorCode::SERVICE_NOT_STARTED, "Service not started");
+    }
+    getExecutor()(std::move(task));
+    return Result<void>();
+}
+
+BaseService::Executor BaseService::getExecutor() const {
+    // Holds the queue, not the service; a shut down queue drops the task
+    std::shared_ptr<MessageQueue> queue = message_queue_;
+    std::shared_ptr<ControlOverflow> overflow = control_overflow_;
+    return [queue, overflow](std::function<void()> task) {
+        auto envelope = std::make_unique<MessageEnvelope>(std::move(task));
+        envelope->setEnqueueTime(metricsNowNanos());
+        envelope->setTraceId(Tracer::currentTraceId());
+        pushControl(*queue, *overflow, std::move(envelope));
+    };
+}
+
+std::shared_ptr<const Message> BaseService::retainCurrentMessage() {
+    if (retained_message_) {
+        return retained_message_;
+    }
+    if (!current_message_ || !*current_message_) {
+        return nullptr;
+    }
+
+    // Envelope payloads are shared already, other messages change owner
+    const Message& message = **current_message_;
+    if (message.isEnvelope()) {
+        retained_message_ = static_cast<const MessageEnvelope&>(message).getPayload();
+    } else {
+        retained_message_ = std::shared_ptr<const Message>(std::move(*current_message_));
+    }
+    return retained_message_;
+}
+
+void BaseService::completeRequest(u64 request_id, Result<std::shared_ptr<const Message>> result) {
+    PendingRequest pending;
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        auto it = pending_requests_.find(request_id);
+        if (it == pending_requests_.end()) {
+            // Already completed (late response or timeout)
+            return;
+        }
+        pending = std::move(it->second);
+        pending_requests_.erase(it);
+    }
+
+    if (pending.timer != 0) {
+        TimerManager::instance().cancel(pending.timer);
+    }
+    pending.callback(std::move(result));
+}
+
+void BaseService::failPendingRequests() {
+    std::unordered_map<u64, PendingRequest> pending;
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex_);
+        pending.swap(pending_requests_);
+    }
+
+    for (auto& pair : pending) {
+        if (pair.second.timer != 0) {
+            TimerManager::instance().cancel(pair.second.timer);
+        }
+        try {
+            pair.second.callback(Result<std::shared_ptr<const Message>>(
+                ErrorCode::SERVICE_NOT_STARTED, "Service stopped before the response arrived"));
+        } catch (...) {
+            NEXT_GEN_LOG_ERROR("Exception in request callback of service: " + name_);
+        }
+    }
 }
 
 } // namespace next_gen
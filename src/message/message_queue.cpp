@@ -1,8 +1,24 @@
 #include "../../include/message/message_queue.h"
 #include "../../include/utils/logger.h"
+#include "../../include/utils/thread_placement.h"
 
 namespace next_gen {
 
+// MessageQueue implementation
+
+void MessageQueue::enableMetrics(const std::string& name) {
+    auto& registry = MetricsRegistry::instance();
+    MetricLabels labels = {{"queue", name}};
+    
+    auto metrics = std::make_unique<QueueMetrics>();
+    metrics->depth = &registry.gauge("next_gen_queue_depth", "Messages waiting in queue", labels);
+    metrics->enqueued = &registry.counter("next_gen_queue_enqueued_total", "Messages pushed to queue", labels);
+    metrics->dequeued = &registry.counter("next_gen_queue_dequeued_total", "Messages popped from queue", labels);
+    metrics->wait_time = &registry.histogram("next_gen_queue_wait_seconds",
+                                             "Time between enqueue and dequeue", labels);
+    metrics_ = std::move(metrics);
+}
+
 // DefaultMessageQueue implementation
 
 void DefaultMessageQueue::push(std::unique_ptr<Message> message) {
@@ -16,7 +32,7 @@ void DefaultMessageQueue::push(std::unique_ptr<Message> message) {
     
     // If queue is full, wait
     if (max_size_ > 0 && queue_.size() >= max_size_) {
-        NEXT_GEN_LOG_WARNING("Message queue is full, waiting for space");
+        NEXT_GEN_LOG_WARNING_LIMITED("Message queue is full, waiting for space", 1);
         not_full_.wait(lock, [this] { 
             return queue_.size() < max_size_ || shutdown_; 
         });
@@ -29,13 +45,32 @@ void DefaultMessageQueue::push(std::unique_ptr<Message> message) {
     }
     
     // Push message
+    onEnqueue(*message);
     queue_.push(std::move(message));
+    updateDepth(queue_.size());
     
     // Notify waiting consumers
     lock.unlock();
     not_empty_.notify_one();
 }
 
+bool DefaultMessageQueue::tryPush(std::unique_ptr<Message>& message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    // Reject instead of waiting
+    if (shutdown_ || (max_size_ > 0 && queue_.size() >= max_size_)) {
+        return false;
+    }
+    
+    onEnqueue(*message);
+    queue_.push(std::move(message));
+    updateDepth(queue_.size());
+    
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+}
+
 std::unique_ptr<Message> DefaultMessageQueue::pop() {
     std::unique_lock<std::mutex> lock(mutex_);
     
@@ -52,6 +87,8 @@ std::unique_ptr<Message> DefaultMessageQueue::pop() {
     // Get message
     std::unique_ptr<Message> message = std::move(queue_.front());
     queue_.pop();
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     lock.unlock();
@@ -73,6 +110,8 @@ std::unique_ptr<Message> DefaultMessageQueue::tryPop() {
     // Get message
     std::unique_ptr<Message> message = std::move(queue_.front());
     queue_.pop();
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     lock.unlock();
@@ -99,6 +138,8 @@ std::unique_ptr<Message> DefaultMessageQueue::waitAndPop(const std::chrono::mill
     // Get message
     std::unique_ptr<Message> message = std::move(queue_.front());
     queue_.pop();
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     lock.unlock();
@@ -123,6 +164,7 @@ void DefaultMessageQueue::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     std::queue<std::unique_ptr<Message>> empty;
     std::swap(queue_, empty);
+    updateDepth(0);
     if (max_size_ > 0) {
         not_full_.notify_all();
     }
@@ -165,7 +207,7 @@ void PriorityMessageQueue::push(std::unique_ptr<Message> message) {
     
     // If queue is full, wait
     if (max_size_ > 0 && queue_.size() >= max_size_) {
-        NEXT_GEN_LOG_WARNING("Priority message queue is full, waiting for space");
+        NEXT_GEN_LOG_WARNING_LIMITED("Priority message queue is full, waiting for space", 1);
         not_full_.wait(lock, [this] { 
             return queue_.size() < max_size_ || shutdown_; 
         });
@@ -181,13 +223,33 @@ void PriorityMessageQueue::push(std::unique_ptr<Message> message) {
     int priority = calculatePriority(*message);
     
     // Push message with priority
+    onEnqueue(*message);
     queue_.push(std::make_pair(priority, std::move(message)));
+    updateDepth(queue_.size());
     
     // Notify waiting consumers
     lock.unlock();
     not_empty_.notify_one();
 }
 
+bool PriorityMessageQueue::tryPush(std::unique_ptr<Message>& message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    // Reject instead of waiting
+    if (shutdown_ || (max_size_ > 0 && queue_.size() >= max_size_)) {
+        return false;
+    }
+    
+    int priority = calculatePriority(*message);
+    onEnqueue(*message);
+    queue_.push(std::make_pair(priority, std::move(message)));
+    updateDepth(queue_.size());
+    
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+}
+
 std::unique_ptr<Message> PriorityMessageQueue::pop() {
     std::unique_lock<std::mutex> lock(mutex_);
     
@@ -205,6 +267,8 @@ std::unique_ptr<Message> PriorityMessageQueue::pop() {
     auto top = std::move(const_cast<std::pair<int, std::unique_ptr<Message>>&>(queue_.top()));
     queue_.pop();
     std::unique_ptr<Message> message = std::move(top.second);
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     lock.unlock();
@@ -227,6 +291,8 @@ std::unique_ptr<Message> PriorityMessageQueue::tryPop() {
     auto top = std::move(const_cast<std::pair<int, std::unique_ptr<Message>>&>(queue_.top()));
     queue_.pop();
     std::unique_ptr<Message> message = std::move(top.second);
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     not_full_.notify_one();
@@ -251,6 +317,8 @@ std::unique_ptr<Message> PriorityMessageQueue::waitAndPop(const std::chrono::mil
     auto top = std::move(const_cast<std::pair<int, std::unique_ptr<Message>>&>(queue_.top()));
     queue_.pop();
     std::unique_ptr<Message> message = std::move(top.second);
+    onDequeued(*message);
+    updateDepth(queue_.size());
     
     // Notify waiting producers
     lock.unlock();
@@ -281,6 +349,7 @@ void PriorityMessageQueue::clear() {
     
     // Swap with current queue
     std::swap(queue_, empty);
+    updateDepth(0);
     
     // Notify waiting producers
     if (max_size_ > 0) {
@@ -311,7 +380,7 @@ int PriorityMessageQueue::calculatePriority(const Message& message) const {
 LockFreeMessageQueue::~LockFreeMessageQueue() {
     shutdown();
     clear();
-    delete[] buffer_;
+    ThreadPlacement::freePages(buffer_, sizeof(std::atomic<Message*>) * (capacity_ + 1));
 }
 
 void LockFreeMessageQueue::push(std::unique_ptr<Message> message) {
@@ -328,7 +397,7 @@ void LockFreeMessageQueue::push(std::unique_ptr<Message> message) {
         
         // Check if queue is full
         if ((tail + 1) % (capacity_ + 1) == head) {
-            NEXT_GEN_LOG_WARNING("Lock-free message queue is full, retrying");
+            NEXT_GEN_LOG_WARNING_LIMITED("Lock-free message queue is full, retrying", 1);
             // Re-acquire ownership of the message to avoid memory leak
             message.reset(raw_msg);
             // Yield to allow other threads to make progress
@@ -351,14 +420,51 @@ void LockFreeMessageQueue::push(std::unique_ptr<Message> message) {
             continue;
         }
         
+        onEnqueue(*raw_msg);
         buffer_[tail].store(raw_msg, std::memory_order_relaxed);
         
         // Update tail
         tail_.store((tail + 1) % (capacity_ + 1), std::memory_order_release);
+        updateDepth(size());
         return;
     }
 }
 
+bool LockFreeMessageQueue::tryPush(std::unique_ptr<Message>& message) {
+    if (isShutdown()) {
+        return false;
+    }
+    
+    while (true) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        
+        // Reject instead of waiting
+        if ((tail + 1) % (capacity_ + 1) == head) {
+            return false;
+        }
+        
+        // Another thread modified the tail, retry
+        if (buffer_[tail].load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+        
+        onEnqueue(*message);
+        buffer_[tail].store(message.release(), std::memory_order_relaxed);
+        
+        tail_.store((tail + 1) % (capacity_ + 1), std::memory_order_release);
+        updateDepth(size());
+        return true;
+    }
+}
+
+void LockFreeMessageQueue::bindToNode(u32 node) {
+    auto result = ThreadPlacement::instance().bindMemory(buffer_, sizeof(std::atomic<Message*>) * (capacity_ + 1), node);
+    if (result.has_error()) {
+        NEXT_GEN_LOG_WARNING("Failed to bind lock-free queue buffer: " + std::string(result.error().what()));
+    }
+}
+
 std::unique_ptr<Message> LockFreeMessageQueue::pop() {
     while (true) {
         // If queue is empty and shutdown, return nullptr
@@ -405,6 +511,8 @@ std::unique_ptr<Message> LockFreeMessageQueue::tryPop() {
                                          std::memory_order_relaxed)) {
             // Successfully popped the message
             buffer_[head].store(nullptr, std::memory_order_relaxed);
+            onDequeued(*msg);
+            updateDepth(size());
             return std::unique_ptr<Message>(msg);
         }
         
@@ -482,7 +590,7 @@ bool LockFreeMessageQueue::isShutdown() const {
 MPMCMessageQueue::~MPMCMessageQueue() {
     shutdown();
     clear();
-    delete[] buffer_;
+    ThreadPlacement::freePages(buffer_, sizeof(Cell) * capacity_);
 }
 
 void MPMCMessageQueue::push(std::unique_ptr<Message> message) {
@@ -512,7 +620,7 @@ void MPMCMessageQueue::push(std::unique_ptr<Message> message) {
         }
         // Queue is full
         else if (diff < 0) {
-            NEXT_GEN_LOG_WARNING("MPMC message queue is full, retrying");
+            NEXT_GEN_LOG_WARNING_LIMITED("MPMC message queue is full, retrying", 1);
             
             // If queue was shutdown while waiting, discard message
             if (isShutdown()) {
@@ -530,10 +638,57 @@ void MPMCMessageQueue::push(std::unique_ptr<Message> message) {
     }
     
     // Store the message
+    onEnqueue(*message);
     cell->data = message.release();
     
     // Mark the cell as ready for dequeue
     cell->sequence.store(pos + 1, std::memory_order_release);
+    updateDepth(size());
+}
+
+bool MPMCMessageQueue::tryPush(std::unique_ptr<Message>& message) {
+    if (isShutdown()) {
+        return false;
+    }
+    
+    Cell* cell;
+    size_t pos;
+    
+    while (true) {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        cell = &buffer_[pos % capacity_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        
+        // Cell is ready for enqueue
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        // Reject instead of waiting
+        else if (diff < 0) {
+            return false;
+        }
+        // Another thread is in the middle of enqueue, retry
+        else {
+            std::this_thread::yield();
+        }
+    }
+    
+    onEnqueue(*message);
+    cell->data = message.release();
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    updateDepth(size());
+    return true;
+}
+
+void MPMCMessageQueue::bindToNode(u32 node) {
+    auto result = ThreadPlacement::instance().bindMemory(buffer_, sizeof(Cell) * capacity_, node);
+    if (result.has_error()) {
+        NEXT_GEN_LOG_WARNING("Failed to bind MPMC queue buffer: " + std::string(result.error().what()));
+    }
 }
 
 std::unique_ptr<Message> MPMCMessageQueue::pop() {
@@ -594,6 +749,8 @@ std::unique_ptr<Message> MPMCMessageQueue::tryPop() {
     
     // Mark the cell as ready for enqueue
     cell->sequence.store(pos + capacity_, std::memory_order_release);
+    onDequeued(*msg);
+    updateDepth(size());
     
     return std::unique_ptr<Message>(msg);
 }
@@ -665,7 +822,7 @@ std::unique_ptr<MessageQueue> createMessageQueue(const std::string& type, size_t
     } else if (type == "priority") {
         return std::make_unique<PriorityMessageQueue>(capacity);
     } else if (type == "lockfree") {
-        return std::make_unique<LockFreeMessageQueue>();
+        return std::make_unique<LockFreeMessageQueue>(capacity);
     } else if (type == "mpmc") {
         return std::make_unique<MPMCMessageQueue>(capacity);
     } else {
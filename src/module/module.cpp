@@ -1,88 +1,68 @@
-#include "../../include/module/module.h"
-#include "../../include/core/service.h"
+#include "../../include/module/module_impl.h"
+#include "../../include/module/module_events.h"
 #include "../../include/utils/logger.h"
+#include <algorithm>
 
 namespace next_gen {
 
-// 发送消息到服务
-Result<void> Module::postMessage(std::unique_ptr<Message> message) {
-    auto service = service_.lock();
-    if (!service) {
-        return Result<void>(ErrorCode::SERVICE_ERROR, "Service not available");
+// 模块依赖关系管理
+ModuleDependencyManager& ModuleDependencyManager::instance() {
+    static ModuleDependencyManager instance;
+    return instance;
+}
+
+// 添加模块依赖关系
+void ModuleDependencyManager::addDependency(const std::string& module, const std::string& dependency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& dependencies = dependencies_[module];
+    if (std::find(dependencies.begin(), dependencies.end(), dependency) == dependencies.end()) {
+        dependencies.push_back(dependency);
     }
-    
-    return service->postMessage(std::move(message));
 }
 
-// 获取服务实例
-std::shared_ptr<Service> Module::getService() {
-    return service_.lock();
+// 检查是否有循环依赖
+bool ModuleDependencyManager::hasCircularDependency(const std::string& module) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> path;
+    return hasCircularDependencyImpl(module, path);
 }
 
-// 添加模块依赖关系管理
-class ModuleDependencyManager {
-public:
-    static ModuleDependencyManager& instance() {
-        static ModuleDependencyManager instance;
-        return instance;
-    }
-    
-    // 添加模块依赖关系
-    void addDependency(const std::string& module, const std::string& dependency) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        dependencies_[module].push_back(dependency);
-    }
-    
-    // 检查是否有循环依赖
-    bool hasCircularDependency(const std::string& module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::set<std::string> visited;
-        return hasCircularDependencyImpl(module, visited);
-    }
-    
-    // 获取模块的所有依赖
-    std::vector<std::string> getDependencies(const std::string& module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = dependencies_.find(module);
-        if (it != dependencies_.end()) {
-            return it->second;
-        }
-        return {};
+// 获取模块的所有依赖
+std::vector<std::string> ModuleDependencyManager::getDependencies(const std::string& module) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = dependencies_.find(module);
+    if (it != dependencies_.end()) {
+        return it->second;
     }
-    
-    // 清除模块的依赖
-    void clearDependencies(const std::string& module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        dependencies_.erase(module);
+    return {};
+}
+
+// 清除模块的依赖
+void ModuleDependencyManager::clearDependencies(const std::string& module) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dependencies_.erase(module);
+}
+
+// 递归检查循环依赖（path 为当前搜索路径）
+bool ModuleDependencyManager::hasCircularDependencyImpl(const std::string& module, std::vector<std::string>& path) {
+    if (std::find(path.begin(), path.end(), module) != path.end()) {
+        return true; // 循环依赖
     }
     
-private:
-    ModuleDependencyManager() {}
+    path.push_back(module);
     
-    // 递归检查循环依赖
-    bool hasCircularDependencyImpl(const std::string& module, std::set<std::string>& visited) {
-        if (visited.find(module) != visited.end()) {
-            return true; // 循环依赖
-        }
-        
-        visited.insert(module);
-        
-        auto it = dependencies_.find(module);
-        if (it != dependencies_.end()) {
-            for (const auto& dep : it->second) {
-                if (hasCircularDependencyImpl(dep, visited)) {
-                    return true;
-                }
+    auto it = dependencies_.find(module);
+    if (it != dependencies_.end()) {
+        for (const auto& dep : it->second) {
+            if (hasCircularDependencyImpl(dep, path)) {
+                return true;
             }
         }
-        
-        visited.erase(module);
-        return false;
     }
     
-    std::unordered_map<std::string, std::vector<std::string>> dependencies_;
-    std::mutex mutex_;
-};
+    path.pop_back();
+    return false;
+}
 
 // 扩展Module类的功能，添加依赖管理
 
@@ -101,17 +81,22 @@ Result<void> Module::addDependency(const std::string& dependency_name) {
     }
     
     // 添加依赖关系
-    ModuleDependencyManager::instance().addDependency(getName(), dependency_name);
+    auto& manager = ModuleDependencyManager::instance();
+    auto previous = manager.getDependencies(getName());
+    manager.addDependency(getName(), dependency_name);
     
     // 检查是否造成循环依赖
-    if (ModuleDependencyManager::instance().hasCircularDependency(getName())) {
-        // 移除刚添加的依赖
-        ModuleDependencyManager::instance().clearDependencies(getName());
+    if (manager.hasCircularDependency(getName())) {
+        // 恢复原有依赖
+        manager.clearDependencies(getName());
+        for (const auto& dependency : previous) {
+            manager.addDependency(getName(), dependency);
+        }
         return Result<void>(ErrorCode::CIRCULAR_DEPENDENCY, 
                           "Adding dependency would create circular dependency");
     }
     
-    Logger::debug("Added dependency: {} -> {}", getName(), dependency_name);
+    NEXT_GEN_LOG_DEBUG("Added dependency: " + getName() + " -> " + dependency_name);
     
     return Result<void>();
 }
@@ -127,72 +112,6 @@ std::vector<std::string> Module::getDependencies() {
     return ModuleDependencyManager::instance().getDependencies(getName());
 }
 
-// 注册模块事件回调
-struct ModuleEventHandlers {
-    std::function<void(std::shared_ptr<ModuleInterface>)> on_init;
-    std::function<void(std::shared_ptr<ModuleInterface>)> on_start;
-    std::function<void(std::shared_ptr<ModuleInterface>)> on_stop;
-    std::function<void(std::shared_ptr<ModuleInterface>, u64)> on_update;
-};
-
-// 模块事件管理器
-class ModuleEventManager {
-public:
-    static ModuleEventManager& instance() {
-        static ModuleEventManager instance;
-        return instance;
-    }
-    
-    void registerEventHandlers(const std::string& module_name, 
-                             ModuleEventHandlers handlers) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        event_handlers_[module_name] = handlers;
-    }
-    
-    void removeEventHandlers(const std::string& module_name) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        event_handlers_.erase(module_name);
-    }
-    
-    void triggerInitEvent(std::shared_ptr<ModuleInterface> module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = event_handlers_.find(module->getName());
-        if (it != event_handlers_.end() && it->second.on_init) {
-            it->second.on_init(module);
-        }
-    }
-    
-    void triggerStartEvent(std::shared_ptr<ModuleInterface> module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = event_handlers_.find(module->getName());
-        if (it != event_handlers_.end() && it->second.on_start) {
-            it->second.on_start(module);
-        }
-    }
-    
-    void triggerStopEvent(std::shared_ptr<ModuleInterface> module) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = event_handlers_.find(module->getName());
-        if (it != event_handlers_.end() && it->second.on_stop) {
-            it->second.on_stop(module);
-        }
-    }
-    
-    void triggerUpdateEvent(std::shared_ptr<ModuleInterface> module, u64 elapsed_ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = event_handlers_.find(module->getName());
-        if (it != event_handlers_.end() && it->second.on_update) {
-            it->second.on_update(module, elapsed_ms);
-        }
-    }
-    
-private:
-    ModuleEventManager() {}
-    
-    std::unordered_map<std::string, ModuleEventHandlers> event_handlers_;
-    std::mutex mutex_;
-};
-
 // 增强模块工厂类，添加更多功能
 Result<std::shared_ptr<ModuleInterface>> ModuleFactory::createAndRegisterModule(
     std::shared_ptr<Service> service, 
@@ -207,7 +126,7 @@ Result<std::shared_ptr<ModuleInterface>> ModuleFactory::createAndRegisterModule(
     // 检查模块是否已存在
     if (service->getModule(module_name)) {
         return Result<std::shared_ptr<ModuleInterface>>(
-            ErrorCode::MODULE_ALREADY_REGISTERED, 
+            ErrorCode::MODULE_ALREADY_EXISTS, 
             "Module already registered: " + module_name);
     }
     
@@ -215,7 +134,7 @@ Result<std::shared_ptr<ModuleInterface>> ModuleFactory::createAndRegisterModule(
     auto module = factory_func();
     if (!module) {
         return Result<std::shared_ptr<ModuleInterface>>(
-            ErrorCode::MODULE_CREATION_FAILED, 
+            ErrorCode::MODULE_ERROR, 
             "Failed to create module: " + module_name);
     }
     
@@ -223,8 +142,8 @@ Result<std::shared_ptr<ModuleInterface>> ModuleFactory::createAndRegisterModule(
     auto result = service->registerModule(module);
     if (result.has_error()) {
         return Result<std::shared_ptr<ModuleInterface>>(
-            result.getError().getCode(), 
-            result.getError().getMessage());
+            result.error().code(), 
+            result.error().message());
     }
     
     return Result<std::shared_ptr<ModuleInterface>>(module);
@@ -330,32 +249,29 @@ public:
         auto new_module = factory_func();
         if (!new_module) {
             return Result<std::shared_ptr<ModuleInterface>>(
-                ErrorCode::MODULE_CREATION_FAILED, 
+                ErrorCode::MODULE_ERROR, 
                 "Failed to create new module: " + module_name);
         }
         
-        // 停止旧模块
-        old_module->stop();
-        
-        // 移除旧模块
-        service->removeModule(module_name);
+        // 停止并移除旧模块
+        auto base_service = std::dynamic_pointer_cast<BaseService>(service);
+        if (base_service) {
+            base_service->removeModule(module_name);
+        } else {
+            old_module->stop();
+        }
         
         // 注册新模块
         auto result = service->registerModule(new_module);
         if (result.has_error()) {
             return Result<std::shared_ptr<ModuleInterface>>(
-                result.getError().getCode(), 
-                result.getError().getMessage());
+                result.error().code(), 
+                result.error().message());
         }
         
         // 恢复模块状态
         restoreModuleState(new_module, state);
         
-        // 如果服务正在运行，启动新模块
-        if (service->isRunning()) {
-            new_module->start();
-        }
-        
         return Result<std::shared_ptr<ModuleInterface>>(new_module);
     }
     
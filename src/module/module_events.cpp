@@ -0,0 +1,93 @@
+#include "../../include/module/module_events.h"
+
+namespace next_gen {
+
+// 模块事件槽
+ModuleEventSlot::ModuleEventSlot() {
+    lists_.emplace_back(new HandlerList());
+    handlers_.store(lists_.back().get(), std::memory_order_release);
+}
+
+// 替换订阅者列表
+void ModuleEventSlot::set(HandlerList handlers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lists_.emplace_back(new HandlerList(std::move(handlers)));
+    handlers_.store(lists_.back().get(), std::memory_order_release);
+}
+
+// 添加订阅者（复制当前列表后发布）
+void ModuleEventSlot::add(ModuleEventHandlers handlers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<HandlerList> list(new HandlerList(*handlers_.load(std::memory_order_relaxed)));
+    list->push_back(std::move(handlers));
+    handlers_.store(list.get(), std::memory_order_release);
+    lists_.emplace_back(std::move(list));
+}
+
+// 模块事件管理器
+ModuleEventManager& ModuleEventManager::instance() {
+    static ModuleEventManager instance;
+    return instance;
+}
+
+std::shared_ptr<ModuleEventSlot> ModuleEventManager::getSlot(const std::string& module_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = slots_[module_name];
+    if (!slot) {
+        slot = std::make_shared<ModuleEventSlot>();
+    }
+    return slot;
+}
+
+std::shared_ptr<ModuleEventSlot> ModuleEventManager::findSlot(const std::string& module_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(module_name);
+    return it != slots_.end() ? it->second : nullptr;
+}
+
+void ModuleEventManager::registerEventHandlers(const std::string& module_name, ModuleEventHandlers handlers) {
+    getSlot(module_name)->set(ModuleEventSlot::HandlerList{std::move(handlers)});
+}
+
+void ModuleEventManager::addEventHandlers(const std::string& module_name, ModuleEventHandlers handlers) {
+    getSlot(module_name)->add(std::move(handlers));
+}
+
+void ModuleEventManager::removeEventHandlers(const std::string& module_name) {
+    // 保留事件槽，已解析的句柄继续有效
+    auto slot = findSlot(module_name);
+    if (slot) {
+        slot->clear();
+    }
+}
+
+// 回调在管理器锁之外执行
+void ModuleEventManager::triggerInitEvent(const std::shared_ptr<ModuleInterface>& module) {
+    auto slot = findSlot(module->getName());
+    if (slot) {
+        slot->triggerInitEvent(module);
+    }
+}
+
+void ModuleEventManager::triggerStartEvent(const std::shared_ptr<ModuleInterface>& module) {
+    auto slot = findSlot(module->getName());
+    if (slot) {
+        slot->triggerStartEvent(module);
+    }
+}
+
+void ModuleEventManager::triggerStopEvent(const std::shared_ptr<ModuleInterface>& module) {
+    auto slot = findSlot(module->getName());
+    if (slot) {
+        slot->triggerStopEvent(module);
+    }
+}
+
+void ModuleEventManager::triggerUpdateEvent(const std::shared_ptr<ModuleInterface>& module, u64 elapsed_ms) {
+    auto slot = findSlot(module->getName());
+    if (slot) {
+        slot->triggerUpdateEvent(module, elapsed_ms);
+    }
+}
+
+} // namespace next_gen
@@ -0,0 +1,327 @@
+#include "../../include/network/frame_capture.h"
+#include "../../include/utils/logger.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace next_gen {
+
+namespace {
+
+u64 systemTimeNanos() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Segment indexes of <base>.<index>.ngcap files, sorted
+std::vector<u32> findSegments(const std::string& base_path) {
+    std::vector<u32> indexes;
+    fs::path base(base_path);
+    fs::path dir = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    std::string prefix = base.filename().string() + ".";
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) != 0 ||
+            entry.path().extension() != FRAME_CAPTURE_EXTENSION) {
+            continue;
+        }
+        std::string index = name.substr(prefix.size(), name.size() - prefix.size() -
+                                        std::strlen(FRAME_CAPTURE_EXTENSION));
+        if (!index.empty() && std::all_of(index.begin(), index.end(), ::isdigit)) {
+            indexes.push_back(static_cast<u32>(std::stoul(index)));
+        }
+    }
+    std::sort(indexes.begin(), indexes.end());
+    return indexes;
+}
+
+std::string segmentFile(const std::string& base_path, u32 index) {
+    return base_path + "." + std::to_string(index) + FRAME_CAPTURE_EXTENSION;
+}
+
+} // namespace
+
+// FrameCaptureWriter implementation
+FrameCaptureWriter::FrameCaptureWriter()
+    : open_(false),
+      stopping_(false),
+      segment_index_(0),
+      write_pos_(0),
+      captured_frames_(0),
+      dropped_frames_(0) {
+}
+
+FrameCaptureWriter::~FrameCaptureWriter() {
+    close();
+}
+
+Result<void> FrameCaptureWriter::open(const FrameCaptureConfig& config) {
+    if (open_ || writer_thread_.joinable()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Frame capture already open");
+    }
+
+    if (config.path.empty()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Frame capture path is empty");
+    }
+
+    if (config.segment_size < sizeof(FrameCaptureFileHeader) + 4096) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Frame capture segment size too small");
+    }
+
+    config_ = config;
+
+    // A new capture replaces the previous one
+    std::error_code ec;
+    for (u32 index : findSegments(config_.path)) {
+        fs::remove(segmentFile(config_.path, index), ec);
+    }
+
+    segment_index_ = 0;
+    auto result = openSegment();
+    if (result.has_error()) {
+        return result;
+    }
+
+    active_.clear();
+    active_.reserve(config_.buffer_size);
+    pending_.clear();
+    pending_.reserve(config_.buffer_size);
+    stopping_ = false;
+    captured_frames_ = 0;
+    dropped_frames_ = 0;
+
+    writer_thread_ = std::thread(&FrameCaptureWriter::run, this);
+    open_.store(true, std::memory_order_release);
+    return Result<void>();
+}
+
+void FrameCaptureWriter::close() {
+    open_.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        stopping_ = true;
+    }
+    buffer_cv_.notify_one();
+
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    if (file_.isOpen()) {
+        file_.flush(false);
+        file_.close(write_pos_);
+    }
+}
+
+void FrameCaptureWriter::write(CaptureTransport transport, u32 session_id, MessageCategoryType category,
+                               MessageIdType id, const u8* body, size_t size, u64 timestamp_ns) {
+    if (!isOpen()) {
+        return;
+    }
+
+    FrameCaptureRecordHeader header;
+    header.size = static_cast<u32>(sizeof(header) + size);
+    header.transport = static_cast<u8>(transport);
+    header.category = category;
+    header.id = id;
+    header.session_id = session_id;
+    header.reserved = 0;
+    header.timestamp_ns = timestamp_ns;
+
+    bool wake_writer;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        if (active_.size() + header.size > config_.buffer_size) {
+            dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        size_t offset = active_.size();
+        active_.resize(offset + header.size);
+        std::memcpy(active_.data() + offset, &header, sizeof(header));
+        if (size > 0) {
+            std::memcpy(active_.data() + offset + sizeof(header), body, size);
+        }
+        wake_writer = active_.size() >= config_.buffer_size / 2;
+    }
+
+    captured_frames_.fetch_add(1, std::memory_order_relaxed);
+    if (wake_writer) {
+        buffer_cv_.notify_one();
+    }
+}
+
+void FrameCaptureWriter::run() {
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            buffer_cv_.wait_for(lock, std::chrono::milliseconds(config_.flush_interval_ms), [this] {
+                return stopping_ || active_.size() >= config_.buffer_size / 2;
+            });
+            active_.swap(pending_);
+            stopping = stopping_;
+        }
+
+        writeRecords(pending_);
+        pending_.clear();
+
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void FrameCaptureWriter::writeRecords(const std::vector<u8>& records) {
+    // Keep room for the terminating empty record header
+    size_t capacity = file_.isOpen() ? file_.size() - sizeof(u32) : 0;
+
+    size_t pos = 0;
+    while (pos < records.size() && file_.isOpen()) {
+        u32 record_size;
+        std::memcpy(&record_size, records.data() + pos, sizeof(record_size));
+
+        if (sizeof(FrameCaptureFileHeader) + record_size > capacity) {
+            // Record can never fit into a segment
+            dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+            pos += record_size;
+            continue;
+        }
+
+        if (write_pos_ + record_size > capacity) {
+            file_.close(write_pos_);
+            ++segment_index_;
+            auto result = openSegment();
+            if (result.has_error()) {
+                NEXT_GEN_LOG_ERROR("Frame capture stopped: " + std::string(result.error().what()));
+                open_.store(false, std::memory_order_release);
+                return;
+            }
+        }
+
+        std::memcpy(file_.data() + write_pos_, records.data() + pos, record_size);
+        write_pos_ += record_size;
+        pos += record_size;
+    }
+}
+
+Result<void> FrameCaptureWriter::openSegment() {
+    auto result = file_.create(segmentPath(segment_index_), static_cast<size_t>(config_.segment_size));
+    if (result.has_error()) {
+        return result;
+    }
+
+    FrameCaptureFileHeader header;
+    std::memcpy(header.magic, FRAME_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = FRAME_CAPTURE_VERSION;
+    header.reserved = 0;
+    header.segment_index = segment_index_;
+    header.start_time_ns = systemTimeNanos();
+    std::memcpy(file_.data(), &header, sizeof(header));
+
+    write_pos_ = sizeof(header);
+
+    // Retention: remove the segment that fell out of the window
+    if (config_.max_segments > 0 && segment_index_ >= config_.max_segments) {
+        std::error_code ec;
+        fs::remove(segmentPath(segment_index_ - config_.max_segments), ec);
+    }
+
+    return Result<void>();
+}
+
+std::string FrameCaptureWriter::segmentPath(u32 index) const {
+    return segmentFile(config_.path, index);
+}
+
+// FrameCaptureReader implementation
+FrameCaptureReader::FrameCaptureReader()
+    : segment_(0),
+      read_pos_(0),
+      start_time_ns_(0) {
+}
+
+Result<void> FrameCaptureReader::open(const std::string& path) {
+    segments_.clear();
+    if (fs::path(path).extension() == FRAME_CAPTURE_EXTENSION) {
+        segments_.push_back(path);
+    } else {
+        for (u32 index : findSegments(path)) {
+            segments_.push_back(segmentFile(path, index));
+        }
+    }
+
+    if (segments_.empty()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "No capture segments found: " + path);
+    }
+
+    if (!openSegment(0)) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Invalid capture segment: " + segments_[0]);
+    }
+
+    FrameCaptureFileHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    start_time_ns_ = header.start_time_ns;
+    return Result<void>();
+}
+
+bool FrameCaptureReader::next(FrameCaptureRecord& record) {
+    while (file_.isOpen()) {
+        FrameCaptureRecordHeader header;
+        if (read_pos_ + sizeof(header) <= file_.size()) {
+            std::memcpy(&header, file_.data() + read_pos_, sizeof(header));
+        } else {
+            header.size = 0;
+        }
+
+        // End of segment (terminator or truncated record)
+        if (header.size < sizeof(header) || read_pos_ + header.size > file_.size()) {
+            if (!openSegment(segment_ + 1)) {
+                return false;
+            }
+            continue;
+        }
+
+        record.transport = static_cast<CaptureTransport>(header.transport);
+        record.session_id = header.session_id;
+        record.category = header.category;
+        record.id = header.id;
+        record.timestamp_ns = header.timestamp_ns;
+        record.body = file_.data() + read_pos_ + sizeof(header);
+        record.body_size = header.size - sizeof(header);
+
+        read_pos_ += header.size;
+        return true;
+    }
+    return false;
+}
+
+bool FrameCaptureReader::openSegment(size_t index) {
+    file_.close();
+    segment_ = index;
+    if (index >= segments_.size() || file_.openReadOnly(segments_[index]).has_error()) {
+        return false;
+    }
+
+    FrameCaptureFileHeader header;
+    if (file_.size() < sizeof(header)) {
+        file_.close();
+        return false;
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, FRAME_CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FRAME_CAPTURE_VERSION) {
+        file_.close();
+        return false;
+    }
+
+    read_pos_ = sizeof(header);
+    return true;
+}
+
+} // namespace next_gen
@@ -0,0 +1,110 @@
+#include "../../include/network/frame_replay.h"
+#include <chrono>
+#include <thread>
+
+namespace next_gen {
+
+FrameReplayer::FrameReplayer(Service& service, const ReplayConfig& config)
+    : service_(service),
+      config_(config),
+      decoder_(&FrameReplayer::decodeFrame),
+      completed_(0) {
+}
+
+Result<ReplayStats> FrameReplayer::run(const std::string& path) {
+    FrameCaptureReader reader;
+    auto open_result = reader.open(path);
+    if (open_result.has_error()) {
+        return Result<ReplayStats>(open_result.error());
+    }
+
+    lag_.reset();
+    latency_.reset();
+    completed_ = 0;
+
+    ReplayStats stats;
+    u64 replay_start_ns = metricsNowNanos();
+    u64 capture_start_ns = 0;
+
+    FrameCaptureRecord record;
+    while ((config_.max_frames == 0 || stats.frames < config_.max_frames) && reader.next(record)) {
+        if (stats.frames++ == 0) {
+            capture_start_ns = record.timestamp_ns;
+        }
+
+        // Wait for the frame's slot on the (scaled) capture timeline
+        if (config_.speed > 0.0 && record.timestamp_ns > capture_start_ns) {
+            u64 offset_ns = static_cast<u64>((record.timestamp_ns - capture_start_ns) / config_.speed);
+            u64 due_ns = replay_start_ns + offset_ns;
+            u64 now_ns = metricsNowNanos();
+            if (due_ns > now_ns) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(due_ns - now_ns));
+            } else {
+                lag_.record(now_ns - due_ns);
+            }
+        }
+
+        auto message = decoder_(record);
+        if (!message) {
+            ++stats.decode_errors;
+            continue;
+        }
+        message->setSessionId(record.session_id);
+
+        if (service_.postMessage(std::move(message)).has_error()) {
+            ++stats.post_errors;
+            continue;
+        }
+        ++stats.posted;
+    }
+
+    // Drain: wait while completions keep arriving
+    u64 last_completed = completed_.load(std::memory_order_acquire);
+    u64 last_progress_ns = metricsNowNanos();
+    while (last_completed < stats.posted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        u64 completed = completed_.load(std::memory_order_acquire);
+        u64 now_ns = metricsNowNanos();
+        if (completed != last_completed) {
+            last_completed = completed;
+            last_progress_ns = now_ns;
+        } else if (now_ns - last_progress_ns > static_cast<u64>(config_.drain_timeout_ms) * 1000000) {
+            break;
+        }
+    }
+
+    stats.completed = completed_.load(std::memory_order_acquire);
+    stats.elapsed_seconds = (metricsNowNanos() - replay_start_ns) / 1e9;
+    if (stats.elapsed_seconds > 0.0) {
+        stats.throughput = stats.completed / stats.elapsed_seconds;
+    }
+    stats.lag_p99_ns = lag_.percentile(0.99);
+    stats.lag_max_ns = lag_.max();
+    stats.latency_p50_ns = latency_.percentile(0.5);
+    stats.latency_p99_ns = latency_.percentile(0.99);
+    stats.latency_max_ns = latency_.max();
+    return Result<ReplayStats>(std::move(stats));
+}
+
+void FrameReplayer::recordCompletion(const Message& message) {
+    u64 enqueue_ns = message.getEnqueueTime();
+    if (enqueue_ns != 0) {
+        latency_.record(metricsNowNanos() - enqueue_ns);
+    }
+    completed_.fetch_add(1, std::memory_order_release);
+}
+
+std::unique_ptr<Message> FrameReplayer::decodeFrame(const FrameCaptureRecord& record) {
+    auto message = DefaultMessageFactory::instance().createMessage(record.category, record.id);
+    if (!message) {
+        return nullptr;
+    }
+
+    std::vector<u8> body(record.body, record.body + record.body_size);
+    if (message->deserialize(body).has_error()) {
+        return nullptr;
+    }
+    return message;
+}
+
+} // namespace next_gen
@@ -0,0 +1,132 @@
+#include "../../include/network/metrics_endpoint.h"
+#include "../../include/utils/logger.h"
+
+namespace next_gen {
+
+namespace {
+
+// Single scrape: read request head, write snapshot, close
+class MetricsConnection : public std::enable_shared_from_this<MetricsConnection> {
+public:
+    explicit MetricsConnection(asio::io_context& io_context) : socket_(io_context) {}
+
+    asio::ip::tcp::socket& socket() { return socket_; }
+
+    void start() {
+        asio::async_read_until(socket_, request_, "\r\n\r\n",
+            [this, self = shared_from_this()](const AsioErrorCode& error, std::size_t) {
+                if (error) {
+                    return;
+                }
+                handleRequest();
+            });
+    }
+
+private:
+    void handleRequest() {
+        std::istream stream(&request_);
+        std::string method;
+        std::string path;
+        stream >> method >> path;
+
+        std::string body;
+        std::string status;
+        if (method == "GET") {
+            body = MetricsRegistry::instance().exportPrometheus();
+            status = "200 OK";
+        } else {
+            body = "Method not allowed\n";
+            status = "405 Method Not Allowed";
+        }
+
+        response_ = "HTTP/1.1 " + status + "\r\n"
+                    "Content-Type: text/plain; version=0.0.4\r\n"
+                    "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                    "Connection: close\r\n\r\n" + body;
+
+        asio::async_write(socket_, asio::buffer(response_),
+            [this, self = shared_from_this()](const AsioErrorCode&, std::size_t) {
+                AsioErrorCode ec;
+                socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+                socket_.close(ec);
+            });
+    }
+
+    asio::ip::tcp::socket socket_;
+    asio::streambuf request_;
+    std::string response_;
+};
+
+} // namespace
+
+MetricsEndpoint::MetricsEndpoint(const MetricsEndpointConfig& config)
+    : config_(config), running_(false), port_(config.port) {
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stop();
+}
+
+Result<void> MetricsEndpoint::start() {
+    if (running_) {
+        return Result<void>(ErrorCode::SERVICE_ALREADY_STARTED, "Metrics endpoint already started");
+    }
+
+    try {
+        io_context_ = std::make_unique<asio::io_context>();
+
+        asio::ip::tcp::endpoint endpoint(
+            asio::ip::address::from_string(config_.bind_address), config_.port);
+        acceptor_ = std::make_unique<asio::ip::tcp::acceptor>(*io_context_);
+        acceptor_->open(endpoint.protocol());
+        acceptor_->set_option(asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor_->bind(endpoint);
+        acceptor_->listen();
+        port_ = acceptor_->local_endpoint().port();
+    } catch (const std::exception& e) {
+        acceptor_.reset();
+        io_context_.reset();
+        return Result<void>(ErrorCode::NETWORK_ERROR,
+                            "Failed to start metrics endpoint: " + std::string(e.what()));
+    }
+
+    running_ = true;
+    acceptConnection();
+    io_thread_ = std::thread([this]() {
+        io_context_->run();
+    });
+
+    NEXT_GEN_LOG_INFO("Metrics endpoint listening on " + config_.bind_address + ":" + std::to_string(port_));
+    return Result<void>();
+}
+
+void MetricsEndpoint::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    io_context_->stop();
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+
+    acceptor_.reset();
+    io_context_.reset();
+}
+
+void MetricsEndpoint::acceptConnection() {
+    auto connection = std::make_shared<MetricsConnection>(*io_context_);
+    acceptor_->async_accept(connection->socket(),
+        [this, connection](const AsioErrorCode& error) {
+            if (!running_) {
+                return;
+            }
+            if (!error) {
+                connection->start();
+            }
+            acceptConnection();
+        });
+}
+
+} // namespace next_gen
@@ -10,12 +10,15 @@ NetService::NetService(const std::string& name, const NetServiceConfig& config)
       config_(config),
       session_handler_(nullptr),
       next_session_id_(1),
-      total_connections_(0),
-      total_messages_received_(0),
-      total_messages_sent_(0),
-      total_bytes_received_(0),
-      total_bytes_sent_(0),
       last_idle_check_(0) {
+    auto& registry = MetricsRegistry::instance();
+    MetricLabels labels = {{"service", name}};
+    total_connections_ = &registry.counter("next_gen_net_connections_total", "Accepted sessions", labels);
+    active_sessions_ = &registry.gauge("next_gen_net_sessions", "Active sessions", labels);
+    total_messages_received_ = &registry.counter("next_gen_net_messages_received_total", "Messages received", labels);
+    total_messages_sent_ = &registry.counter("next_gen_net_messages_sent_total", "Messages sent", labels);
+    total_bytes_received_ = &registry.counter("next_gen_net_bytes_received_total", "Bytes received", labels);
+    total_bytes_sent_ = &registry.counter("next_gen_net_bytes_sent_total", "Bytes sent", labels);
 }
 
 // Destructor
@@ -53,10 +56,21 @@ Result<void> NetService::onStart() {
     NEXT_GEN_LOG_INFO("Starting network service: " + getName() + 
                      " on " + config_.bind_address + ":" + std::to_string(config_.port));
     
+    // Open frame capture before the first frame can arrive
+    if (!config_.capture.path.empty()) {
+        auto capture_result = capture_.open(config_.capture);
+        if (capture_result.has_error()) {
+            NEXT_GEN_LOG_ERROR("Failed to open frame capture: " + capture_result.error().message());
+            return capture_result;
+        }
+        NEXT_GEN_LOG_INFO("Capturing inbound frames to " + config_.capture.path);
+    }
+    
     // Start accepting connections (implementation specific)
     auto result = startServer();
     if (result.has_error()) {
         NEXT_GEN_LOG_ERROR("Failed to start accepting connections: " + result.error().message());
+        capture_.close();
         return result;
     }
     
@@ -81,6 +95,13 @@ Result<void> NetService::onStop() {
     // Close all active sessions
     closeAllSessions();
     
+    // Write remaining captured frames
+    if (capture_.isOpen()) {
+        NEXT_GEN_LOG_INFO("Frame capture closed: " + std::to_string(capture_.getCapturedFrames()) +
+                         " frames, " + std::to_string(capture_.getDroppedFrames()) + " dropped");
+    }
+    capture_.close();
+    
     // Cleanup network library (implementation specific)
     result = cleanupNetworkLibrary();
     if (result.has_error()) {
@@ -126,8 +147,9 @@ Result<void> NetService::addSession(std::shared_ptr<Session> session) {
     // Add session to map
     sessions_[id] = session;
     
-    // Increment total connections
-    total_connections_++;
+    // Update connection statistics
+    total_connections_->inc();
+    active_sessions_->inc();
     
     // Notify session created
     if (session_handler_) {
@@ -157,6 +179,7 @@ Result<void> NetService::removeSession(SessionId id) {
     
     // Remove from map
     sessions_.erase(it);
+    active_sessions_->dec();
     
     // Notify session closed
     if (session_handler_) {
@@ -288,14 +311,8 @@ void NetService::handleReceivedMessage(std::shared_ptr<Session> session, std::un
         return;
     }
     
-    // Increment message counter
-    total_messages_received_++;
-    
-    // Add message size to byte counter
-    auto serialized = message->serialize();
-    if (!serialized.has_error()) {
-        total_bytes_received_ += serialized.value().size();
-    }
+    // Increment message counter (bytes are counted by the transport)
+    total_messages_received_->inc();
     
     // Notify message received
     if (session_handler_) {
@@ -309,14 +326,8 @@ void NetService::handleSentMessage(std::shared_ptr<Session> session, const Messa
         return;
     }
     
-    // Increment message counter
-    total_messages_sent_++;
-    
-    // Add message size to byte counter
-    auto serialized = message.serialize();
-    if (!serialized.has_error()) {
-        total_bytes_sent_ += serialized.value().size();
-    }
+    // Increment message counter (bytes are counted by the transport)
+    total_messages_sent_->inc();
     
     // Notify message sent
     if (session_handler_) {
@@ -81,13 +81,14 @@ Result<void> TcpService::startServer() {
         acceptor_->set_option(asio::socket_base::receive_buffer_size(tcp_config_.socket_recv_buffer_size));
         acceptor_->set_option(asio::socket_base::send_buffer_size(tcp_config_.socket_send_buffer_size));
         
-        // Start accepting connections
+        // Start accepting connections (acceptConnection() requires the running flag)
+        running_ = true;
         acceptConnection();
         
-        // Start IO threads
-        running_ = true;
+        // Start IO threads on the node of the service worker
         for (u32 i = 0; i < tcp_config_.io_thread_count; ++i) {
             io_threads_.emplace_back([this]() {
+                ThreadPlacement::instance().pinCurrentThread(getPlacementNode(), "io:" + getName());
                 try {
                     io_context_->run();
                 } catch (const std::exception& e) {
@@ -2,6 +2,8 @@
 #include "../../include/network/tcp_service.h"
 #include "../../include/message/message.h"
 #include "../../include/network/asio_wrapper.h"
+#include "../../include/utils/tracer.h"
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <unordered_map>
@@ -18,6 +20,9 @@ TcpSession::TcpSession(TcpService* service, asio::io_context& io_context, Sessio
       id_(id),
       state_(SessionState::DISCONNECTED),
       remote_address_(""),
+      frame_start_ns_(0),
+      send_compression_(static_cast<u8>(CompressionAlgorithm::NONE)),
+      compression_negotiated_(false),
       attributes_mutex_(),
       attributes_() {
     
@@ -55,54 +60,33 @@ Result<void> TcpSession::send(const Message& message) {
         return Result<void>(ErrorCode::CONNECTION_CLOSED, "Session is not connected");
     }
     
+    // Replies sent while handling a traced message belong to its trace
+    u64 trace_id = message.getTraceId() != 0 ? message.getTraceId() : Tracer::currentTraceId();
+    u64 send_start_ns = trace_id != 0 ? metricsNowNanos() : 0;
+    
     // Serialize message
     auto serialized_result = message.serialize();
     if (serialized_result.has_error()) {
         return Result<void>(serialized_result.error());
     }
     
-    auto& serialized_body = serialized_result.value();
-    
-    // Create buffer with header + body
-    std::vector<u8> buffer;
-    buffer.resize(HEADER_SIZE + serialized_body.size());
-    
-    // Write category
-    MessageCategoryType category = message.getCategory();
-    std::memcpy(buffer.data(), &category, sizeof(category));
-    
-    // Write ID
-    MessageIdType id = message.getId();
-    std::memcpy(buffer.data() + sizeof(category), &id, sizeof(id));
-    
-    // Write body size
-    u32 body_size = static_cast<u32>(serialized_body.size());
-    std::memcpy(buffer.data() + sizeof(category) + sizeof(id), &body_size, sizeof(body_size));
-    
-    // Write body
-    if (body_size > 0) {
-        std::memcpy(buffer.data() + HEADER_SIZE, serialized_body.data(), body_size);
+    std::vector<u8> serialized_body = std::move(serialized_result).value();
+    if (serialized_body.size() > FRAME_BODY_SIZE_MASK) {
+        return Result<void>(ErrorCode::MESSAGE_TOO_LARGE, "Message body exceeds frame size limit");
     }
     
-    // Lock write queue
-    {
-        std::lock_guard<std::mutex> lock(write_mutex_);
-        
-        // Check if write in progress
-        bool write_in_progress = !write_queue_.empty();
-        
-        // Add to write queue
-        write_queue_.push(std::move(buffer));
-        
-        // Start write if not in progress
-        if (!write_in_progress) {
-            writeMessage();
-        }
-    }
+    // Create buffer with header + body
+    auto algorithm = static_cast<CompressionAlgorithm>(send_compression_.load(std::memory_order_acquire));
+    queueFrame(buildFrame(message.getCategory(), message.getId(), serialized_body, algorithm));
     
     // Reset idle timer
     resetIdleTimer();
     
+    if (trace_id != 0) {
+        Tracer::instance().recordSpan(trace_id, "send", send_start_ns, metricsNowNanos(),
+                                      message.getCategory(), message.getId(), id_);
+    }
+    
     return Result<void>();
 }
 
@@ -187,6 +171,10 @@ void TcpSession::start() {
         remote_address_ = "unknown";
     }
     
+    // Delta baselines never carry over from an earlier connection
+    send_delta_context_.reset();
+    receive_delta_context_.reset();
+    
     // Set state to connected
     state_ = SessionState::CONNECTED;
     
@@ -262,6 +250,8 @@ void TcpSession::handleReadHeader(const std::error_code& error, std::size_t byte
     
     // Reset idle timer
     resetIdleTimer();
+    service_->recordBytesReceived(bytes_transferred);
+    frame_start_ns_ = metricsNowNanos();
     
     // Extract header fields
     MessageCategoryType category;
@@ -270,14 +260,17 @@ void TcpSession::handleReadHeader(const std::error_code& error, std::size_t byte
     MessageIdType id;
     std::memcpy(&id, read_buffer_.data() + sizeof(category), sizeof(id));
     
-    u32 body_size;
-    std::memcpy(&body_size, read_buffer_.data() + sizeof(category) + sizeof(id), sizeof(body_size));
+    u32 size_field;
+    std::memcpy(&size_field, read_buffer_.data() + sizeof(category) + sizeof(id), sizeof(size_field));
+    u32 body_size = size_field & FRAME_BODY_SIZE_MASK;
     
     // Check body size
     if (body_size > 0) {
         // Read body
         readBody(body_size);
     } else {
+        service_->captureFrame(CaptureTransport::TCP, id_, category, id, nullptr, 0, frame_start_ns_);
+        
         // Create message
         auto message = DefaultMessageFactory::instance().createMessage(category, id);
         if (!message) {
@@ -292,7 +285,7 @@ void TcpSession::handleReadHeader(const std::error_code& error, std::size_t byte
         }
         
         // Trigger message received event
-        service_->handleReceivedMessageById(shared_from_this(), std::move(message));
+        deliverMessage(std::move(message));
         
         // Continue reading
         read_buffer_.resize(HEADER_SIZE);
@@ -312,6 +305,7 @@ void TcpSession::handleReadBody(const std::error_code& error, std::size_t bytes_
     
     // Reset idle timer
     resetIdleTimer();
+    service_->recordBytesReceived(bytes_transferred);
     
     // Extract header fields
     MessageCategoryType category;
@@ -320,8 +314,47 @@ void TcpSession::handleReadBody(const std::error_code& error, std::size_t bytes_
     MessageIdType id;
     std::memcpy(&id, read_buffer_.data() + sizeof(category), sizeof(id));
     
-    u32 body_size;
-    std::memcpy(&body_size, read_buffer_.data() + sizeof(category) + sizeof(id), sizeof(body_size));
+    u32 size_field;
+    std::memcpy(&size_field, read_buffer_.data() + sizeof(category) + sizeof(id), sizeof(size_field));
+    auto algorithm = static_cast<CompressionAlgorithm>(size_field >> FRAME_COMPRESSION_SHIFT);
+    const u8* body = read_buffer_.data() + HEADER_SIZE;
+    size_t body_size = read_buffer_.size() - HEADER_SIZE;
+    
+    // Compression negotiation is handled by the session (server role only)
+    if (category == FRAME_CONTROL_CATEGORY &&
+        (id == FRAME_CONTROL_COMPRESSION || id == FRAME_CONTROL_COMPRESSION_ANSWER)) {
+        if (id == FRAME_CONTROL_COMPRESSION) {
+            handleCompressionHello(body, body_size);
+        } else {
+            service_->handleSessionErrorById(shared_from_this(),
+                Error(ErrorCode::INVALID_MESSAGE, "Unexpected compression answer"));
+        }
+        
+        // Continue reading
+        read_buffer_.resize(HEADER_SIZE);
+        readHeader();
+        return;
+    }
+    
+    // Decompress body
+    std::vector<u8> body_data;
+    if (algorithm == CompressionAlgorithm::NONE) {
+        body_data.assign(body, body + body_size);
+    } else {
+        auto decompress_result = decompressBody(algorithm, body, body_size, body_data);
+        if (decompress_result.has_error()) {
+            service_->handleSessionErrorById(shared_from_this(), decompress_result.error());
+            
+            // Continue reading
+            read_buffer_.resize(HEADER_SIZE);
+            readHeader();
+            return;
+        }
+    }
+    
+    // Captured frames hold the uncompressed body
+    service_->captureFrame(CaptureTransport::TCP, id_, category, id, body_data.data(), body_data.size(),
+                           frame_start_ns_);
     
     // Create message
     auto message = DefaultMessageFactory::instance().createMessage(category, id);
@@ -337,7 +370,6 @@ void TcpSession::handleReadBody(const std::error_code& error, std::size_t bytes_
     }
     
     // Deserialize message
-    std::vector<u8> body_data(read_buffer_.begin() + HEADER_SIZE, read_buffer_.end());
     auto result = message->deserialize(body_data);
     if (result.has_error()) {
         // Handle error
@@ -351,7 +383,7 @@ void TcpSession::handleReadBody(const std::error_code& error, std::size_t bytes_
     }
     
     // Trigger message received event
-    service_->handleReceivedMessageById(shared_from_this(), std::move(message));
+    deliverMessage(std::move(message));
     
     // Continue reading
     read_buffer_.resize(HEADER_SIZE);
@@ -370,6 +402,7 @@ void TcpSession::handleWrite(const std::error_code& error, std::size_t bytes_tra
     
     // Reset idle timer
     resetIdleTimer();
+    service_->recordBytesSent(bytes_transferred);
     
     // Lock write queue
     std::lock_guard<std::mutex> lock(write_mutex_);
@@ -383,6 +416,159 @@ void TcpSession::handleWrite(const std::error_code& error, std::size_t bytes_tra
     }
 }
 
+// Build frame (header + body), compressing the body if worthwhile
+std::vector<u8> TcpSession::buildFrame(MessageCategoryType category, MessageIdType id,
+                                       const std::vector<u8>& body, CompressionAlgorithm algorithm) {
+    const CompressionConfig& config = service_->getTcpConfig().compression;
+    std::vector<u8> buffer;
+    u32 body_size = static_cast<u32>(body.size());
+    u32 flags = 0;
+    
+    // Compressed body: original size (u32) + data, kept only if smaller than the raw body
+    if (algorithm != CompressionAlgorithm::NONE && body.size() >= config.threshold &&
+        body.size() > sizeof(u32) + 1) {
+        size_t bound = Compression::compressBound(algorithm, body.size());
+        size_t capacity = std::min(bound, body.size() - sizeof(u32) - 1);
+        buffer.resize(HEADER_SIZE + sizeof(u32) + bound);
+        size_t compressed_size = Compression::compress(algorithm, body.data(), body.size(),
+                                                       buffer.data() + HEADER_SIZE + sizeof(u32), capacity,
+                                                       compression_dictionary_.get(), config.level);
+        if (compressed_size > 0) {
+            std::memcpy(buffer.data() + HEADER_SIZE, &body_size, sizeof(body_size));
+            body_size = static_cast<u32>(sizeof(u32) + compressed_size);
+            flags = static_cast<u32>(algorithm) << FRAME_COMPRESSION_SHIFT;
+            buffer.resize(HEADER_SIZE + body_size);
+        }
+    }
+    
+    if (flags == 0) {
+        buffer.resize(HEADER_SIZE + body.size());
+        if (!body.empty()) {
+            std::memcpy(buffer.data() + HEADER_SIZE, body.data(), body.size());
+        }
+    }
+    
+    // Write header
+    u32 size_field = body_size | flags;
+    std::memcpy(buffer.data(), &category, sizeof(category));
+    std::memcpy(buffer.data() + sizeof(category), &id, sizeof(id));
+    std::memcpy(buffer.data() + sizeof(category) + sizeof(id), &size_field, sizeof(size_field));
+    return buffer;
+}
+
+// Queue frame for writing
+void TcpSession::queueFrame(std::vector<u8> frame) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    
+    // Check if write in progress
+    bool write_in_progress = !write_queue_.empty();
+    
+    // Add to write queue
+    write_queue_.push(std::move(frame));
+    
+    // Start write if not in progress
+    if (!write_in_progress) {
+        writeMessage();
+    }
+}
+
+// Decompress frame body
+Result<void> TcpSession::decompressBody(CompressionAlgorithm algorithm, const u8* data, size_t size,
+                                        std::vector<u8>& body_data) {
+    const CompressionConfig& config = service_->getTcpConfig().compression;
+    if (!Compression::isAvailable(algorithm)) {
+        return Result<void>(ErrorCode::INVALID_MESSAGE, "Unsupported frame compression");
+    }
+    
+    // Only the algorithm chosen by the hello answer is accepted
+    if (!compression_negotiated_ ||
+        static_cast<u8>(algorithm) != send_compression_.load(std::memory_order_acquire)) {
+        return Result<void>(ErrorCode::INVALID_MESSAGE, "Frame compression not negotiated");
+    }
+    
+    u32 original_size;
+    if (size < sizeof(original_size)) {
+        return Result<void>(ErrorCode::INVALID_MESSAGE, "Truncated compressed frame");
+    }
+    std::memcpy(&original_size, data, sizeof(original_size));
+    if (original_size > config.max_decompressed_size) {
+        return Result<void>(ErrorCode::MESSAGE_TOO_LARGE, "Decompressed frame exceeds size limit");
+    }
+    
+    body_data.resize(original_size);
+    if (!Compression::decompress(algorithm, data + sizeof(original_size), size - sizeof(original_size),
+                                 body_data.data(), original_size, compression_dictionary_.get())) {
+        return Result<void>(ErrorCode::INVALID_MESSAGE, "Failed to decompress frame");
+    }
+    return Result<void>();
+}
+
+// Answer compression hello: pick the configured algorithm if the peer supports it,
+// otherwise LZ4, and use the dictionary only if both sides have the same one
+void TcpSession::handleCompressionHello(const u8* data, size_t size) {
+    if (compression_negotiated_ || size < FRAME_COMPRESSION_HELLO_SIZE) {
+        service_->handleSessionErrorById(shared_from_this(),
+            Error(ErrorCode::INVALID_MESSAGE, "Invalid compression hello"));
+        return;
+    }
+    
+    // Later versions may change the layout, never guess at their fields
+    if (data[0] != FRAME_COMPRESSION_VERSION) {
+        service_->handleSessionErrorById(shared_from_this(),
+            Error(ErrorCode::INVALID_MESSAGE,
+                  "Unsupported compression hello version " + std::to_string(data[0])));
+        return;
+    }
+    compression_negotiated_ = true;
+    
+    u8 peer_mask = data[1];
+    u32 peer_dictionary_id;
+    std::memcpy(&peer_dictionary_id, data + 2, sizeof(peer_dictionary_id));
+    
+    const CompressionConfig& config = service_->getTcpConfig().compression;
+    u8 common = peer_mask & Compression::availableMask();
+    CompressionAlgorithm chosen = CompressionAlgorithm::NONE;
+    if (config.algorithm != CompressionAlgorithm::NONE) {
+        if (common & compressionMaskBit(config.algorithm)) {
+            chosen = config.algorithm;
+        } else if (common & compressionMaskBit(CompressionAlgorithm::LZ4)) {
+            chosen = CompressionAlgorithm::LZ4;
+        }
+    }
+    
+    u32 dictionary_id = 0;
+    if (chosen != CompressionAlgorithm::NONE && config.dictionary &&
+        config.dictionary->getId() == peer_dictionary_id) {
+        compression_dictionary_ = config.dictionary;
+        dictionary_id = peer_dictionary_id;
+    }
+    
+    // Answer uncompressed, then compress everything queued after it
+    std::vector<u8> answer(FRAME_COMPRESSION_HELLO_SIZE);
+    answer[0] = FRAME_COMPRESSION_VERSION;
+    answer[1] = chosen != CompressionAlgorithm::NONE ? compressionMaskBit(chosen) : 0;
+    std::memcpy(answer.data() + 2, &dictionary_id, sizeof(dictionary_id));
+    queueFrame(buildFrame(FRAME_CONTROL_CATEGORY, FRAME_CONTROL_COMPRESSION_ANSWER, answer, CompressionAlgorithm::NONE));
+    send_compression_.store(static_cast<u8>(chosen), std::memory_order_release);
+}
+
+// Deliver decoded message, starting a trace if sampled
+void TcpSession::deliverMessage(std::unique_ptr<Message> message) {
+    u64 trace_id = Tracer::instance().startTrace();
+    if (trace_id == 0) {
+        service_->handleReceivedMessageById(shared_from_this(), std::move(message));
+        return;
+    }
+    
+    message->setTraceId(trace_id);
+    Tracer::instance().recordSpan(trace_id, "receive", frame_start_ns_, metricsNowNanos(),
+                                  message->getCategory(), message->getId(), id_);
+    
+    // Messages created by the session handler join the trace
+    TraceScope trace_scope(trace_id);
+    service_->handleReceivedMessageById(shared_from_this(), std::move(message));
+}
+
 // Reset idle timer
 void TcpSession::resetIdleTimer() {
     last_activity_time_ = std::chrono::steady_clock::now();
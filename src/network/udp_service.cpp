@@ -1,6 +1,7 @@
 #include "../../include/network/udp_service.h"
 #include "../../include/utils/logger.h"
 #include "../../include/message/message.h"
+#include "../../include/utils/thread_placement.h"
 
 namespace next_gen {
 
@@ -132,6 +133,17 @@ Result<void> UdpService::startServer() {
         
         socket_->bind(endpoint);
         
+        // No IO threads: the socket is polled by the service worker, which
+        // is already pinned to the service node. Keep its buffer there too.
+        auto& placement = ThreadPlacement::instance();
+        if (placement.enabled()) {
+            auto bound = placement.bindMemory(receive_buffer_.data(), receive_buffer_.size(),
+                                              getPlacementNode());
+            if (bound.has_error()) {
+                NEXT_GEN_LOG_WARNING("Failed to bind UDP receive buffer: " + std::string(bound.error().what()));
+            }
+        }
+        
         // Start receiving
         receiving_ = true;
         startReceive();
@@ -198,8 +210,8 @@ Result<void> UdpService::sendTo(const UdpEndpointId& endpoint_id, const void* da
         );
         
         // Update statistics
-        total_bytes_sent_ += size;
-        total_messages_sent_++;
+        total_bytes_sent_->inc(size);
+        total_messages_sent_->inc();
         
         return Result<void>::success();
     } catch (const std::exception& e) {
@@ -234,11 +246,27 @@ void UdpService::handleReceive(const asio::error_code& error, std::size_t bytes_
         };
         
         // Update statistics
-        total_bytes_received_ += bytes_transferred;
-        total_messages_received_++;
+        total_bytes_received_->inc(bytes_transferred);
+        total_messages_received_->inc();
+        
+        u64 receive_ns = metricsNowNanos();
         
         // Process the received datagram
         handleDatagram(endpoint_id, receive_buffer_.data(), bytes_transferred);
+        
+        // Capture the raw datagram under the session it was assigned to
+        if (getFrameCapture().isOpen()) {
+            SessionId session_id = 0;
+            {
+                std::lock_guard<std::mutex> lock(endpoint_map_mutex_);
+                auto it = endpoint_to_session_.find(endpoint_id);
+                if (it != endpoint_to_session_.end()) {
+                    session_id = it->second;
+                }
+            }
+            captureFrame(CaptureTransport::UDP, session_id, 0, 0, receive_buffer_.data(), bytes_transferred,
+                         receive_ns);
+        }
     } else if (error) {
         Logger::error("{}: Error receiving datagram: {}", getName(), error.message());
     }
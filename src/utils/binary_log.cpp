@@ -0,0 +1,261 @@
+#include "../../include/utils/binary_log.h"
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace next_gen {
+
+// BinaryLogger implementation
+BinaryLogger& BinaryLogger::instance() {
+    static BinaryLogger instance;
+    return instance;
+}
+
+Result<void> BinaryLogger::open(const BinaryLogConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (open_) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Binary log already open");
+    }
+
+    if (config.segment_size < sizeof(BinaryLogFileHeader) + 4096) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Binary log segment size too small");
+    }
+
+    config_ = config;
+
+    // Continue after the highest existing segment index
+    segment_index_ = 0;
+    fs::path base(config_.path);
+    fs::path dir = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    std::string prefix = base.filename().string() + ".";
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) != 0 ||
+            entry.path().extension() != BINARY_LOG_EXTENSION) {
+            continue;
+        }
+        std::string index = name.substr(prefix.size(), name.size() - prefix.size() -
+                                        std::strlen(BINARY_LOG_EXTENSION));
+        if (!index.empty() && std::all_of(index.begin(), index.end(), ::isdigit)) {
+            segment_index_ = std::max(segment_index_, static_cast<u32>(std::stoul(index)) + 1);
+        }
+    }
+
+    auto result = openSegment();
+    if (result.has_error()) {
+        return result;
+    }
+
+    open_.store(true, std::memory_order_release);
+    return Result<void>();
+}
+
+void BinaryLogger::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    open_.store(false, std::memory_order_release);
+    if (file_.isOpen()) {
+        file_.flush(false);
+        file_.close(write_pos_);
+    }
+}
+
+void BinaryLogger::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush(true);
+}
+
+u32 BinaryLogger::registerSite(LogLevel level, const char* file, int line,
+                               const char* function, const char* format) {
+    std::lock_guard<std::mutex> lock(sites_mutex_);
+
+    Site site;
+    site.level = level;
+    site.file = file ? file : "";
+    site.line = line;
+    site.function = function ? function : "";
+    site.format = format ? format : "";
+    sites_.push_back(std::move(site));
+
+    return static_cast<u32>(sites_.size() - 1);
+}
+
+u32 BinaryLogger::currentThreadIndex() {
+    static std::atomic<u32> next_index(1);
+    thread_local u32 index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+u64 BinaryLogger::currentTimeNanos() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+u8* BinaryLogger::reserve(u32 site_id, size_t record_size) {
+    if (!file_.isOpen()) {
+        return nullptr;
+    }
+
+    // Keep room for the terminating empty record header
+    size_t capacity = file_.size() - sizeof(u32);
+    if (sizeof(BinaryLogFileHeader) + record_size > capacity) {
+        // Record can never fit into a segment
+        return nullptr;
+    }
+
+    if (site_id >= emitted_sites_.size() || !emitted_sites_[site_id]) {
+        if (!emitSite(site_id)) {
+            return nullptr;
+        }
+    }
+
+    if (write_pos_ + record_size > capacity) {
+        file_.close(write_pos_);
+        ++segment_index_;
+        if (openSegment().has_error()) {
+            open_.store(false, std::memory_order_release);
+            return nullptr;
+        }
+        if (!emitSite(site_id)) {
+            return nullptr;
+        }
+    }
+
+    u8* out = file_.data() + write_pos_;
+    write_pos_ += record_size;
+    return out;
+}
+
+void BinaryLogger::commit(u8* out, BinaryLogRecordType type, LogLevel level, u16 arg_count,
+                          u32 site_id, u64 timestamp_ns, size_t record_size) {
+    BinaryLogRecordHeader header;
+    header.size = 0;
+    header.type = static_cast<u8>(type);
+    header.level = static_cast<u8>(level);
+    header.arg_count = arg_count;
+    header.site_id = site_id;
+    header.thread_id = currentThreadIndex();
+    header.timestamp_ns = timestamp_ns;
+
+    std::memcpy(out + sizeof(header.size), reinterpret_cast<const u8*>(&header) + sizeof(header.size),
+                sizeof(header) - sizeof(header.size));
+
+    u32 size = static_cast<u32>(record_size);
+    std::memcpy(out, &size, sizeof(size));
+}
+
+bool BinaryLogger::emitSite(u32 site_id) {
+    Site site;
+    {
+        std::lock_guard<std::mutex> lock(sites_mutex_);
+        if (site_id >= sites_.size()) {
+            return false;
+        }
+        site = sites_[site_id];
+    }
+
+    // Payload: line, file length, function length, format length, strings
+    size_t payload_size = sizeof(u32) + 3 * sizeof(u16) +
+                          site.file.size() + site.function.size() + site.format.size();
+    size_t record_size = sizeof(BinaryLogRecordHeader) + payload_size;
+
+    size_t capacity = file_.size() - sizeof(u32);
+    if (write_pos_ + record_size > capacity) {
+        file_.close(write_pos_);
+        ++segment_index_;
+        if (openSegment().has_error()) {
+            open_.store(false, std::memory_order_release);
+            return false;
+        }
+    }
+
+    u8* out = file_.data() + write_pos_;
+    u8* p = out + sizeof(BinaryLogRecordHeader);
+
+    u32 line = static_cast<u32>(site.line);
+    u16 file_len = static_cast<u16>(std::min<size_t>(site.file.size(), 0xFFFF));
+    u16 function_len = static_cast<u16>(std::min<size_t>(site.function.size(), 0xFFFF));
+    u16 format_len = static_cast<u16>(std::min<size_t>(site.format.size(), 0xFFFF));
+
+    std::memcpy(p, &line, sizeof(line)); p += sizeof(line);
+    std::memcpy(p, &file_len, sizeof(file_len)); p += sizeof(file_len);
+    std::memcpy(p, &function_len, sizeof(function_len)); p += sizeof(function_len);
+    std::memcpy(p, &format_len, sizeof(format_len)); p += sizeof(format_len);
+    std::memcpy(p, site.file.data(), file_len); p += file_len;
+    std::memcpy(p, site.function.data(), function_len); p += function_len;
+    std::memcpy(p, site.format.data(), format_len); p += format_len;
+
+    record_size = static_cast<size_t>(p - out);
+    write_pos_ += record_size;
+    commit(out, BinaryLogRecordType::SITE, site.level, 0, site_id, currentTimeNanos(), record_size);
+
+    if (site_id >= emitted_sites_.size()) {
+        emitted_sites_.resize(site_id + 1, false);
+    }
+    emitted_sites_[site_id] = true;
+    return true;
+}
+
+Result<void> BinaryLogger::openSegment() {
+    std::string path = segmentPath(segment_index_);
+    auto result = file_.create(path, static_cast<size_t>(config_.segment_size));
+    if (result.has_error()) {
+        return result;
+    }
+
+    BinaryLogFileHeader header;
+    std::memcpy(header.magic, BINARY_LOG_MAGIC, sizeof(header.magic));
+    header.version = BINARY_LOG_VERSION;
+    header.reserved = 0;
+    header.segment_index = segment_index_;
+    header.start_time_ns = currentTimeNanos();
+    std::memcpy(file_.data(), &header, sizeof(header));
+
+    write_pos_ = sizeof(header);
+    std::fill(emitted_sites_.begin(), emitted_sites_.end(), false);
+
+    // Retention: remove the segment that fell out of the window
+    if (config_.max_segments > 0 && segment_index_ >= config_.max_segments) {
+        std::error_code ec;
+        fs::remove(segmentPath(segment_index_ - config_.max_segments), ec);
+    }
+
+    return Result<void>();
+}
+
+std::string BinaryLogger::segmentPath(u32 index) const {
+    return config_.path + "." + std::to_string(index) + BINARY_LOG_EXTENSION;
+}
+
+// BinaryLogSink implementation
+void BinaryLogSink::log(const LogRecord& record) {
+    auto& logger = BinaryLogger::instance();
+    if (!logger.isOpen()) {
+        return;
+    }
+
+    u32 site_id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string key = record.file + ":" + std::to_string(record.line) + ":" +
+                          std::to_string(static_cast<int>(record.level));
+        auto it = sites_.find(key);
+        if (it == sites_.end()) {
+            site_id = logger.registerSite(record.level, record.file.c_str(), record.line,
+                                          record.function.c_str(), "{}");
+            sites_[key] = site_id;
+        } else {
+            site_id = it->second;
+        }
+    }
+
+    u64 timestamp_ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        record.time.time_since_epoch()).count());
+    logger.writeAt(timestamp_ns, site_id, record.level, record.message);
+}
+
+} // namespace next_gen
@@ -0,0 +1,536 @@
+#include "../../include/utils/compression.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#ifdef NEXT_GEN_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace next_gen {
+
+namespace {
+
+// LZ4 block format constants
+constexpr size_t LZ4_MIN_MATCH = 4;
+constexpr size_t LZ4_LAST_LITERALS = 5;     // Last 5 bytes are always literals
+constexpr size_t LZ4_MF_LIMIT = 12;         // Last match must start 12 bytes before the end
+constexpr size_t LZ4_MAX_DISTANCE = 65535;
+constexpr u32 LZ4_HASH_LOG = 12;
+constexpr u32 LZ4_NO_POSITION = 0xFFFFFFFFu;
+
+inline u32 read32(const u8* p) {
+    u32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline u32 lz4Hash(u32 sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ4_HASH_LOG);
+}
+
+// Write an LZ4 length continuation (255 bytes followed by the remainder)
+inline bool writeLength(u8*& op, const u8* end, size_t length) {
+    while (length >= 255) {
+        if (op >= end) {
+            return false;
+        }
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= end) {
+        return false;
+    }
+    *op++ = static_cast<u8>(length);
+    return true;
+}
+
+// Read an LZ4 length continuation
+inline bool readLength(const u8*& ip, const u8* end, size_t& length) {
+    u8 byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Emit one sequence: literals [literal, literal + literal_length) then a match (if match_length > 0)
+bool lz4EmitSequence(u8*& op, const u8* end, const u8* literal, size_t literal_length,
+                     size_t offset, size_t match_length) {
+    if (op >= end) {
+        return false;
+    }
+    u8* token = op++;
+    size_t match_code = match_length > 0 ? match_length - LZ4_MIN_MATCH : 0;
+    *token = static_cast<u8>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15));
+
+    if (literal_length >= 15 && !writeLength(op, end, literal_length - 15)) {
+        return false;
+    }
+    if (static_cast<size_t>(end - op) < literal_length) {
+        return false;
+    }
+    if (literal_length > 0) {
+        std::memcpy(op, literal, literal_length);
+        op += literal_length;
+    }
+
+    if (match_length == 0) {
+        return true;
+    }
+    if (end - op < 2) {
+        return false;
+    }
+    *op++ = static_cast<u8>(offset & 0xFF);
+    *op++ = static_cast<u8>(offset >> 8);
+    return match_code < 15 || writeLength(op, end, match_code - 15);
+}
+
+// Build the hash table for a dictionary (positions index the dictionary content)
+std::vector<u32> lz4BuildTable(const std::vector<u8>& content) {
+    std::vector<u32> table(size_t(1) << LZ4_HASH_LOG, LZ4_NO_POSITION);
+    for (size_t pos = 0; pos + sizeof(u32) <= content.size(); ++pos) {
+        table[lz4Hash(read32(content.data() + pos))] = static_cast<u32>(pos);
+    }
+    return table;
+}
+
+// LZ4 block compression. Positions live in one space: [0, dict_size) is the
+// dictionary and [dict_size, dict_size + size) the input, so matches can start
+// in the dictionary and run on into the input.
+size_t lz4Compress(const u8* src, size_t size, u8* dst, size_t capacity, const CompressionDictionary* dictionary,
+                   const std::vector<u32>* dict_table) {
+    const u8* dict = dictionary ? dictionary->getContent().data() : nullptr;
+    const size_t dict_size = dictionary ? dictionary->getContent().size() : 0;
+    u8* op = dst;
+    const u8* op_end = dst + capacity;
+
+    if (size < LZ4_MF_LIMIT + 1) {
+        return lz4EmitSequence(op, op_end, src, size, 0, 0) ? static_cast<size_t>(op - dst) : 0;
+    }
+
+    u32 table[size_t(1) << LZ4_HASH_LOG];
+    if (dict_table) {
+        std::memcpy(table, dict_table->data(), sizeof(table));
+    } else {
+        std::fill(std::begin(table), std::end(table), LZ4_NO_POSITION);
+    }
+
+    auto byteAt = [&](size_t pos) -> u8 {
+        return pos < dict_size ? dict[pos] : src[pos - dict_size];
+    };
+
+    const size_t match_limit = size - LZ4_LAST_LITERALS;
+    const size_t mf_limit = size - LZ4_MF_LIMIT;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    while (ip <= mf_limit) {
+        u32 sequence = read32(src + ip);
+        u32 hash = lz4Hash(sequence);
+        size_t candidate = table[hash];
+        size_t current = dict_size + ip;
+        table[hash] = static_cast<u32>(current);
+
+        bool found = candidate != LZ4_NO_POSITION && current - candidate <= LZ4_MAX_DISTANCE;
+        if (found) {
+            // Dictionary candidates near its end would read across the boundary
+            found = candidate + sizeof(u32) <= dict_size
+                ? read32(dict + candidate) == sequence
+                : candidate >= dict_size && read32(src + (candidate - dict_size)) == sequence;
+        }
+        if (!found) {
+            // Skip faster through incompressible data
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        // Extend match backwards over pending literals, then forwards
+        while (ip > anchor && candidate > 0 && byteAt(candidate - 1) == src[ip - 1]) {
+            --ip;
+            --candidate;
+        }
+        size_t length = LZ4_MIN_MATCH;
+        while (ip + length < match_limit && byteAt(candidate + length) == src[ip + length]) {
+            ++length;
+        }
+
+        if (!lz4EmitSequence(op, op_end, src + anchor, ip - anchor, dict_size + ip - candidate, length)) {
+            return 0;
+        }
+        ip += length;
+        anchor = ip;
+
+        // Index the position just before the next search
+        if (ip - 2 <= mf_limit) {
+            table[lz4Hash(read32(src + ip - 2))] = static_cast<u32>(dict_size + ip - 2);
+        }
+    }
+
+    if (!lz4EmitSequence(op, op_end, src + anchor, size - anchor, 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(op - dst);
+}
+
+// LZ4 block decompression with an optional dictionary preceding the output
+bool lz4Decompress(const u8* src, size_t size, u8* dst, size_t original_size, const CompressionDictionary* dictionary) {
+    const u8* dict = dictionary ? dictionary->getContent().data() : nullptr;
+    const size_t dict_size = dictionary ? dictionary->getContent().size() : 0;
+    const u8* ip = src;
+    const u8* ip_end = src + size;
+    size_t op = 0;
+
+    while (ip < ip_end) {
+        u8 token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !readLength(ip, ip_end, literal_length)) {
+            return false;
+        }
+        if (static_cast<size_t>(ip_end - ip) < literal_length || original_size - op < literal_length) {
+            return false;
+        }
+        if (literal_length > 0) {
+            std::memcpy(dst + op, ip, literal_length);
+            ip += literal_length;
+            op += literal_length;
+        }
+
+        // The last sequence has no match
+        if (ip == ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !readLength(ip, ip_end, match_length)) {
+            return false;
+        }
+        match_length += LZ4_MIN_MATCH;
+
+        if (offset == 0 || offset > op + dict_size || original_size - op < match_length) {
+            return false;
+        }
+
+        // Part of the match that lies in the dictionary
+        if (offset > op) {
+            size_t back = offset - op;
+            size_t from_dict = std::min(back, match_length);
+            std::memcpy(dst + op, dict + dict_size - back, from_dict);
+            op += from_dict;
+            match_length -= from_dict;
+        }
+
+        // Overlapping copy from the output
+        const u8* match = dst + op - offset;
+        if (offset >= match_length) {
+            std::memcpy(dst + op, match, match_length);
+            op += match_length;
+        } else {
+            for (size_t i = 0; i < match_length; ++i) {
+                dst[op++] = match[i];
+            }
+        }
+    }
+
+    return op == original_size;
+}
+
+// FNV-1a hash used as the dictionary ID
+u32 dictionaryHash(const std::vector<u8>& content) {
+    u32 hash = 2166136261u;
+    for (u8 byte : content) {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+#ifdef NEXT_GEN_HAS_ZSTD
+// Per-thread zstd contexts (sessions compress on their sending threads)
+ZSTD_CCtx* zstdCompressContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    return context.get();
+}
+
+ZSTD_DCtx* zstdDecompressContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    return context.get();
+}
+#endif
+
+} // namespace
+
+// CompressionDictionary implementation
+std::shared_ptr<const CompressionDictionary> CompressionDictionary::create(std::vector<u8> content) {
+    if (content.size() > MAX_SIZE) {
+        content.erase(content.begin(), content.end() - MAX_SIZE);
+    }
+
+    std::shared_ptr<CompressionDictionary> dictionary(new CompressionDictionary());
+    dictionary->content_ = std::move(content);
+    dictionary->id_ = dictionaryHash(dictionary->content_);
+    dictionary->lz4_table_ = lz4BuildTable(dictionary->content_);
+
+#ifdef NEXT_GEN_HAS_ZSTD
+    const auto& data = dictionary->content_;
+    dictionary->zstd_cdict_.reset(ZSTD_createCDict(data.data(), data.size(), ZSTD_CLEVEL_DEFAULT),
+                                  [](void* cdict) { ZSTD_freeCDict(static_cast<ZSTD_CDict*>(cdict)); });
+    dictionary->zstd_ddict_.reset(ZSTD_createDDict(data.data(), data.size()),
+                                  [](void* ddict) { ZSTD_freeDDict(static_cast<ZSTD_DDict*>(ddict)); });
+#endif
+
+    return dictionary;
+}
+
+Result<std::shared_ptr<const CompressionDictionary>> CompressionDictionary::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return Result<std::shared_ptr<const CompressionDictionary>>(
+            ErrorCode::SYSTEM_ERROR, "Failed to open dictionary file: " + path);
+    }
+
+    std::vector<u8> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content.empty()) {
+        return Result<std::shared_ptr<const CompressionDictionary>>(
+            ErrorCode::INVALID_ARGUMENT, "Empty dictionary file: " + path);
+    }
+
+    return create(std::move(content));
+}
+
+Result<void> CompressionDictionary::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to create dictionary file: " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(content_.data()), static_cast<std::streamsize>(content_.size()));
+    if (!file) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to write dictionary file: " + path);
+    }
+    return Result<void>();
+}
+
+// Compression implementation
+bool Compression::isAvailable(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::NONE:
+        case CompressionAlgorithm::LZ4:
+            return true;
+        case CompressionAlgorithm::ZSTD:
+#ifdef NEXT_GEN_HAS_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+u8 Compression::availableMask() {
+    u8 mask = compressionMaskBit(CompressionAlgorithm::LZ4);
+    if (isAvailable(CompressionAlgorithm::ZSTD)) {
+        mask |= compressionMaskBit(CompressionAlgorithm::ZSTD);
+    }
+    return mask;
+}
+
+size_t Compression::compressBound(CompressionAlgorithm algorithm, size_t size) {
+    switch (algorithm) {
+        case CompressionAlgorithm::NONE:
+            return size;
+        case CompressionAlgorithm::LZ4:
+            return size + size / 255 + 16;
+        case CompressionAlgorithm::ZSTD:
+#ifdef NEXT_GEN_HAS_ZSTD
+            return ZSTD_compressBound(size);
+#else
+            return 0;
+#endif
+    }
+    return 0;
+}
+
+size_t Compression::compress(CompressionAlgorithm algorithm, const u8* src, size_t size,
+                             u8* dst, size_t capacity,
+                             const CompressionDictionary* dictionary, int level) {
+    switch (algorithm) {
+        case CompressionAlgorithm::NONE:
+            if (size > capacity) {
+                return 0;
+            }
+            std::memcpy(dst, src, size);
+            return size;
+
+        case CompressionAlgorithm::LZ4:
+            return lz4Compress(src, size, dst, capacity, dictionary, dictionary ? &dictionary->lz4_table_ : nullptr);
+
+        case CompressionAlgorithm::ZSTD: {
+#ifdef NEXT_GEN_HAS_ZSTD
+            size_t result;
+            if (dictionary && dictionary->zstd_cdict_) {
+                // The digested dictionary fixes the level
+                result = ZSTD_compress_usingCDict(zstdCompressContext(), dst, capacity, src, size,
+                                                  static_cast<const ZSTD_CDict*>(dictionary->zstd_cdict_.get()));
+            } else {
+                result = ZSTD_compressCCtx(zstdCompressContext(), dst, capacity, src, size,
+                                           level != 0 ? level : ZSTD_CLEVEL_DEFAULT);
+            }
+            return ZSTD_isError(result) ? 0 : result;
+#else
+            (void)level;
+            return 0;
+#endif
+        }
+    }
+    return 0;
+}
+
+bool Compression::decompress(CompressionAlgorithm algorithm, const u8* src, size_t size,
+                             u8* dst, size_t original_size,
+                             const CompressionDictionary* dictionary) {
+    switch (algorithm) {
+        case CompressionAlgorithm::NONE:
+            if (size != original_size) {
+                return false;
+            }
+            std::memcpy(dst, src, size);
+            return true;
+
+        case CompressionAlgorithm::LZ4:
+            return lz4Decompress(src, size, dst, original_size, dictionary);
+
+        case CompressionAlgorithm::ZSTD: {
+#ifdef NEXT_GEN_HAS_ZSTD
+            size_t result;
+            if (dictionary && dictionary->zstd_ddict_) {
+                result = ZSTD_decompress_usingDDict(zstdDecompressContext(), dst, original_size, src, size,
+                                                    static_cast<const ZSTD_DDict*>(dictionary->zstd_ddict_.get()));
+            } else {
+                result = ZSTD_decompressDCtx(zstdDecompressContext(), dst, original_size, src, size);
+            }
+            return !ZSTD_isError(result) && result == original_size;
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<const CompressionDictionary> Compression::trainDictionary(
+    const std::vector<std::vector<u8>>& samples, size_t max_size) {
+    // k-gram length and segment length used for scoring
+    constexpr size_t K = 6;
+    constexpr size_t SEGMENT = 64;
+
+    max_size = std::min(max_size, CompressionDictionary::MAX_SIZE);
+
+    // Number of samples each k-gram occurs in
+    std::unordered_map<u64, u32> kgram_ids;
+    std::vector<u32> sample_counts;
+    std::vector<std::vector<u32>> sample_kgrams(samples.size());
+    for (size_t s = 0; s < samples.size(); ++s) {
+        const auto& sample = samples[s];
+        if (sample.size() < K) {
+            continue;
+        }
+        auto& kgrams = sample_kgrams[s];
+        kgrams.reserve(sample.size() - K + 1);
+        std::vector<u32> seen;
+        for (size_t pos = 0; pos + K <= sample.size(); ++pos) {
+            u64 key = 0;
+            std::memcpy(&key, sample.data() + pos, K);
+            auto result = kgram_ids.emplace(key, static_cast<u32>(sample_counts.size()));
+            if (result.second) {
+                sample_counts.push_back(0);
+            }
+            kgrams.push_back(result.first->second);
+            seen.push_back(result.first->second);
+        }
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+        for (u32 id : seen) {
+            ++sample_counts[id];
+        }
+    }
+
+    // Greedily pick the segment with the highest score (sum of sample counts of
+    // k-grams not yet covered), then mark its k-grams as covered
+    std::vector<std::vector<u8>> segments;
+    size_t total_size = 0;
+    while (total_size < max_size) {
+        u64 best_score = 0;
+        size_t best_sample = 0;
+        size_t best_start = 0;
+        size_t best_length = 0;
+
+        for (size_t s = 0; s < samples.size(); ++s) {
+            const auto& kgrams = sample_kgrams[s];
+            if (kgrams.empty()) {
+                continue;
+            }
+            size_t window = std::min(kgrams.size(), SEGMENT - K + 1);
+            u64 score = 0;
+            for (size_t i = 0; i < window; ++i) {
+                u32 count = sample_counts[kgrams[i]];
+                score += count > 1 ? count : 0;
+            }
+            for (size_t start = 0;; ++start) {
+                if (score > best_score) {
+                    best_score = score;
+                    best_sample = s;
+                    best_start = start;
+                    best_length = window + K - 1;
+                }
+                if (start + window >= kgrams.size()) {
+                    break;
+                }
+                u32 removed = sample_counts[kgrams[start]];
+                u32 added = sample_counts[kgrams[start + window]];
+                score -= removed > 1 ? removed : 0;
+                score += added > 1 ? added : 0;
+            }
+        }
+
+        // Nothing left that occurs in more than one sample
+        if (best_score == 0) {
+            break;
+        }
+
+        const auto& sample = samples[best_sample];
+        best_length = std::min(best_length, max_size - total_size);
+        segments.emplace_back(sample.begin() + best_start, sample.begin() + best_start + best_length);
+        total_size += best_length;
+
+        const auto& kgrams = sample_kgrams[best_sample];
+        for (size_t i = best_start; i < kgrams.size() && i + K <= best_start + best_length; ++i) {
+            sample_counts[kgrams[i]] = 0;
+        }
+    }
+
+    if (segments.empty()) {
+        return nullptr;
+    }
+
+    // Best segments last: they end up closest to the data
+    std::vector<u8> content;
+    content.reserve(total_size);
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        content.insert(content.end(), it->begin(), it->end());
+    }
+    return CompressionDictionary::create(std::move(content));
+}
+
+} // namespace next_gen
@@ -1,7 +1,57 @@
 #include "../../include/utils/logger.h"
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+
+#ifdef NEXT_GEN_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
 
 namespace next_gen {
 
+namespace {
+
+// Live rate limiters, so pending suppressed counts can be flushed
+struct LimiterRegistry {
+    std::mutex mutex;
+    std::vector<LogRateLimiter*> limiters;
+};
+
+LimiterRegistry& limiterRegistry() {
+    static LimiterRegistry registry;
+    return registry;
+}
+
+// Thread-safe localtime
+void toLocalTime(std::time_t time, std::tm& tm_info) {
+#ifdef NEXT_GEN_PLATFORM_WINDOWS
+    localtime_s(&tm_info, &time);
+#else
+    localtime_r(&time, &tm_info);
+#endif
+}
+
+// Check for a rotated name: <prefix><YYYYmmdd-HHMMSS>.<seq>[.gz]
+bool isRotatedName(const std::string& name, const std::string& prefix) {
+    static const char pattern[] = "dddddddd-dddddd.dddd";
+    const size_t length = sizeof(pattern) - 1;
+    if (name.size() < prefix.size() + length || name.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        char c = name[prefix.size() + i];
+        if (pattern[i] == 'd' ? (c < '0' || c > '9') : c != pattern[i]) {
+            return false;
+        }
+    }
+    std::string suffix = name.substr(prefix.size() + length);
+    return suffix.empty() || suffix == ".gz";
+}
+
+} // namespace
+
 // ConsoleSink implementation
 void ConsoleSink::log(const LogRecord& record) {
     std::stringstream ss;
@@ -11,9 +61,9 @@ void ConsoleSink::log(const LogRecord& record) {
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         record.time.time_since_epoch() % std::chrono::seconds(1)).count();
     
-    // Use localtime_s instead of localtime for thread safety
+    // Use localtime_s/localtime_r instead of localtime for thread safety
     std::tm tm_info;
-    localtime_s(&tm_info, &time_t);
+    toLocalTime(time_t, tm_info);
     ss << std::put_time(&tm_info, "%Y-%m-%d %H:%M:%S") 
        << "." << std::setfill('0') << std::setw(3) << ms << " ";
     
@@ -45,19 +95,190 @@ void ConsoleSink::log(const LogRecord& record) {
 }
 
 // FileSink implementation
-FileSink::FileSink(const std::string& filename) : filename_(filename) {
+FileSink::FileSink(const std::string& filename, const FileSinkConfig& config)
+    : filename_(filename), config_(config), current_size_(0), rotation_seq_(0), stopping_(false) {
     file_.open(filename, std::ios::out | std::ios::app);
     if (!file_.is_open()) {
         throw std::runtime_error("Failed to open log file: " + filename);
     }
+    
+    std::error_code ec;
+    auto size = fs::file_size(filename, ec);
+    current_size_ = ec ? 0 : static_cast<u64>(size);
+    opened_at_ = std::chrono::steady_clock::now();
+    
+    if (config_.max_file_size > 0 || config_.rotate_interval_ms > 0) {
+        worker_thread_ = std::thread(&FileSink::backgroundWorker, this);
+    }
 }
 
 FileSink::~FileSink() {
+    if (worker_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(worker_mutex_);
+            stopping_ = true;
+        }
+        worker_cv_.notify_one();
+        worker_thread_.join();
+    }
+    
     if (file_.is_open()) {
         file_.close();
     }
 }
 
+bool FileSink::needsRotation(size_t next_write_size) const {
+    if (current_size_ == 0) {
+        return false;
+    }
+    
+    if (config_.max_file_size > 0 && current_size_ + next_write_size > config_.max_file_size) {
+        return true;
+    }
+    
+    if (config_.rotate_interval_ms > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - opened_at_).count();
+        if (static_cast<u64>(elapsed) >= config_.rotate_interval_ms) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void FileSink::rotate() {
+    file_.close();
+    
+    // Rotated name: <filename>.<YYYYmmdd-HHMMSS>.<seq>, sortable by name
+    auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm_info;
+    toLocalTime(time_t, tm_info);
+    std::stringstream ss;
+    ss << filename_ << "." << std::put_time(&tm_info, "%Y%m%d-%H%M%S")
+       << "." << std::setfill('0') << std::setw(4) << (rotation_seq_++ % 10000);
+    std::string rotated = ss.str();
+    
+    std::error_code ec;
+    fs::rename(filename_, rotated, ec);
+    opened_at_ = std::chrono::steady_clock::now();
+    
+    // Rename failed: keep appending to the live file
+    if (ec) {
+        file_.open(filename_, std::ios::out | std::ios::app);
+        return;
+    }
+    
+    file_.open(filename_, std::ios::out | std::ios::trunc);
+    current_size_ = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        rotated_files_.push_back(rotated);
+    }
+    worker_cv_.notify_one();
+}
+
+void FileSink::backgroundWorker() {
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (true) {
+        worker_cv_.wait(lock, [this]() { return stopping_ || !rotated_files_.empty(); });
+        
+        // Finish pending work before exiting
+        if (rotated_files_.empty() && stopping_) {
+            break;
+        }
+        
+        std::string path = rotated_files_.front();
+        rotated_files_.pop_front();
+        lock.unlock();
+        
+        if (config_.compress) {
+            compressFile(path);
+        }
+        applyRetention();
+        
+        lock.lock();
+    }
+}
+
+bool FileSink::compressFile(const std::string& path) {
+#ifdef NEXT_GEN_HAS_ZLIB
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    
+    std::string compressed = path + ".gz";
+    gzFile output = gzopen(compressed.c_str(), "wb6");
+    if (!output) {
+        return false;
+    }
+    
+    std::vector<char> buffer(64 * 1024);
+    bool ok = true;
+    while (input) {
+        input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = input.gcount();
+        if (count > 0 && gzwrite(output, buffer.data(), static_cast<unsigned>(count)) != count) {
+            ok = false;
+            break;
+        }
+    }
+    
+    if (gzclose(output) != Z_OK) {
+        ok = false;
+    }
+    input.close();
+    
+    std::error_code ec;
+    if (!ok) {
+        fs::remove(compressed, ec);
+        return false;
+    }
+    
+    fs::remove(path, ec);
+    return true;
+#else
+    // Built without zlib, rotated files are kept uncompressed
+    (void)path;
+    return false;
+#endif
+}
+
+void FileSink::applyRetention() {
+    if (config_.max_files == 0) {
+        return;
+    }
+    
+    fs::path base(filename_);
+    fs::path dir = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    std::string prefix = base.filename().string() + ".";
+    
+    std::vector<fs::path> rotated;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (isRotatedName(name, prefix)) {
+            rotated.push_back(entry.path());
+        }
+    }
+    
+    if (rotated.size() <= config_.max_files) {
+        return;
+    }
+    
+    // Oldest first, timestamp and sequence are zero-padded
+    std::sort(rotated.begin(), rotated.end(), [](const fs::path& a, const fs::path& b) {
+        return a.filename().string() < b.filename().string();
+    });
+    
+    size_t excess = rotated.size() - config_.max_files;
+    for (size_t i = 0; i < excess; ++i) {
+        fs::remove(rotated[i], ec);
+    }
+}
+
 void FileSink::log(const LogRecord& record) {
     if (!file_.is_open()) {
         return;
@@ -70,7 +291,7 @@ void FileSink::log(const LogRecord& record) {
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         record.time.time_since_epoch() % std::chrono::seconds(1)).count();
     std::tm tm_info;
-    localtime_s(&tm_info, &time_t);
+    toLocalTime(time_t, tm_info);
     ss << std::put_time(&tm_info, "%Y-%m-%d %H:%M:%S") 
        << "." << std::setfill('0') << std::setw(3) << ms << " ";
     
@@ -94,8 +315,20 @@ void FileSink::log(const LogRecord& record) {
     ss << record.message;
     
     // Output to file
-    file_ << ss.str() << std::endl;
+    ss << "\n";
+    std::string line = ss.str();
+    
+    // Rotation happens on the writer, callers are serialized by the logger lock
+    if (needsRotation(line.size())) {
+        rotate();
+        if (!file_.is_open()) {
+            return;
+        }
+    }
+    
+    file_ << line;
     file_.flush();
+    current_size_ += line.size();
 }
 
 // Logger implementation
@@ -110,10 +343,14 @@ void Logger::addSink(std::shared_ptr<LogSink> sink) {
 }
 
 void Logger::init(const std::string& filename, LogLevel level) {
+    init(filename, FileSinkConfig(), level);
+}
+
+void Logger::init(const std::string& filename, const FileSinkConfig& config, LogLevel level) {
     std::lock_guard<std::mutex> lock(mutex_);
     sinks_.clear();
-    addSink(std::make_shared<ConsoleSink>());
-    addSink(std::make_shared<FileSink>(filename));
+    sinks_.push_back(std::make_shared<ConsoleSink>());
+    sinks_.push_back(std::make_shared<FileSink>(filename, config));
     level_ = level;
 }
 
@@ -183,4 +420,86 @@ void Logger::fatal(const std::string& message,
     log(LogLevel::FATAL, message, file, line, function);
 }
 
+void Logger::flush() {
+    LogRateLimiter::flushAll();
+}
+
+// LogRateLimiter implementation
+LogRateLimiter::LogRateLimiter(LogLevel level, const char* file, int line, const char* function)
+    : level_(level), file_(file), line_(line), function_(function),
+      window_start_ms_(0), window_count_(0), counter_(0), suppressed_(0) {
+    // The registry is created here so that it outlives every static limiter
+    LimiterRegistry& registry = limiterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.limiters.push_back(this);
+}
+
+LogRateLimiter::~LogRateLimiter() {
+    LimiterRegistry& registry = limiterRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = std::find(registry.limiters.begin(), registry.limiters.end(), this);
+        if (it != registry.limiters.end()) {
+            registry.limiters.erase(it);
+        }
+    }
+    
+    // Static limiters are destroyed at exit, before the logger they were created after
+    reportSuppressed();
+}
+
+bool LogRateLimiter::allowPerSecond(u32 per_second, u64& suppressed) {
+    i64 now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    
+    // Start a new window, only the thread winning the exchange resets the count
+    i64 start = window_start_ms_.load(std::memory_order_relaxed);
+    if (now_ms - start >= 1000 &&
+        window_start_ms_.compare_exchange_strong(start, now_ms, std::memory_order_relaxed)) {
+        window_count_.store(0, std::memory_order_relaxed);
+    }
+    
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) < per_second) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool LogRateLimiter::allowEveryN(u32 n, u64& suppressed) {
+    if (n <= 1 || counter_.fetch_add(1, std::memory_order_relaxed) % n == 0) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+std::string LogRateLimiter::withSummary(const std::string& message, u64 suppressed) {
+    if (suppressed == 0) {
+        return message;
+    }
+    return message + " (suppressed " + std::to_string(suppressed) + " similar messages)";
+}
+
+void LogRateLimiter::flushAll() {
+    LimiterRegistry& registry = limiterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (LogRateLimiter* limiter : registry.limiters) {
+        limiter->reportSuppressed();
+    }
+}
+
+void LogRateLimiter::reportSuppressed() {
+    u64 suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    if (suppressed == 0) {
+        return;
+    }
+    Logger::instance().log(level_, std::to_string(suppressed) + " messages suppressed",
+                           file_, line_, function_);
+}
+
 } // namespace next_gen
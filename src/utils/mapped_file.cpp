@@ -0,0 +1,237 @@
+#include "../../include/utils/mapped_file.h"
+
+#ifdef NEXT_GEN_PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace next_gen {
+
+#ifdef NEXT_GEN_PLATFORM_WINDOWS
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), writable_(false),
+      file_handle_(INVALID_HANDLE_VALUE), mapping_handle_(nullptr) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+Result<void> MappedFile::create(const std::string& path, size_t size) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                              nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to create file: " + path);
+    }
+
+    LARGE_INTEGER file_size;
+    file_size.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                        file_size.HighPart, file_size.LowPart, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to create file mapping: " + path);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to map file: " + path);
+    }
+
+    path_ = path;
+    data_ = static_cast<u8*>(view);
+    size_ = size;
+    writable_ = true;
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    return Result<void>();
+}
+
+Result<void> MappedFile::openReadOnly(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to open file: " + path);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "File is empty: " + path);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to create file mapping: " + path);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to map file: " + path);
+    }
+
+    path_ = path;
+    data_ = static_cast<u8*>(view);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    writable_ = false;
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    return Result<void>();
+}
+
+void MappedFile::flush(bool async) {
+    if (!data_ || !writable_) {
+        return;
+    }
+
+    FlushViewOfFile(data_, size_);
+    if (!async) {
+        FlushFileBuffers(file_handle_);
+    }
+}
+
+void MappedFile::close(size_t final_size) {
+    if (!data_) {
+        return;
+    }
+
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+
+    // Truncate unused tail of the segment
+    if (writable_ && final_size < size_) {
+        LARGE_INTEGER pos;
+        pos.QuadPart = static_cast<LONGLONG>(final_size);
+        SetFilePointerEx(file_handle_, pos, nullptr, FILE_BEGIN);
+        SetEndOfFile(file_handle_);
+    }
+
+    CloseHandle(file_handle_);
+
+    data_ = nullptr;
+    size_ = 0;
+    file_handle_ = INVALID_HANDLE_VALUE;
+    mapping_handle_ = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), writable_(false), fd_(-1) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+Result<void> MappedFile::create(const std::string& path, size_t size) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR,
+                            "Failed to create file: " + path + ", " + std::strerror(errno));
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_ERROR,
+                            "Failed to resize file: " + path + ", " + std::strerror(errno));
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_ERROR,
+                            "Failed to map file: " + path + ", " + std::strerror(errno));
+    }
+
+    path_ = path;
+    data_ = static_cast<u8*>(addr);
+    size_ = size;
+    writable_ = true;
+    fd_ = fd;
+    return Result<void>();
+}
+
+Result<void> MappedFile::openReadOnly(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR,
+                            "Failed to open file: " + path + ", " + std::strerror(errno));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "File is empty: " + path);
+    }
+
+    void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_ERROR,
+                            "Failed to map file: " + path + ", " + std::strerror(errno));
+    }
+
+    path_ = path;
+    data_ = static_cast<u8*>(addr);
+    size_ = static_cast<size_t>(st.st_size);
+    writable_ = false;
+    fd_ = fd;
+    return Result<void>();
+}
+
+void MappedFile::flush(bool async) {
+    if (!data_ || !writable_) {
+        return;
+    }
+
+    ::msync(data_, size_, async ? MS_ASYNC : MS_SYNC);
+}
+
+void MappedFile::close(size_t final_size) {
+    if (!data_) {
+        return;
+    }
+
+    ::munmap(data_, size_);
+
+    // Truncate unused tail of the segment
+    if (writable_ && final_size < size_) {
+        if (::ftruncate(fd_, static_cast<off_t>(final_size)) != 0) {
+            // Keep the zero-filled tail, readers stop at the first empty record
+        }
+    }
+
+    ::close(fd_);
+
+    data_ = nullptr;
+    size_ = 0;
+    fd_ = -1;
+}
+
+#endif
+
+} // namespace next_gen
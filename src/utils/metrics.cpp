@@ -0,0 +1,298 @@
+#include "../../include/utils/metrics.h"
+#include "../../include/utils/logger.h"
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace next_gen {
+
+namespace {
+
+// Index of the highest set bit (value must be non-zero)
+inline u32 highestBit(u64 value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<u32>(index);
+#else
+    return 63u - static_cast<u32>(__builtin_clzll(value));
+#endif
+}
+
+std::string escapeLabelValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '"': result += "\\\""; break;
+            case '\n': result += "\\n"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+// Merge series labels with an extra label (used for quantiles)
+std::string withLabel(const std::string& labels, const std::string& extra) {
+    if (labels.empty()) {
+        return "{" + extra + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+} // namespace
+
+// Counter implementation
+u64 Counter::value() const {
+    u64 total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t Counter::shardIndex() {
+    static std::atomic<size_t> next_index(0);
+    thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return index;
+}
+
+// Histogram implementation
+Histogram::Histogram() : count_(0), sum_(0), max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+u32 Histogram::bucketIndex(u64 value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<u32>(value);
+    }
+
+    u32 exponent = highestBit(value);
+    u32 sub_bucket = static_cast<u32>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+u64 Histogram::bucketUpperBound(u32 index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    u32 exponent = index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+    u64 sub_bucket = index % SUB_BUCKET_COUNT;
+    u32 shift = exponent - SUB_BUCKET_BITS;
+    u64 lower = (SUB_BUCKET_COUNT + sub_bucket) << shift;
+    return lower + ((u64(1) << shift) - 1);
+}
+
+u64 Histogram::percentile(f64 quantile) const {
+    u64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    if (quantile < 0.0) {
+        quantile = 0.0;
+    } else if (quantile > 1.0) {
+        quantile = 1.0;
+    }
+
+    u64 target = static_cast<u64>(quantile * static_cast<f64>(total));
+    if (target == 0) {
+        target = 1;
+    }
+
+    u64 cumulative = 0;
+    for (u32 i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        if (cumulative >= target) {
+            u64 upper = bucketUpperBound(i);
+            u64 largest = max();
+            return upper < largest ? upper : largest;
+        }
+    }
+
+    return max();
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+// MetricsRegistry implementation
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Family* MetricsRegistry::getFamily(const std::string& name, const std::string& help,
+                                                    MetricType type) {
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        Family family;
+        family.help = help;
+        family.type = type;
+        it = families_.emplace(name, std::move(family)).first;
+    }
+
+    if (it->second.type != type) {
+        NEXT_GEN_LOG_ERROR("Metric registered with different type: " + name);
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Family* family = getFamily(name, help, MetricType::COUNTER);
+    if (!family) {
+        detached_counters_.push_back(std::make_unique<Counter>());
+        return *detached_counters_.back();
+    }
+
+    auto& series = family->counters[formatLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Counter>();
+    }
+    return *series;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Family* family = getFamily(name, help, MetricType::GAUGE);
+    if (!family) {
+        detached_gauges_.push_back(std::make_unique<Gauge>());
+        return *detached_gauges_.back();
+    }
+
+    auto& series = family->gauges[formatLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Gauge>();
+    }
+    return *series;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Family* family = getFamily(name, help, MetricType::HISTOGRAM);
+    if (!family) {
+        detached_histograms_.push_back(std::make_unique<Histogram>());
+        return *detached_histograms_.back();
+    }
+
+    auto& series = family->histograms[formatLabels(labels)];
+    if (!series) {
+        series = std::make_unique<Histogram>();
+    }
+    return *series;
+}
+
+std::string MetricsRegistry::formatLabels(const MetricLabels& labels) {
+    if (labels.empty()) {
+        return "";
+    }
+
+    std::string result = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (i > 0) {
+            result += ",";
+        }
+        result += labels[i].first + "=\"" + escapeLabelValue(labels[i].second) + "\"";
+    }
+    result += "}";
+    return result;
+}
+
+std::string MetricsRegistry::exportPrometheus() const {
+    static const f64 quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    static const f64 NANOS_PER_SECOND = 1e9;
+
+    std::ostringstream ss;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& pair : families_) {
+        const std::string& name = pair.first;
+        const Family& family = pair.second;
+
+        ss << "# HELP " << name << " " << family.help << "\n";
+        switch (family.type) {
+            case MetricType::COUNTER:
+                ss << "# TYPE " << name << " counter\n";
+                for (const auto& series : family.counters) {
+                    ss << name << series.first << " " << series.second->value() << "\n";
+                }
+                break;
+
+            case MetricType::GAUGE:
+                ss << "# TYPE " << name << " gauge\n";
+                for (const auto& series : family.gauges) {
+                    ss << name << series.first << " " << series.second->value() << "\n";
+                }
+                break;
+
+            case MetricType::HISTOGRAM:
+                // Exported as summary: HDR buckets are too fine-grained for Prometheus buckets
+                ss << "# TYPE " << name << " summary\n";
+                for (const auto& series : family.histograms) {
+                    const Histogram& histogram = *series.second;
+                    for (f64 quantile : quantiles) {
+                        std::ostringstream label;
+                        label << "quantile=\"" << quantile << "\"";
+                        ss << name << withLabel(series.first, label.str()) << " "
+                           << static_cast<f64>(histogram.percentile(quantile)) / NANOS_PER_SECOND << "\n";
+                    }
+                    ss << name << "_sum" << series.first << " "
+                       << static_cast<f64>(histogram.sum()) / NANOS_PER_SECOND << "\n";
+                    ss << name << "_count" << series.first << " " << histogram.count() << "\n";
+                }
+                break;
+        }
+    }
+
+    return ss.str();
+}
+
+Result<void> MetricsRegistry::exportToFile(const std::string& path) const {
+    std::string content = exportPrometheus();
+    std::string temp_path = path + ".tmp";
+
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open()) {
+            return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to open metrics file: " + temp_path);
+        }
+        file << content;
+        if (!file) {
+            return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to write metrics file: " + temp_path);
+        }
+    }
+
+    // Replace atomically so scrapers never read a partial file
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to rename metrics file: " + path);
+    }
+
+    return Result<void>();
+}
+
+} // namespace next_gen
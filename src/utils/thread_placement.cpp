@@ -0,0 +1,370 @@
+#include "../../include/utils/thread_placement.h"
+#include "../../include/utils/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <new>
+
+#ifdef NEXT_GEN_PLATFORM_LINUX
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
+
+namespace next_gen {
+
+namespace {
+
+#ifdef NEXT_GEN_PLATFORM_LINUX
+// mbind() constants (numaif.h, not required at build time)
+constexpr int MEMORY_POLICY_PREFERRED = 1;
+constexpr unsigned MEMORY_POLICY_MOVE = 1u << 1;
+#endif
+
+// CPUs the process may run on (cpuset, taskset), empty if unknown
+std::vector<u32> allowedCpus() {
+    std::vector<u32> cpus;
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (u32 cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+// Keep the allowed CPUs of each node and drop nodes left without CPUs
+void restrictToAllowed(CpuTopology& topology, const std::vector<u32>& allowed) {
+    if (allowed.empty()) {
+        return;
+    }
+    for (auto& node : topology.nodes) {
+        node.cpus.erase(std::remove_if(node.cpus.begin(), node.cpus.end(), [&allowed](u32 cpu) {
+            return !std::binary_search(allowed.begin(), allowed.end(), cpu);
+        }), node.cpus.end());
+    }
+    topology.nodes.erase(std::remove_if(topology.nodes.begin(), topology.nodes.end(), [](const NumaNode& node) {
+        return node.cpus.empty();
+    }), topology.nodes.end());
+}
+
+std::string formatCpuList(const std::vector<u32>& cpus) {
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (i != 0) {
+            out << ',';
+        }
+        out << cpus[i];
+        if (j != i) {
+            out << '-' << cpus[j];
+        }
+        i = j + 1;
+    }
+    return out.str();
+}
+
+const char* pinningName(ThreadPinning pinning) {
+    switch (pinning) {
+        case ThreadPinning::NODE: return "node";
+        case ThreadPinning::CORE: return "core";
+        default: return "none";
+    }
+}
+
+} // namespace
+
+ThreadPlacement& ThreadPlacement::instance() {
+    static ThreadPlacement instance;
+    return instance;
+}
+
+Result<void> ThreadPlacement::configure(const ThreadPlacementConfig& config) {
+    CpuTopology topology;
+    if (config.topology.empty()) {
+        topology = detectTopology();
+    } else {
+        auto parsed = parseTopology(config.topology);
+        if (parsed.has_error()) {
+            return Result<void>(parsed.error().code(), parsed.error().message());
+        }
+        topology = parsed.value();
+    }
+    restrictToAllowed(topology, allowedCpus());
+    if (topology.nodes.empty()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "No usable CPU in thread placement topology");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    topology_ = std::move(topology);
+    next_service_node_ = 0;
+    service_nodes_.clear();
+    next_core_.assign(topology_.nodes.size(), 0);
+    placements_.clear();
+    enabled_.store(config.pinning != ThreadPinning::NONE, std::memory_order_release);
+
+    std::string nodes;
+    for (size_t i = 0; i < topology_.nodes.size(); ++i) {
+        nodes += (i != 0 ? "; " : "") + std::to_string(i) + ": " + formatCpuList(topology_.nodes[i].cpus);
+    }
+    NEXT_GEN_LOG_INFO("Thread placement: " + std::to_string(topology_.nodes.size()) +
+                      (topology_.simulated ? " simulated" : "") + " node(s) (" + nodes +
+                      "), pinning " + pinningName(config.pinning));
+    return Result<void>();
+}
+
+bool ThreadPlacement::bindsQueueMemory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.bind_queue_memory && !topology_.simulated;
+}
+
+CpuTopology ThreadPlacement::getTopology() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return topology_;
+}
+
+u32 ThreadPlacement::assignServiceNode(const std::string& service_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = service_nodes_.find(service_name);
+    if (it != service_nodes_.end()) {
+        return it->second;
+    }
+
+    u32 node_count = static_cast<u32>(std::max<size_t>(topology_.nodes.size(), 1));
+    u32 node;
+    auto configured = config_.service_nodes.find(service_name);
+    if (configured != config_.service_nodes.end()) {
+        node = configured->second % node_count;
+    } else {
+        node = next_service_node_++ % node_count;
+    }
+    service_nodes_[service_name] = node;
+    return node;
+}
+
+u32 ThreadPlacement::getTimerNode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return topology_.nodes.empty() ? 0 : config_.timer_node % static_cast<u32>(topology_.nodes.size());
+}
+
+Result<void> ThreadPlacement::pinCurrentThread(u32 node, const std::string& thread_name) {
+    if (!enabled()) {
+        return Result<void>();
+    }
+
+    ThreadPlacementRecord record;
+    record.thread = thread_name;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record.node = node % static_cast<u32>(topology_.nodes.size());
+        const auto& cpus = topology_.nodes[record.node].cpus;
+        if (config_.pinning == ThreadPinning::CORE) {
+            record.cpus.push_back(cpus[next_core_[record.node]++ % cpus.size()]);
+        } else {
+            record.cpus = cpus;
+        }
+    }
+
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (u32 cpu : record.cpus) {
+        CPU_SET(cpu, &set);
+    }
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0) {
+        NEXT_GEN_LOG_WARNING("Failed to pin thread " + thread_name + ": " + std::to_string(error));
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "pthread_setaffinity_np failed: " + std::to_string(error));
+    }
+#else
+    return Result<void>(ErrorCode::NOT_IMPLEMENTED, "Thread pinning is only supported on Linux");
+#endif
+
+    NEXT_GEN_LOG_DEBUG("Pinned thread " + thread_name + " to node " + std::to_string(record.node) +
+                       ", CPUs " + formatCpuList(record.cpus));
+    std::lock_guard<std::mutex> lock(mutex_);
+    placements_.push_back(std::move(record));
+    return Result<void>();
+}
+
+Result<void> ThreadPlacement::bindMemory(void* address, size_t size, u32 node) const {
+    if (!address || size == 0) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Empty memory range");
+    }
+
+    u32 os_node;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (topology_.simulated || topology_.nodes.empty()) {
+            return Result<void>();
+        }
+        os_node = topology_.nodes[node % topology_.nodes.size()].id;
+    }
+
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    // Policies apply to whole pages; pages shared with other allocations stay
+    uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page - 1) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(address) + size) & ~(page - 1);
+    if (begin >= end) {
+        return Result<void>();
+    }
+
+    constexpr size_t MASK_BITS = 8 * sizeof(unsigned long);
+    unsigned long mask[1024 / MASK_BITS] = {};
+    if (os_node >= 1024) {
+        return Result<void>(ErrorCode::OUT_OF_RANGE, "NUMA node out of range");
+    }
+    mask[os_node / MASK_BITS] = 1ul << (os_node % MASK_BITS);
+
+    if (syscall(SYS_mbind, begin, end - begin, MEMORY_POLICY_PREFERRED, mask, 1024 + 1, MEMORY_POLICY_MOVE) != 0) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "mbind failed for node " + std::to_string(os_node));
+    }
+    return Result<void>();
+#else
+    return Result<void>(ErrorCode::NOT_IMPLEMENTED, "Memory binding is only supported on Linux");
+#endif
+}
+
+void* ThreadPlacement::allocatePages(size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return address;
+#else
+    // No memory binding, any allocation will do
+    return ::operator new(size);
+#endif
+}
+
+void ThreadPlacement::freePages(void* address, size_t size) {
+    if (!address) {
+        return;
+    }
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    munmap(address, size);
+#else
+    (void)size;
+    ::operator delete(address);
+#endif
+}
+
+std::vector<ThreadPlacementRecord> ThreadPlacement::getPlacements() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return placements_;
+}
+
+CpuTopology ThreadPlacement::detectTopology() {
+    CpuTopology topology;
+#ifdef NEXT_GEN_PLATFORM_LINUX
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            auto cpus = parseCpuList(list);
+            if (cpus.has_error()) {
+                continue;
+            }
+            NumaNode node;
+            node.id = static_cast<u32>(std::stoul(name.substr(4)));
+            node.cpus = cpus.value();
+            topology.nodes.push_back(std::move(node));
+        }
+        closedir(dir);
+    }
+    std::sort(topology.nodes.begin(), topology.nodes.end(), [](const NumaNode& a, const NumaNode& b) {
+        return a.id < b.id;
+    });
+#endif
+
+    // No NUMA information: one node with the allowed CPUs
+    if (topology.nodes.empty()) {
+        NumaNode node;
+        node.id = 0;
+        node.cpus = allowedCpus();
+        if (!node.cpus.empty()) {
+            topology.nodes.push_back(std::move(node));
+        }
+    }
+    return topology;
+}
+
+Result<CpuTopology> ThreadPlacement::parseTopology(const std::string& description) {
+    CpuTopology topology;
+    topology.simulated = true;
+
+    std::istringstream in(description);
+    std::string list;
+    while (std::getline(in, list, ';')) {
+        auto cpus = parseCpuList(list);
+        if (cpus.has_error()) {
+            return Result<CpuTopology>(cpus.error().code(), cpus.error().message());
+        }
+        NumaNode node;
+        node.id = static_cast<u32>(topology.nodes.size());
+        node.cpus = cpus.value();
+        topology.nodes.push_back(std::move(node));
+    }
+    if (topology.nodes.empty()) {
+        return Result<CpuTopology>(ErrorCode::INVALID_ARGUMENT, "Empty topology");
+    }
+    return Result<CpuTopology>(std::move(topology));
+}
+
+Result<std::vector<u32>> ThreadPlacement::parseCpuList(const std::string& list) {
+    std::vector<u32> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        std::string first_text = range.substr(0, dash);
+        std::string last_text = dash == std::string::npos ? first_text : range.substr(dash + 1);
+        if (first_text.empty() || last_text.empty() ||
+            first_text.find_first_not_of("0123456789") != std::string::npos ||
+            last_text.find_first_not_of("0123456789") != std::string::npos) {
+            return Result<std::vector<u32>>(ErrorCode::INVALID_ARGUMENT, "Invalid CPU list: " + list);
+        }
+        u32 first = static_cast<u32>(std::stoul(first_text));
+        u32 last = static_cast<u32>(std::stoul(last_text));
+        if (first > last || last >= 4096) {
+            return Result<std::vector<u32>>(ErrorCode::INVALID_ARGUMENT, "Invalid CPU range: " + range);
+        }
+        for (u32 cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return Result<std::vector<u32>>(std::move(cpus));
+}
+
+} // namespace next_gen
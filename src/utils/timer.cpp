@@ -1,5 +1,6 @@
 #include "../../include/utils/timer.h"
 #include "../../include/utils/logger.h"
+#include "../../include/utils/thread_placement.h"
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
@@ -13,11 +14,12 @@ TimerManager& TimerManager::instance() {
 }
 
 void TimerManager::start() {
-    if (running_) {
+    // Services start it concurrently
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
         return;
     }
     
-    running_ = true;
     worker_thread_ = std::thread(&TimerManager::run, this);
     NEXT_GEN_LOG_INFO("Timer manager started");
 }
@@ -162,6 +164,9 @@ u64 TimerManager::getCurrentTimeMillis() const {
 void TimerManager::run() {
     NEXT_GEN_LOG_INFO("Timer worker thread started");
     
+    auto& placement = ThreadPlacement::instance();
+    placement.pinCurrentThread(placement.getTimerNode(), "timer");
+    
     while (running_) {
         std::unique_lock<std::mutex> lock(mutex_);
         
@@ -0,0 +1,58 @@
+#include "../../include/utils/timer_wheel.h"
+#include <algorithm>
+
+namespace next_gen {
+
+TimerWheel::TimerWheel(u32 resolution_ms, u32 slot_count)
+    : resolution_ms_(resolution_ms ? resolution_ms : 1),
+      slots_(slot_count ? slot_count : 1),
+      current_tick_(0),
+      next_due_ms_(NEVER),
+      size_(0) {
+}
+
+void TimerWheel::schedule(u32 id, u64 due_ms) {
+    // Entries already due go into the current slot
+    u64 tick = std::max(due_ms / resolution_ms_, current_tick_);
+    slots_[tick % slots_.size()].push_back(Entry{due_ms, id});
+    ++size_;
+    next_due_ms_ = std::min(next_due_ms_, due_ms);
+}
+
+void TimerWheel::clear() {
+    for (auto& slot : slots_) {
+        slot.clear();
+    }
+    size_ = 0;
+    next_due_ms_ = NEVER;
+}
+
+void TimerWheel::updateNextDue() {
+    next_due_ms_ = NEVER;
+    if (size_ == 0) {
+        return;
+    }
+
+    // Scan forward from the current slot, the first entry due within one
+    // revolution is the earliest; otherwise fall back to the global minimum
+    u64 revolution_end_ms = (current_tick_ + slots_.size()) * resolution_ms_;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        const auto& slot = slots_[(current_tick_ + i) % slots_.size()];
+        for (const auto& entry : slot) {
+            if (entry.due_ms < revolution_end_ms) {
+                next_due_ms_ = std::min(next_due_ms_, entry.due_ms);
+            }
+        }
+        if (next_due_ms_ != NEVER) {
+            return;
+        }
+    }
+
+    for (const auto& slot : slots_) {
+        for (const auto& entry : slot) {
+            next_due_ms_ = std::min(next_due_ms_, entry.due_ms);
+        }
+    }
+}
+
+} // namespace next_gen
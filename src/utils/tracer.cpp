@@ -0,0 +1,173 @@
+#include "../../include/utils/tracer.h"
+#include <chrono>
+#include <limits>
+#include <cstdio>
+#include <functional>
+
+namespace next_gen {
+
+namespace {
+
+thread_local u64 current_trace_id = 0;
+
+// Per-thread random generator (splitmix64)
+u64 nextRandom() {
+    thread_local u64 state = metricsNowNanos() ^
+        (static_cast<u64>(std::hash<std::thread::id>()(std::this_thread::get_id())) << 1);
+    u64 z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+u32 currentThreadIndex() {
+    static std::atomic<u32> next_index(1);
+    thread_local u32 index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    static Tracer instance;
+    return instance;
+}
+
+Result<void> Tracer::open(const TracerConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (writer_thread_.joinable()) {
+        return Result<void>(ErrorCode::INVALID_ARGUMENT, "Tracer already open");
+    }
+
+    file_.open(config.path, std::ios::out | std::ios::app);
+    if (!file_.is_open()) {
+        return Result<void>(ErrorCode::SYSTEM_ERROR, "Failed to open trace file: " + config.path);
+    }
+
+    config_ = config;
+    if (config_.sample_rate >= 1.0) {
+        sample_threshold_ = std::numeric_limits<u64>::max();
+    } else if (config_.sample_rate <= 0.0) {
+        sample_threshold_ = 0;
+    } else {
+        sample_threshold_ = static_cast<u64>(config_.sample_rate * 18446744073709551615.0);
+    }
+
+    // Offset to convert monotonic span times to wall clock
+    i64 wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    wall_offset_ns_ = wall_ns - static_cast<i64>(metricsNowNanos());
+
+    pending_.reserve(1024);
+    stopping_ = false;
+    writer_thread_ = std::thread(&Tracer::writerLoop, this);
+    enabled_.store(true, std::memory_order_relaxed);
+    return Result<void>();
+}
+
+void Tracer::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!writer_thread_.joinable()) {
+            return;
+        }
+        enabled_.store(false, std::memory_order_relaxed);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    writer_thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+}
+
+u64 Tracer::startTrace() {
+    if (!isEnabled() || sample_threshold_ == 0) {
+        return 0;
+    }
+
+    if (sample_threshold_ != std::numeric_limits<u64>::max() && nextRandom() >= sample_threshold_) {
+        return 0;
+    }
+
+    u64 trace_id = nextRandom();
+    return trace_id != 0 ? trace_id : 1;
+}
+
+void Tracer::recordSpan(u64 trace_id, const char* name, u64 start_ns, u64 end_ns,
+                        u8 category, u16 message_id, u32 session_id) {
+    if (trace_id == 0 || !isEnabled()) {
+        return;
+    }
+
+    TraceSpan span;
+    span.trace_id = trace_id;
+    span.name = name;
+    span.start_ns = start_ns;
+    span.duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    span.thread_id = currentThreadIndex();
+    span.session_id = session_id;
+    span.message_id = message_id;
+    span.category = category;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.size() >= config_.max_pending_spans) {
+        dropped_spans_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending_.push_back(span);
+}
+
+u64 Tracer::currentTraceId() {
+    return current_trace_id;
+}
+
+void Tracer::setCurrentTraceId(u64 trace_id) {
+    current_trace_id = trace_id;
+}
+
+void Tracer::writerLoop() {
+    std::vector<TraceSpan> spans;
+    spans.reserve(1024);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait_for(lock, std::chrono::milliseconds(config_.flush_interval_ms),
+                     [this]() { return stopping_; });
+
+        spans.swap(pending_);
+        bool stopping = stopping_;
+        lock.unlock();
+
+        if (!spans.empty()) {
+            writeSpans(spans);
+            spans.clear();
+        }
+
+        lock.lock();
+        if (stopping && pending_.empty()) {
+            break;
+        }
+    }
+}
+
+void Tracer::writeSpans(const std::vector<TraceSpan>& spans) {
+    char trace_hex[17];
+    for (const auto& span : spans) {
+        std::snprintf(trace_hex, sizeof(trace_hex), "%016llx", static_cast<unsigned long long>(span.trace_id));
+        i64 wall_ns = static_cast<i64>(span.start_ns) + wall_offset_ns_;
+
+        file_ << "{\"trace_id\":\"" << trace_hex << "\""
+              << ",\"name\":\"" << span.name << "\""
+              << ",\"ts_us\":" << wall_ns / 1000
+              << ",\"dur_ns\":" << span.duration_ns
+              << ",\"thread\":" << span.thread_id
+              << ",\"session\":" << span.session_id
+              << ",\"category\":" << static_cast<u32>(span.category)
+              << ",\"id\":" << span.message_id << "}\n";
+    }
+    file_.flush();
+}
+
+} // namespace next_gen
@@ -0,0 +1,138 @@
+#include "../include/utils/compression.h"
+#include "../include/utils/mapped_file.h"
+#include "../include/network/tcp_session.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+
+using namespace next_gen;
+
+// Frame header size (category + id + body size)
+static constexpr size_t HEADER_SIZE = sizeof(MessageCategoryType) + sizeof(MessageIdType) + sizeof(u32);
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] -o <output.dict> <frames>..." << std::endl;
+    std::cout << "Trains a compression dictionary from files of TCP frames (header + body)." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -o, --output FILE   Dictionary output file" << std::endl;
+    std::cout << "  -s, --size BYTES    Maximum dictionary size (default 16384, max 65536)" << std::endl;
+    std::cout << "  -h, --help          Display this help message" << std::endl;
+}
+
+// Append frame bodies of a file to samples (compressed and control frames are skipped)
+bool loadFrames(const std::string& path, std::vector<std::vector<u8>>& samples) {
+    MappedFile file;
+    auto result = file.openReadOnly(path);
+    if (result.has_error()) {
+        std::cerr << "Error: " << result.error().what() << std::endl;
+        return false;
+    }
+
+    const u8* data = file.data();
+    size_t pos = 0;
+    while (pos + HEADER_SIZE <= file.size()) {
+        MessageCategoryType category;
+        std::memcpy(&category, data + pos, sizeof(category));
+        u32 size_field;
+        std::memcpy(&size_field, data + pos + sizeof(MessageCategoryType) + sizeof(MessageIdType), sizeof(size_field));
+        u32 body_size = size_field & FRAME_BODY_SIZE_MASK;
+        if (pos + HEADER_SIZE + body_size > file.size()) {
+            std::cerr << "Warning: " << path << " truncated at offset " << pos << std::endl;
+            break;
+        }
+
+        if ((size_field >> FRAME_COMPRESSION_SHIFT) == 0 && category != FRAME_CONTROL_CATEGORY && body_size > 0) {
+            samples.emplace_back(data + pos + HEADER_SIZE, data + pos + HEADER_SIZE + body_size);
+        }
+        pos += HEADER_SIZE + body_size;
+    }
+    return true;
+}
+
+// Total LZ4 size of the samples with an optional dictionary
+size_t compressedSize(const std::vector<std::vector<u8>>& samples, const CompressionDictionary* dictionary) {
+    size_t total = 0;
+    std::vector<u8> buffer;
+    for (const auto& sample : samples) {
+        buffer.resize(Compression::compressBound(CompressionAlgorithm::LZ4, sample.size()));
+        total += Compression::compress(CompressionAlgorithm::LZ4, sample.data(), sample.size(),
+                                       buffer.data(), buffer.size(), dictionary);
+    }
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    std::string output;
+    size_t max_size = 16 * 1024;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing output file" << std::endl;
+                return 1;
+            }
+            output = argv[++i];
+        } else if (arg == "-s" || arg == "--size") {
+            if (i + 1 >= argc || (max_size = std::strtoul(argv[++i], nullptr, 10)) == 0) {
+                std::cerr << "Error: Missing or invalid size" << std::endl;
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (output.empty() || files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<u8>> samples;
+    for (const auto& file : files) {
+        if (!loadFrames(file, samples)) {
+            return 1;
+        }
+    }
+
+    auto dictionary = Compression::trainDictionary(samples, max_size);
+    if (!dictionary) {
+        std::cerr << "Error: No repeated content in " << samples.size() << " samples" << std::endl;
+        return 1;
+    }
+
+    auto result = dictionary->saveToFile(output);
+    if (result.has_error()) {
+        std::cerr << "Error: " << result.error().what() << std::endl;
+        return 1;
+    }
+
+    size_t raw = 0;
+    for (const auto& sample : samples) {
+        raw += sample.size();
+    }
+    size_t plain = compressedSize(samples, nullptr);
+    size_t with_dictionary = compressedSize(samples, dictionary.get());
+
+    std::cout << "Samples:    " << samples.size() << " (" << raw << " bytes)" << std::endl;
+    std::cout << "Dictionary: " << dictionary->getContent().size() << " bytes, id "
+              << std::hex << std::setw(8) << std::setfill('0') << dictionary->getId() << std::dec << std::endl;
+    if (raw > 0) {
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "LZ4 ratio:  " << static_cast<double>(plain) / raw << " without, "
+                  << static_cast<double>(with_dictionary) / raw << " with dictionary" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,333 @@
+#include "../include/utils/binary_log.h"
+#include "../include/utils/mapped_file.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+
+using namespace next_gen;
+
+// Decoded call site
+struct DecodedSite {
+    LogLevel level;
+    u32 line;
+    std::string file;
+    std::string function;
+    std::string format;
+};
+
+// Decoded argument
+struct DecodedArg {
+    BinaryLogArgType type;
+    bool b;
+    i64 i;
+    u64 u;
+    f64 f;
+    std::string s;
+};
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] <segment.nglog>..." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -j, --json          Output one JSON object per record" << std::endl;
+    std::cout << "  -l, --level LEVEL   Minimum level (TRACE, DEBUG, INFO, WARNING, ERROR, FATAL)" << std::endl;
+    std::cout << "  -h, --help          Display this help message" << std::endl;
+}
+
+bool parseLevel(const std::string& name, LogLevel& level) {
+    for (int i = static_cast<int>(LogLevel::TRACE); i <= static_cast<int>(LogLevel::FATAL); ++i) {
+        if (name == logLevelToString(static_cast<LogLevel>(i))) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string argToString(const DecodedArg& arg) {
+    switch (arg.type) {
+        case BinaryLogArgType::BOOL: return arg.b ? "true" : "false";
+        case BinaryLogArgType::I64: return std::to_string(arg.i);
+        case BinaryLogArgType::U64: return std::to_string(arg.u);
+        case BinaryLogArgType::F64: {
+            std::ostringstream ss;
+            ss << arg.f;
+            return ss.str();
+        }
+        case BinaryLogArgType::STRING: return arg.s;
+        default: return "?";
+    }
+}
+
+std::string jsonEscape(const std::string& value) {
+    std::ostringstream ss;
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                       << std::dec << std::setfill(' ');
+                } else {
+                    ss << c;
+                }
+        }
+    }
+    return ss.str();
+}
+
+// Replace "{}" placeholders in order, surplus arguments are appended
+std::string renderMessage(const std::string& format, const std::vector<DecodedArg>& args) {
+    std::string result;
+    size_t arg_index = 0;
+    size_t pos = 0;
+    while (pos < format.size()) {
+        size_t next = format.find("{}", pos);
+        if (next == std::string::npos) {
+            result.append(format, pos, std::string::npos);
+            break;
+        }
+        result.append(format, pos, next - pos);
+        if (arg_index < args.size()) {
+            result += argToString(args[arg_index++]);
+        } else {
+            result += "{}";
+        }
+        pos = next + 2;
+    }
+    for (; arg_index < args.size(); ++arg_index) {
+        result += " " + argToString(args[arg_index]);
+    }
+    return result;
+}
+
+std::string formatTime(u64 timestamp_ns) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000ULL);
+    u64 micros = (timestamp_ns / 1000ULL) % 1000000ULL;
+
+    std::tm tm_info;
+#ifdef NEXT_GEN_PLATFORM_WINDOWS
+    localtime_s(&tm_info, &seconds);
+#else
+    localtime_r(&seconds, &tm_info);
+#endif
+
+    std::ostringstream ss;
+    ss << std::put_time(&tm_info, "%Y-%m-%d %H:%M:%S") << "."
+       << std::setfill('0') << std::setw(6) << micros;
+    return ss.str();
+}
+
+bool decodeArgs(const u8* p, const u8* end, u16 count, std::vector<DecodedArg>& args) {
+    args.clear();
+    for (u16 i = 0; i < count; ++i) {
+        if (p >= end) {
+            return false;
+        }
+
+        DecodedArg arg{};
+        arg.type = static_cast<BinaryLogArgType>(*p++);
+        switch (arg.type) {
+            case BinaryLogArgType::BOOL:
+                if (p + 1 > end) return false;
+                arg.b = *p++ != 0;
+                break;
+            case BinaryLogArgType::I64:
+                if (p + sizeof(i64) > end) return false;
+                std::memcpy(&arg.i, p, sizeof(i64));
+                p += sizeof(i64);
+                break;
+            case BinaryLogArgType::U64:
+                if (p + sizeof(u64) > end) return false;
+                std::memcpy(&arg.u, p, sizeof(u64));
+                p += sizeof(u64);
+                break;
+            case BinaryLogArgType::F64:
+                if (p + sizeof(f64) > end) return false;
+                std::memcpy(&arg.f, p, sizeof(f64));
+                p += sizeof(f64);
+                break;
+            case BinaryLogArgType::STRING: {
+                u32 length;
+                if (p + sizeof(length) > end) return false;
+                std::memcpy(&length, p, sizeof(length));
+                p += sizeof(length);
+                if (p + length > end) return false;
+                arg.s.assign(reinterpret_cast<const char*>(p), length);
+                p += length;
+                break;
+            }
+            default:
+                return false;
+        }
+        args.push_back(std::move(arg));
+    }
+    return true;
+}
+
+bool decodeSegment(const std::string& path, bool json, LogLevel min_level) {
+    MappedFile file;
+    auto result = file.openReadOnly(path);
+    if (result.has_error()) {
+        std::cerr << "Error: " << result.error().what() << std::endl;
+        return false;
+    }
+
+    const u8* data = file.data();
+    size_t size = file.size();
+
+    BinaryLogFileHeader file_header;
+    if (size < sizeof(file_header)) {
+        std::cerr << "Error: " << path << " is too small" << std::endl;
+        return false;
+    }
+    std::memcpy(&file_header, data, sizeof(file_header));
+    if (std::memcmp(file_header.magic, BINARY_LOG_MAGIC, sizeof(file_header.magic)) != 0) {
+        std::cerr << "Error: " << path << " is not a binary log segment" << std::endl;
+        return false;
+    }
+    if (file_header.version != BINARY_LOG_VERSION) {
+        std::cerr << "Error: " << path << " has unsupported version " << file_header.version << std::endl;
+        return false;
+    }
+
+    std::unordered_map<u32, DecodedSite> sites;
+    std::vector<DecodedArg> args;
+    size_t pos = sizeof(file_header);
+
+    while (pos + sizeof(BinaryLogRecordHeader) <= size) {
+        BinaryLogRecordHeader header;
+        std::memcpy(&header, data + pos, sizeof(header));
+
+        // Empty record marks the end of written data
+        if (header.size == 0) {
+            break;
+        }
+        if (header.size < sizeof(header) || pos + header.size > size) {
+            std::cerr << "Warning: truncated record at offset " << pos << " in " << path << std::endl;
+            break;
+        }
+
+        const u8* payload = data + pos + sizeof(header);
+        const u8* end = data + pos + header.size;
+        pos += header.size;
+
+        if (header.type == static_cast<u8>(BinaryLogRecordType::SITE)) {
+            DecodedSite site;
+            u16 file_len, function_len, format_len;
+            if (payload + sizeof(u32) + 3 * sizeof(u16) > end) {
+                continue;
+            }
+            std::memcpy(&site.line, payload, sizeof(u32)); payload += sizeof(u32);
+            std::memcpy(&file_len, payload, sizeof(u16)); payload += sizeof(u16);
+            std::memcpy(&function_len, payload, sizeof(u16)); payload += sizeof(u16);
+            std::memcpy(&format_len, payload, sizeof(u16)); payload += sizeof(u16);
+            if (payload + file_len + function_len + format_len > end) {
+                continue;
+            }
+            site.level = static_cast<LogLevel>(header.level);
+            site.file.assign(reinterpret_cast<const char*>(payload), file_len); payload += file_len;
+            site.function.assign(reinterpret_cast<const char*>(payload), function_len); payload += function_len;
+            site.format.assign(reinterpret_cast<const char*>(payload), format_len);
+            sites[header.site_id] = std::move(site);
+            continue;
+        }
+
+        if (header.type != static_cast<u8>(BinaryLogRecordType::EVENT) ||
+            static_cast<LogLevel>(header.level) < min_level) {
+            continue;
+        }
+
+        auto site_it = sites.find(header.site_id);
+        if (site_it == sites.end() || !decodeArgs(payload, end, header.arg_count, args)) {
+            std::cerr << "Warning: undecodable event for site " << header.site_id << " in " << path << std::endl;
+            continue;
+        }
+
+        const DecodedSite& site = site_it->second;
+        std::string message = renderMessage(site.format, args);
+        const char* level = logLevelToString(static_cast<LogLevel>(header.level));
+
+        if (json) {
+            std::cout << "{\"time_ns\":" << header.timestamp_ns
+                      << ",\"time\":\"" << formatTime(header.timestamp_ns) << "\""
+                      << ",\"level\":\"" << level << "\""
+                      << ",\"thread\":" << header.thread_id
+                      << ",\"file\":\"" << jsonEscape(site.file) << "\""
+                      << ",\"line\":" << site.line
+                      << ",\"function\":\"" << jsonEscape(site.function) << "\""
+                      << ",\"message\":\"" << jsonEscape(message) << "\""
+                      << ",\"args\":[";
+            for (size_t i = 0; i < args.size(); ++i) {
+                if (i > 0) {
+                    std::cout << ",";
+                }
+                if (args[i].type == BinaryLogArgType::STRING) {
+                    std::cout << "\"" << jsonEscape(args[i].s) << "\"";
+                } else {
+                    std::cout << argToString(args[i]);
+                }
+            }
+            std::cout << "]}" << "\n";
+        } else {
+            std::cout << formatTime(header.timestamp_ns) << " [" << level << "] [" << header.thread_id << "] ";
+            if (!site.file.empty()) {
+                std::cout << "[" << site.file << ":" << site.line << "] ";
+            }
+            if (!site.function.empty()) {
+                std::cout << "[" << site.function << "] ";
+            }
+            std::cout << message << "\n";
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    LogLevel min_level = LogLevel::TRACE;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-j" || arg == "--json") {
+            json = true;
+        } else if (arg == "-l" || arg == "--level") {
+            if (i + 1 >= argc || !parseLevel(argv[++i], min_level)) {
+                std::cerr << "Error: Missing or invalid level" << std::endl;
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (const auto& file : files) {
+        ok = decodeSegment(file, json, min_level) && ok;
+    }
+
+    std::cout.flush();
+    return ok ? 0 : 1;
+}
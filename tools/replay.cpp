@@ -0,0 +1,135 @@
+#include "../include/network/frame_replay.h"
+#include "../include/core/service.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+
+using namespace next_gen;
+
+// Service that only reports completion of every replayed message.
+// Measures the framework path (queue, worker, dispatch); link the replayer
+// into a server binary to replay into real handlers.
+class ReplaySinkService : public BaseService {
+public:
+    ReplaySinkService() : BaseService("replay_sink"), replayer_(nullptr) {}
+
+    void setReplayer(FrameReplayer* replayer) { replayer_ = replayer; }
+
+protected:
+    Result<void> onMessage(const Message& message) override {
+        if (replayer_) {
+            replayer_->recordCompletion(message);
+        }
+        return Result<void>();
+    }
+
+private:
+    FrameReplayer* replayer_;
+};
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] <capture>" << std::endl;
+    std::cout << "Replays a frame capture (.ngcap segment or capture base path) into a service." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -s, --speed N       Replay at N times the captured rate, 0 for maximum speed (default 1)" << std::endl;
+    std::cout << "  -m, --max N         Stop after N frames" << std::endl;
+    std::cout << "  -j, --json          Output statistics as JSON" << std::endl;
+    std::cout << "  -h, --help          Display this help message" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ReplayConfig config;
+    bool json = false;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-s" || arg == "--speed") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing speed" << std::endl;
+                return 1;
+            }
+            config.speed = std::strtod(argv[++i], nullptr);
+            if (config.speed < 0.0) {
+                std::cerr << "Error: Invalid speed" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-m" || arg == "--max") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing frame count" << std::endl;
+                return 1;
+            }
+            config.max_frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-j" || arg == "--json") {
+            json = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = arg;
+        }
+    }
+
+    if (path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ReplaySinkService service;
+    FrameReplayer replayer(service, config);
+    service.setReplayer(&replayer);
+
+    // Registered types are decoded, any other frame keeps its captured body
+    replayer.setDecoder([](const FrameCaptureRecord& record) -> std::unique_ptr<Message> {
+        auto message = FrameReplayer::decodeFrame(record);
+        if (!message) {
+            message = std::make_unique<CapturedMessage>(record);
+        }
+        return message;
+    });
+
+    auto result = service.init();
+    if (!result.has_error()) {
+        result = service.start();
+    }
+    if (result.has_error()) {
+        std::cerr << "Error: " << result.error().what() << std::endl;
+        return 1;
+    }
+
+    auto stats = replayer.run(path);
+    service.stop();
+    if (stats.has_error()) {
+        std::cerr << "Error: " << stats.error().what() << std::endl;
+        return 1;
+    }
+
+    const ReplayStats& s = stats.value();
+    if (json) {
+        std::cout << "{\"frames\":" << s.frames << ",\"posted\":" << s.posted
+                  << ",\"completed\":" << s.completed << ",\"decode_errors\":" << s.decode_errors
+                  << ",\"post_errors\":" << s.post_errors << ",\"elapsed_seconds\":" << s.elapsed_seconds
+                  << ",\"throughput\":" << s.throughput << ",\"lag_p99_ns\":" << s.lag_p99_ns
+                  << ",\"lag_max_ns\":" << s.lag_max_ns << ",\"latency_p50_ns\":" << s.latency_p50_ns
+                  << ",\"latency_p99_ns\":" << s.latency_p99_ns << ",\"latency_max_ns\":" << s.latency_max_ns
+                  << "}" << std::endl;
+        return 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Frames:     " << s.frames << " (" << s.posted << " posted, " << s.completed << " completed, "
+              << s.decode_errors << " decode errors, " << s.post_errors << " post errors)" << std::endl;
+    std::cout << "Elapsed:    " << s.elapsed_seconds << " s" << std::endl;
+    std::cout << "Throughput: " << std::setprecision(0) << s.throughput << " msg/s" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "Latency:    p50 " << s.latency_p50_ns / 1e3 << " us, p99 " << s.latency_p99_ns / 1e3
+              << " us, max " << s.latency_max_ns / 1e3 << " us" << std::endl;
+    std::cout << "Pacing lag: p99 " << s.lag_p99_ns / 1e3 << " us, max " << s.lag_max_ns / 1e3 << " us" << std::endl;
+    return 0;
+}